@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "Audio.h"
+#include "AudioMixer.h"
 #include "common/system_clock.h"
 #include "common/timing.h"
 #include "i2s_audio.pio.h"
@@ -520,7 +521,7 @@ static int64 fill_buffer(alarm_id_t, void*) noexcept
 		for (uint i = 0; i < num_sources; i++)
 		{
 			uint cnt = audio_sources[i]->getAudio(ibu, count);
-			for (uint i = 0; i < cnt; i++) input_buffer[i] += ibu[i];
+			accumulate(input_buffer, ibu, cnt);
 			if (cnt < count)
 			{
 				swap(audio_sources[i--], audio_sources[--num_sources]);
@@ -0,0 +1,232 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "AudioSource.h"
+
+
+namespace kio::Audio
+{
+
+// gain for the AudioMixer: fixed point with 12 fractional bits:
+static constexpr int mixer_gain_bits = 12;
+static constexpr int unity_gain		 = 1 << mixer_gain_bits;
+static constexpr int max_gain		 = 4 * unity_gain;
+
+inline constexpr int mixer_gain(float gain) noexcept
+{
+	return minmax(-max_gain, int(gain * unity_gain), max_gain); //
+}
+
+
+/* _______________________________________________________________________________________
+   add samples to an int32 accumulator in one pass.
+   the number of channels is converted and the gain is applied on the fly,
+   so that no NumChannelsAdapter or SetVolumeAdapter with their own buffers are needed.
+   16 sources with max_gain can be added without overflow.
+*/
+template<uint zc, uint qc>
+inline void accumulate(AudioSample<zc, int>* z, const AudioSample<qc>* q, uint count, int gain = unity_gain) noexcept
+{
+	static_assert(zc == 1 || zc == 2);
+	static_assert(qc == 1 || qc == 2);
+
+	if (gain == unity_gain)
+	{
+		for (uint i = 0; i < count; i++)
+		{
+			if constexpr (zc == qc) z[i] += AudioSample<zc, int>(q[i]);
+			else if constexpr (zc == 2) z[i].l += q[i].m, z[i].r += q[i].m;
+			else z[i].m += q[i].mono();
+		}
+	}
+	else
+	{
+		for (uint i = 0; i < count; i++)
+		{
+			if constexpr (zc == 2 && qc == 2)
+			{
+				z[i].l += (q[i].l * gain) >> mixer_gain_bits;
+				z[i].r += (q[i].r * gain) >> mixer_gain_bits;
+			}
+			else if constexpr (zc == 2)
+			{
+				int m = (q[i].m * gain) >> mixer_gain_bits;
+				z[i].l += m, z[i].r += m;
+			}
+			else z[i].m += (q[i].mono() * gain) >> mixer_gain_bits;
+		}
+	}
+}
+
+// store int32 samples saturated to int16:
+template<uint nc>
+inline void store_saturated(AudioSample<nc>* z, const AudioSample<nc, int>* q, uint count) noexcept
+{
+	const int* qp = &q[0].channels[0];
+	Sample*	   zp = &z[0].channels[0];
+	for (uint i = 0; i < count * nc; i++) zp[i] = saturated(qp[i]);
+}
+
+
+/* _______________________________________________________________________________________
+   class AudioMixer mixes up to `max_sources` mono or stereo sources into one source.
+
+   The sources are read in blocks of `block_size` frames and summed into one int32 accumulator block.
+   The number of channels and the gain of each source are applied while accumulating.
+   Finally the accumulator block is stored saturated to int16.
+   Use mix() to add the sources to an own int32 accumulator, e.g. in the AudioController.
+
+   A source is removed if it returns less frames than requested.
+   addSource(), removeSource() and setGain() are not synchronized with getAudio():
+   either set up the mixer before it is added to the AudioController or use a lock.
+*/
+template<uint nc>
+class AudioMixer : public AudioSource<nc>
+{
+public:
+	static constexpr uint max_sources = 16;
+	static constexpr uint block_size  = 64;
+
+	AudioMixer() noexcept = default;
+
+	virtual uint getAudio(AudioSample<nc>* dest, uint num_frames) noexcept override
+	{
+		AudioSample<nc, int> accu[block_size];
+
+		for (uint remaining = num_frames; remaining;)
+		{
+			uint count = min(remaining, block_size);
+			memset(accu, 0, count * sizeof(*accu));
+			mix(accu, count);
+			store_saturated(dest, accu, count);
+			dest += count;
+			remaining -= count;
+		}
+		return num_frames;
+	}
+
+	virtual void setSampleRate(float new_sample_frequency) noexcept override
+	{
+		for (uint i = 0; i < num_sources; i++)
+		{
+			if (sources[i].mono) sources[i].mono->setSampleRate(new_sample_frequency);
+			else sources[i].stereo->setSampleRate(new_sample_frequency);
+		}
+	}
+
+	// add all sources to accu[]. count <= block_size.
+	void mix(AudioSample<nc, int>* accu, uint count) noexcept
+	{
+		assert(count <= block_size);
+		StereoSample bu[block_size]; // also used for mono samples
+
+		for (uint i = 0; i < num_sources; i++)
+		{
+			Input& source = sources[i];
+			uint   cnt;
+			if (source.mono)
+			{
+				MonoSample* q = reinterpret_cast<MonoSample*>(bu);
+				cnt			  = source.mono->getAudio(q, count);
+				accumulate(accu, q, cnt, source.gain);
+			}
+			else
+			{
+				cnt = source.stereo->getAudio(bu, count);
+				accumulate(accu, bu, cnt, source.gain);
+			}
+
+			if unlikely (cnt < count) // source finished
+			{
+				std::swap(sources[i--], sources[--num_sources]);
+				sources[num_sources] = Input();
+			}
+		}
+	}
+
+	// add source. returns false if the mixer is full.
+	bool addSource(RCPtr<MonoSource> source, float gain = 1.0f) noexcept
+	{
+		if (!source || num_sources >= max_sources) return false;
+		sources[num_sources++] = Input {std::move(source), nullptr, mixer_gain(gain)};
+		return true;
+	}
+
+	bool addSource(RCPtr<StereoSource> source, float gain = 1.0f) noexcept
+	{
+		if (!source || num_sources >= max_sources) return false;
+		sources[num_sources++] = Input {nullptr, std::move(source), mixer_gain(gain)};
+		return true;
+	}
+
+	void removeSource(const RCObject* source) noexcept
+	{
+		if (Input* input = find(source))
+		{
+			std::swap(*input, sources[--num_sources]);
+			sources[num_sources] = Input();
+		}
+	}
+
+	void setGain(const RCObject* source, float gain) noexcept
+	{
+		if (Input* input = find(source)) input->gain = mixer_gain(gain);
+	}
+
+	uint numSources() const noexcept { return num_sources; }
+
+private:
+	struct Input
+	{
+		RCPtr<MonoSource>	mono;
+		RCPtr<StereoSource> stereo;
+		int					gain = unity_gain;
+	};
+
+	Input sources[max_sources];
+	uint  num_sources = 0;
+
+	Input* find(const RCObject* source) noexcept
+	{
+		for (uint i = 0; i < num_sources; i++)
+		{
+			if (sources[i].mono.ptr() == source || sources[i].stereo.ptr() == source) return &sources[i];
+		}
+		return nullptr;
+	}
+};
+
+} // namespace kio::Audio
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
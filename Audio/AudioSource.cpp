@@ -18,6 +18,74 @@ const uint16 quarter_sine[nelem_quarter_sine + 1] = {
 };
 
 
+// coefficient tables for the PolyphaseSampleRateAdapter:
+// for phase p the output sample is interpolated at position t = p / resampler_phases
+// between the samples at taps[taps/2-1] and taps[taps/2].
+// the coefficients of each phase are normalized to a sum of exactly 1.0 to avoid DC ripple.
+// the tables are calculated at compile time and go into flash.
+// <cmath> is not constexpr, so sin() and cos() are calculated with their taylor series.
+
+static constexpr double pi = 3.14159265358979323846;
+
+static constexpr double cx_fabs(double x) { return x < 0 ? -x : x; }
+
+static constexpr double cx_sin(double x)
+{
+	// reduce x to -pi .. +pi
+	// then sum up the taylor series until it no longer changes:
+
+	double n = double(int64(x / (2 * pi) + (x < 0 ? -0.5 : 0.5)));
+	x -= n * 2 * pi;
+
+	double sum = x, term = x;
+	for (int i = 2; sum + term != sum; i += 2)
+	{
+		term *= -x * x / (i * (i + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+static constexpr double cx_cos(double x) { return cx_sin(x + pi / 2); }
+
+static constexpr int cx_lround(double x) { return x < 0 ? -int(0.5 - x) : int(x + 0.5); }
+
+static constexpr double cubic_kernel(double x) // Catmull-Rom
+{
+	x = cx_fabs(x);
+	if (x <= 1) return (1.5 * x - 2.5) * x * x + 1;
+	if (x < 2) return ((-0.5 * x + 2.5) * x - 4) * x + 2;
+	return 0;
+}
+
+static constexpr double sinc_kernel(double x) // sinc with Blackman window, width = 8
+{
+	if (cx_fabs(x) >= 4) return 0;
+	double sinc = x == 0 ? 1 : cx_sin(pi * x) / (pi * x);
+	return sinc * (0.42 + 0.5 * cx_cos(pi * x / 4) + 0.08 * cx_cos(pi * x / 2));
+}
+
+template<uint taps>
+static constexpr ResamplerCoeffs<taps> calc_coeffs(double (*kernel)(double))
+{
+	ResamplerCoeffs<taps> coeffs {};
+
+	for (int p = 0; p < resampler_phases; p++)
+	{
+		double c[taps] {}, sum = 0;
+		for (uint k = 0; k < taps; k++) sum += c[k] = kernel(int(k) - int(taps / 2 - 1) - double(p) / resampler_phases);
+
+		int isum = 0;
+		for (uint k = 0; k < taps; k++) isum += coeffs[p][k] = int16(cx_lround(c[k] / sum * (1 << resampler_coeff_bits)));
+		coeffs[p][taps / 2 - 1 + (p >= resampler_phases / 2)] += (1 << resampler_coeff_bits) - isum;
+	}
+	return coeffs;
+}
+
+constexpr ResamplerCoeffs<4> resampler_coeffs4 = calc_coeffs<4>(cubic_kernel);
+constexpr ResamplerCoeffs<8> resampler_coeffs8 = calc_coeffs<8>(sinc_kernel);
+
+
 } // namespace kio::Audio
 
 /*
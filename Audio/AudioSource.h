@@ -243,6 +243,174 @@ SampleRateAdapter(RCPtr<AudioSource<1>>, float)->SampleRateAdapter<1>;
 SampleRateAdapter(RCPtr<AudioSource<2>>, float)->SampleRateAdapter<2>;
 
 
+// saturate int32 sample to int16:
+inline constexpr Sample saturated(int sample) noexcept
+{
+	return sample == Sample(sample) ? Sample(sample) : sample < 0 ? -0x8000 : 0x7fff;
+}
+
+
+/* _______________________________________________________________________________________
+   resample source to target sample rate with fixed point maths:
+   polyphase filter with precomputed coefficient tables:
+	 LinearInterpolation: 2 taps, same as SampleRateAdapter but without float maths
+	 CubicInterpolation:  4 taps, Catmull-Rom spline
+	 SincInterpolation:   8 taps, windowed sinc (Blackman window)
+   The source is read in blocks into the adapter's buffer.
+   Note: the sinc filter has a fixed cutoff at the source's nyquist frequency:
+   if the source is downsampled then frequencies above the target's nyquist frequency still alias.
+*/
+enum ResamplerQuality : uint8 { LinearInterpolation = 2, CubicInterpolation = 4, SincInterpolation = 8 };
+
+constexpr int resampler_phase_bits = 7;
+constexpr int resampler_phases	   = 1 << resampler_phase_bits;
+constexpr int resampler_coeff_bits = 14; // 1.0 = 1<<14
+
+template<uint taps>
+struct ResamplerCoeffs
+{
+	int16 coeffs[resampler_phases][taps];
+
+	constexpr int16*	   operator[](int phase) noexcept { return coeffs[phase]; }
+	constexpr const int16* operator[](int phase) const noexcept { return coeffs[phase]; }
+};
+
+extern const ResamplerCoeffs<4> resampler_coeffs4; // in flash
+extern const ResamplerCoeffs<8> resampler_coeffs8; // in flash
+
+template<uint nc>
+class PolyphaseSampleRateAdapter : public AudioSource<nc>
+{
+	static constexpr uint max_taps	 = 8;
+	static constexpr uint block_size = 64;
+
+	RCPtr<AudioSource<nc>> audio_source;
+	float				   source_frequency;
+	float				   dest_frequency;
+
+	uint32		 step_int;	// source samples per dest sample: integer part
+	uint32		 step_frac; // source samples per dest sample: fractional part * 2^32
+	uint32		 frac = 0;	// position between buffer[qi] and buffer[qi+1] * 2^32
+	uint		 taps;
+	const int16* coeffs; // [resampler_phases][taps]
+	uint		 qi = 0; // index of first tap in buffer[]
+	uint		 qcnt;	 // samples in buffer[]
+
+	AudioSample<nc> buffer[max_taps + block_size];
+
+public:
+	PolyphaseSampleRateAdapter(
+		RCPtr<AudioSource<nc>> source, float source_freq, float dest_freq = hw_sample_frequency,
+		ResamplerQuality quality = CubicInterpolation) noexcept :
+		audio_source(std::move(source)),
+		source_frequency(source_freq),
+		dest_frequency(dest_freq)
+	{
+		calc_step();
+		setQuality(quality);
+	}
+
+	virtual void setSampleRate(float new_sample_frequency) noexcept override
+	{
+		dest_frequency = new_sample_frequency;
+		calc_step();
+	}
+
+	void setSourceSampleRate(float new_source_frequency) noexcept
+	{
+		source_frequency = new_source_frequency;
+		calc_step();
+	}
+
+	void setQuality(ResamplerQuality quality) noexcept
+	{
+		// the first output sample is the first source sample:
+		// the buffer is primed with taps/2-1 samples of silence.
+
+		taps   = quality;
+		coeffs = quality == SincInterpolation ? resampler_coeffs8[0] :
+				 quality == CubicInterpolation ? resampler_coeffs4[0] :
+												 nullptr;
+		qi	   = 0;
+		frac   = 0;
+		qcnt   = taps / 2 - 1;
+		memset(buffer, 0, qcnt * sizeof(*buffer));
+	}
+
+	virtual uint getAudio(AudioSample<nc>* dest, uint num_frames) noexcept override
+	{
+		for (uint zi = 0; zi < num_frames; zi++)
+		{
+			if unlikely (qi + taps > qcnt && !refill()) return zi;
+
+			const AudioSample<nc>* q = buffer + qi;
+			for (uint ch = 0; ch < nc; ch++)
+			{
+				int sample;
+				if (taps == 2)
+				{
+					int f  = int(frac >> 18); // 14 bit
+					sample = q[0].channels[ch] + (((q[1].channels[ch] - q[0].channels[ch]) * f + (1 << 13)) >> 14);
+				}
+				else
+				{
+					const int16* c = coeffs + (frac >> (32 - resampler_phase_bits)) * taps;
+					int			 s = 0;
+					for (uint k = 0; k < taps; k++) s += q[k].channels[ch] * c[k];
+					sample = saturated((s + (1 << (resampler_coeff_bits - 1))) >> resampler_coeff_bits);
+				}
+				dest[zi].channels[ch] = Sample(sample);
+			}
+
+			uint32 f = frac + step_frac;
+			qi += step_int + (f < frac); // + carry
+			frac = f;
+		}
+		return num_frames;
+	}
+
+private:
+	void calc_step() noexcept
+	{
+		// note: the step must be precise, else the pitch is wrong and the SNR suffers.
+		// this is only calculated when a frequency changes, so double is ok.
+
+		double step = double(source_frequency) / double(dest_frequency);
+		step_int	= uint32(step);
+		step_frac	= uint32((step - step_int) * 0x1p32);
+	}
+
+	bool refill() noexcept
+	{
+		// move the remaining samples to the start of buffer[] and read the next block from the source.
+		// if samples were skipped (downsampling) then discard them.
+
+		while (qi + taps > qcnt)
+		{
+			if (qi >= qcnt) qi -= qcnt, qcnt = 0;
+			else
+			{
+				qcnt -= qi;
+				memmove(buffer, buffer + qi, qcnt * sizeof(*buffer));
+				qi = 0;
+			}
+
+			uint cnt = audio_source->getAudio(buffer + qcnt, NELEM(buffer) - qcnt);
+			if (cnt == 0) return false;
+			qcnt += cnt;
+		}
+		return true;
+	}
+};
+
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<1>>, float, float, ResamplerQuality)->PolyphaseSampleRateAdapter<1>;
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<2>>, float, float, ResamplerQuality)->PolyphaseSampleRateAdapter<2>;
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<1>>, float, float)->PolyphaseSampleRateAdapter<1>;
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<2>>, float, float)->PolyphaseSampleRateAdapter<2>;
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<1>>, float)->PolyphaseSampleRateAdapter<1>;
+PolyphaseSampleRateAdapter(RCPtr<AudioSource<2>>, float)->PolyphaseSampleRateAdapter<2>;
+
+
 /* _______________________________________________________________________________________
    dummy source which provides silence:
 */
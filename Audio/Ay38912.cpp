@@ -35,6 +35,20 @@ inline int Ay38912<nc>::output_of(Channel& ch) noexcept
 	return log_vol[ch.volume < 0x10 ? ch.volume : envelope.index];
 }
 
+template<uint nc>
+inline int Ay38912<nc>::integral_of(Channel& ch, CCx end) noexcept
+{
+	// output of a fast channel integrated over range [ccx_now,end).
+	// the volume and the noise are constant in this range.
+
+	int duration = end - ccx_now;
+	int high	 = ch.highTime(ccx_now, end);
+	int lo		 = log_vol[0];
+	if (ch.noise_enable && !(noise.shiftreg & 1)) return lo * duration;
+	int hi = log_vol[ch.volume < 0x10 ? ch.volume : envelope.index];
+	return lo * duration + (hi - lo) * high;
+}
+
 template<uint nc>
 void Ay38912<nc>::Channel::setVolume(uint8 n)
 {
@@ -77,6 +91,27 @@ void Ay38912<nc>::Channel::fastForward(CCx now)
 	if (periods & 1) sound_in = !sound_in;
 }
 
+template<uint nc>
+inline int Ay38912<nc>::Channel::highTime(CCx now, CCx end)
+{
+	// for channels which toggle more than once per sample:
+	// return the time in range [now,end) where sound_in is high
+	// and advance the channel to `end` just like fastForward().
+
+	assert(when >= now);
+	int duration = end - now;
+	if (when >= end) return sound_in ? duration : 0;
+
+	int toggles = (end - when + reload - 1) / reload; // toggles in range [when,end)
+	int first	= when - now;
+	int last	= end - (when + (toggles - 1) * reload);
+	int high	= sound_in ? first + (toggles - 1) / 2 * reload : toggles / 2 * reload;
+
+	when += toggles * reload;
+	if (toggles & 1) sound_in = !sound_in;
+	return sound_in ? high + last : high;
+}
+
 template<uint nc>
 void Ay38912<nc>::Channel::reset(CCx now)
 {
@@ -455,6 +490,42 @@ uint Ay38912<nc>::getAudio(AudioSample<nc>* buffer, uint num_samples) noexcept
 	return num_samples;
 }
 
+template<uint nc>
+inline AudioSample<nc, int> Ay38912<nc>::mixed(int a, int b, int c) const noexcept
+{
+	if constexpr (nc == 2)
+	{
+		switch (int(stereo_mix))
+		{
+		default:
+		case Mono: // mono: ZX 128k, +2, +3, +3A, TS2068, TC2068
+			return a + b + c;
+		case ABCstereo: // western Europe
+			return AudioSample<nc, int>(2 * a + b, b + 2 * c);
+		case ACBstereo: // eastern Europe, Didaktik Melodik
+			return AudioSample<nc, int>(2 * a + c, c + 2 * b);
+		}
+	}
+	else
+	{
+		return a + b + c; // mono
+	}
+}
+
+template<uint nc>
+inline uint Ay38912<nc>::fast_channels() const noexcept
+{
+	// get the audible channels with a period shorter than one sample.
+	// reload is the half period.
+
+	if (!batch_fast_tones) return 0;
+	uint fast = 0;
+	if (ay_reg[8] && ~ay_reg[7] & 1 && 2 * channel_A.reload < ccx_per_sample) fast |= 1;
+	if (ay_reg[9] && ~ay_reg[7] & 2 && 2 * channel_B.reload < ccx_per_sample) fast |= 2;
+	if (ay_reg[10] && ~ay_reg[7] & 4 && 2 * channel_C.reload < ccx_per_sample) fast |= 4;
+	return fast;
+}
+
 template<uint nc>
 void Ay38912<nc>::run_up_to_cycle(const CCx ccx_end) noexcept
 {
@@ -465,6 +536,8 @@ void Ay38912<nc>::run_up_to_cycle(const CCx ccx_end) noexcept
 	assert(ccx_now >= ccx_at_sos);
 	assert(ccx_at_sos < ccx_now + ccx_per_sample);
 
+	if (uint fast = fast_channels()) return run_batched_up_to_cycle(ccx_end, fast);
+
 	while (true)
 	{
 		// who is next ?
@@ -500,32 +573,7 @@ void Ay38912<nc>::run_up_to_cycle(const CCx ccx_end) noexcept
 		if (ccx_when > ccx_now)
 		{
 			// update current output value:
-			int a = output_of(channel_A);
-			int b = output_of(channel_B);
-			int c = output_of(channel_C);
-
-			if constexpr (nc == 2)
-			{
-				switch (int(stereo_mix))
-				{
-				default:
-				case Mono: // mono: ZX 128k, +2, +3, +3A, TS2068, TC2068
-					current_value = a + b + c;
-					break;
-				case ABCstereo: // western Europe
-					current_value.channels[0] = 2 * a + b;
-					current_value.channels[1] = b + 2 * c;
-					break;
-				case ACBstereo: // eastern Europe, Didaktik Melodik
-					current_value.channels[0] = 2 * a + c;
-					current_value.channels[1] = c + 2 * b;
-					break;
-				}
-			}
-			else
-			{
-				current_value = a + b + c; // mono
-			}
+			current_value = mixed(output_of(channel_A), output_of(channel_B), output_of(channel_C));
 
 			// emit samples
 			if (ccx_when < ccx_at_sos + ccx_per_sample)
@@ -563,6 +611,82 @@ void Ay38912<nc>::run_up_to_cycle(const CCx ccx_end) noexcept
 }
 
 
+template<uint nc>
+void Ay38912<nc>::run_batched_up_to_cycle(const CCx ccx_end, const uint fast) noexcept
+{
+	// variant of run_up_to_cycle() for channels which toggle more than twice per sample:
+	// the fast channels are no events but are integrated analytically up to the next event.
+	// the end of each sample is an event too, so the number of iterations per sample
+	// no longer depends on the pitch of the fast channels.
+
+	while (true)
+	{
+		// who is next ?
+		int who			   = 0; // end of sample or finish
+		CCx ccx_sample_end = ccx_at_sos + ccx_per_sample;
+		CCx ccx_when	   = ccx_sample_end < ccx_end ? ccx_sample_end : ccx_end;
+
+		if (noise.when < ccx_when)
+		{
+			if (~ay_reg[7] & 0x38) { who = 1, ccx_when = noise.when; }
+			else noise.fastForward(ccx_end);
+		}
+		if (~fast & 1 && channel_A.when < ccx_when)
+		{
+			if (ay_reg[8] && ~ay_reg[7] & 1) { who = 3, ccx_when = channel_A.when; }
+			else channel_A.fastForward(ccx_end);
+		}
+		if (~fast & 2 && channel_B.when < ccx_when)
+		{
+			if (ay_reg[9] && ~ay_reg[7] & 2) { who = 4, ccx_when = channel_B.when; }
+			else channel_B.fastForward(ccx_end);
+		}
+		if (~fast & 4 && channel_C.when < ccx_when)
+		{
+			if (ay_reg[10] && ~ay_reg[7] & 4) { who = 5, ccx_when = channel_C.when; }
+			else channel_C.fastForward(ccx_end);
+		}
+		if (envelope.when < ccx_when)
+		{
+			if ((channel_A.volume | channel_B.volume | channel_C.volume) & 0x10) { who = 2, ccx_when = envelope.when; }
+			else envelope.fastForward(ccx_end);
+		}
+
+		if (ccx_when > ccx_now)
+		{
+			// accumulate output up to ccx_when:
+			int duration = ccx_when - ccx_now;
+			int a		 = fast & 1 ? integral_of(channel_A, ccx_when) : output_of(channel_A) * duration;
+			int b		 = fast & 2 ? integral_of(channel_B, ccx_when) : output_of(channel_B) * duration;
+			int c		 = fast & 4 ? integral_of(channel_C, ccx_when) : output_of(channel_C) * duration;
+			current_sample += mixed(a, b, c);
+			ccx_now = ccx_when;
+
+			// emit sample
+			if (ccx_now == ccx_sample_end)
+			{
+				*output_buffer++ = current_sample >> 16;
+				ccx_at_sos		 = ccx_now;
+				current_sample	 = 0;
+			}
+		}
+
+		// handle next:
+		switch (who)
+		{
+		case 1: noise.trigger(); break;
+		case 2: envelope.trigger(); break;
+		case 3: channel_A.trigger(); break;
+		case 4: channel_B.trigger(); break;
+		case 5: channel_C.trigger(); break;
+		default:
+			if (ccx_now == ccx_end) return;
+			break; // end of sample
+		}
+	}
+}
+
+
 // instantiate both.
 // the linker will know what we need:
 
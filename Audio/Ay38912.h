@@ -148,6 +148,7 @@ protected:
 		void trigger();
 		void reset(CCx now);
 		void fastForward(CCx now);
+		int	 highTime(CCx now, CCx end);
 	};
 
 	Channel	 channel_A, channel_B, channel_C;
@@ -169,8 +170,17 @@ protected:
 	CCx ccx_at_sos {0}; // cc at start of sample
 	CCx ccx_now {0};	// current cc
 
+	// channels with a period shorter than a sample are integrated per sample.
+	// this can be disabled for comparison with the plain event loop.
+	bool batch_fast_tones = true;
+
 	int	 output_of(Channel&) noexcept;
+	int	 integral_of(Channel&, CCx end) noexcept;
+	uint fast_channels() const noexcept;
 	void run_up_to_cycle(CCx ccx) noexcept;
+	void run_batched_up_to_cycle(CCx ccx, uint fast) noexcept;
+
+	AudioSample<num_channels, int> mixed(int a, int b, int c) const noexcept;
 };
 
 
@@ -325,7 +335,7 @@ uint Ay38912_player<NCH, QSZ>::getAudio(AudioSample<NCH>* buffer, uint num_frame
 
 				super::current_sample = 0;
 				super::ccx_at_sos	  = super::ccx_now;
-				ccx_buffer_end = super::ccx_now + (output_buffer_end - super::output_buffer) * super::ccx_per_sample;
+				ccx_buffer_end = super::ccx_now + int(output_buffer_end - super::output_buffer) * super::ccx_per_sample;
 			}
 			else super::setRegisters(qdata.registers);
 
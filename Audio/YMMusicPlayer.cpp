@@ -111,7 +111,7 @@ uint8 YMMusicPlayer::BackrefBuffer::next_value(BitStream& instream)
 
 
 // size is close to 600 bytes plus 3 memory Ids:
-static_assert(sizeof(YMMusicPlayer) <= 608);
+static_assert(sizeof(YMMusicPlayer) <= 612);
 
 
 YMMusicPlayer::YMMusicPlayer() : super(2000000, Mono, 50, 0.2f) {}
@@ -132,6 +132,35 @@ void YMMusicPlayer::read_frame(uint8 regs[16])
 	if (regs[13] == 0x0f) regs[13] = 0xff;
 }
 
+void YMMusicPlayer::restore_snapshot()
+{
+	// restore the decoder state at the loop frame from the snapshot behind the bitstream:
+	// the bit position, the state of all BackrefBuffers and the contents of the allocated_buffer.
+	// this replaces decoding all frames of the intro again.
+
+	Devices::BufferedFile* file = bitstream.infile;
+	file->setFpos(bitstream_start + snapshot_offset);
+
+	uint32 bitpos = file->read_LE<uint32>();
+	for (BackrefBuffer& buffer : backref_buffers)
+	{
+		buffer.index		 = file->read_LE<uint16>();
+		buffer.regvalue		 = file->read<uint8>();
+		buffer.regcount		 = file->read<uint8>();
+		buffer.backrefoffset = file->read_LE<uint16>();
+		buffer.backrefcount	 = file->read_LE<uint16>();
+	}
+	file->read(allocated_buffer, sizeof(RleCode) << buffer_bits);
+
+	file->setFpos(bitstream_start + bitpos / 8);
+	bitstream.reset();
+	if (uint n = bitpos & 7)
+	{
+		bitstream.bits = 8 - n;
+		bitstream.accu = file->read<uint8>() & ((1u << bitstream.bits) - 1);
+	}
+}
+
 int YMMusicPlayer::run() noexcept
 {
 	trace("YMMusicPlayer::run");
@@ -157,10 +186,14 @@ int YMMusicPlayer::run() noexcept
 
 			if (repeat_file && next_file == nullptr && next_dir == nullptr)
 			{
-				bitstream.infile->setFpos(bitstream_start);
-				bitstream.reset();
-				uint8 dummy[16];
-				for (uint frame = 0; frame < loop_frame; frame++) { read_frame(dummy); }
+				if (snapshot_offset) restore_snapshot();
+				else // variant 2: decode the intro again
+				{
+					bitstream.infile->setFpos(bitstream_start);
+					bitstream.reset();
+					uint8 dummy[16];
+					for (uint frame = 0; frame < loop_frame; frame++) { read_frame(dummy); }
+				}
 				frames_played = loop_frame;
 			}
 			else
@@ -191,7 +224,7 @@ int YMMusicPlayer::run() noexcept
 			AyStereoMix stereo_mix = Mono; //TODO
 
 			if (memcmp(&magic, "ymm!", 4)) throw "not a .ymm music file";
-			if (variant != 2) throw "unknown .ymm variant";
+			if (variant != 2 && variant != 3) throw "unknown .ymm variant";
 			if (buffer_bits < 8 || buffer_bits > 14) throw "illegal window bits";
 			if (frame_rate < 25 || frame_rate > 100) throw "illegal frame rate";
 			if (registers_per_frame != 16) throw "illegal registers per frame";
@@ -206,6 +239,7 @@ int YMMusicPlayer::run() noexcept
 			logline("comment: %s", comment);
 
 			uint32 rbusz	= ymmusic_file->read_LE<uint32>();
+			snapshot_offset = variant >= 3 ? ymmusic_file->read_LE<uint32>() : 0;
 			bitstream_start = ymmusic_file->getFpos();
 
 			if (this->buffer_bits != buffer_bits)
@@ -240,7 +274,7 @@ int YMMusicPlayer::run() noexcept
 
 			// start playing by sending the setup command:
 			frames_played	 = 0;
-			bitstream.infile = ymmusic_file;
+			bitstream.infile = new Devices::BufferedFile(ymmusic_file);
 			bitstream.reset();
 
 			super::reset(ay_clock, stereo_mix, frame_rate);
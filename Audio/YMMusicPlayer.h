@@ -5,6 +5,7 @@
 #pragma once
 #include "Audio.h"
 #include "Ay38912.h"
+#include "Devices/BufferedFile.h"
 #include "Devices/devices_types.h"
 #include "basic_math.h"
 
@@ -54,6 +55,7 @@ public:
 	uint32 num_frames;
 	uint32 loop_frame;
 	uint32 bitstream_start;
+	uint32 snapshot_offset = 0; // decoder state at loop_frame, relative to bitstream_start. 0 = none
 
 	int32  cc_per_frame;	  // calc. from ay_clock and frame_rate
 	CC	   cc_next {0};		  // cc for next register update
@@ -62,9 +64,9 @@ public:
 	// decoder data:
 	struct BitStream
 	{
-		FilePtr infile;	  // the currently playing file
-		uint	accu = 0; // accumulator
-		uint	bits = 0; // remaining num bits in accu
+		Devices::BufferedFilePtr infile;   // the currently playing file
+		uint					 accu = 0; // accumulator
+		uint					 bits = 0; // remaining num bits in accu
 
 		uint read_bits(uint nbits);
 		uint read_number();
@@ -98,6 +100,7 @@ public:
 
 private:
 	void read_frame(uint8 regs[16]);
+	void restore_snapshot();
 };
 
 
@@ -0,0 +1,160 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "BufferedFile.h"
+#include "basic_math.h"
+
+
+namespace kio::Devices
+{
+
+BufferedFile::BufferedFile(FilePtr file, uint bufsize) : //
+	File(Flags::readable),
+	file(file),
+	bufsize(bufsize)
+{
+	assert(file != nullptr);
+	assert(bufsize != 0);
+
+	bufpos = file->getFpos();
+	fsize  = file->getSize();
+	buffer = new uint8[bufsize];
+}
+
+BufferedFile::~BufferedFile() noexcept
+{
+	// does not actively close the target file.
+	// if close() wasn't called then the target file will be closed in it's d'tor too.
+
+	delete[] buffer;
+}
+
+void BufferedFile::close()
+{
+	if (file) file->close();
+	file = nullptr;
+	rpos = rend = 0;
+}
+
+bool BufferedFile::fill_buffer()
+{
+	// read the next chunk from the file.
+	// the file's fpos is always at the end of the buffered data.
+	// returns false at end of file.
+
+	assert(rpos == rend);
+
+	bufpos += rend;
+	rpos = rend = 0;
+	if (bufpos >= fsize) return false;
+
+	rend = uint(min(ADDR(bufsize), fsize - bufpos));
+	file->read(buffer, rend);
+	return true;
+}
+
+SIZE BufferedFile::read(void* _data, SIZE size, bool partial)
+{
+	if unlikely (size > fsize - getFpos())
+	{
+		size = fsize - getFpos();
+		if (!partial) throw END_OF_FILE;
+		if (eof_pending()) throw END_OF_FILE;
+		if (size == 0) set_eof_pending();
+	}
+
+	uint8* data = reinterpret_cast<uint8*>(_data);
+	SIZE   rem	= size;
+
+	// from the buffer:
+	uint cnt = min(rem, rend - rpos);
+	memcpy(data, buffer + rpos, cnt);
+	rpos += cnt;
+	data += cnt;
+	rem -= cnt;
+
+	// large blocks directly from the file:
+	if (rem >= bufsize)
+	{
+		bufpos += rend;
+		rpos = rend = 0;
+		file->read(data, rem);
+		bufpos += rem;
+		return size;
+	}
+
+	// remainder via the buffer:
+	if (rem)
+	{
+		fill_buffer();
+		memcpy(data, buffer, rem);
+		rpos = rem;
+	}
+	return size;
+}
+
+int BufferedFile::getc(uint __unused timeout_us)
+{
+	if (rpos < rend || fill_buffer()) return buffer[rpos++];
+	if (eof_pending()) throw END_OF_FILE;
+	set_eof_pending();
+	return -1;
+}
+
+void BufferedFile::setFpos(ADDR fpos)
+{
+	// if the new fpos is inside the buffer then only adjust rpos,
+	// else discard the buffer and seek in the file.
+
+	clear_eof_pending();
+	fpos = min(fpos, fsize);
+
+	if (fpos >= bufpos && fpos <= bufpos + rend)
+	{
+		rpos = uint(fpos - bufpos);
+		return;
+	}
+
+	file->setFpos(fpos);
+	bufpos = fpos;
+	rpos = rend = 0;
+}
+
+} // namespace kio::Devices
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,131 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "File.h"
+#include <string.h>
+
+
+namespace kio::Devices
+{
+
+/*	_____________________________________________________________________________________
+	class BufferedFile is a read-only wrapper around another File.
+	It reads the data in large chunks into a buffer and provides an inline fast path
+	for the byte-oriented decoders: peek(), getc(), read<T>() and read_LE<T>()
+	only call the wrapped file if the buffer is empty.
+	Because the class is final these functions are not virtual if called on a BufferedFile.
+	The wrapped file is read ahead: its fpos is not the fpos of the BufferedFile.
+*/
+class BufferedFile final : public File
+{
+	NO_COPY_MOVE(BufferedFile);
+
+public:
+	BufferedFile(FilePtr file, uint bufsize = 512);
+	virtual ~BufferedFile() noexcept override;
+
+	virtual SIZE read(void* data, SIZE, bool partial = false) override;
+	virtual int	 getc(uint timeout_us) override;
+	virtual ADDR getSize() const noexcept override { return fsize; }
+	virtual ADDR getFpos() const noexcept override { return bufpos + rpos; }
+	virtual void setFpos(ADDR) override;
+	virtual void close() override;
+
+	virtual char getc() override
+	{
+		if unlikely (rpos == rend && !fill_buffer()) throw END_OF_FILE;
+		return char(buffer[rpos++]);
+	}
+
+	// get next byte without advancing the fpos. returns -1 at end of file.
+	int peek()
+	{
+		if unlikely (rpos == rend && !fill_buffer()) return -1;
+		return buffer[rpos];
+	}
+
+	template<typename T>
+	T read()
+	{
+		T n;
+		if likely (rend - rpos >= sizeof(T))
+		{
+			memcpy(&n, buffer + rpos, sizeof(T));
+			rpos += sizeof(T);
+		}
+		else read(&n, sizeof(T));
+		return n;
+	}
+
+	template<typename T>
+	void read(T& n)
+	{
+		n = read<T>();
+	}
+
+	template<typename T>
+	T read_LE()
+	{
+		return reverted<T, 1>(read<T>());
+	}
+
+	template<typename T>
+	T read_BE()
+	{
+		return reverted<T, 0>(read<T>());
+	}
+
+	FilePtr file;
+
+private:
+	uint8* buffer;
+	uint   bufsize;
+	uint   rpos	  = 0; // read position in buffer[]
+	uint   rend	  = 0; // end of data in buffer[]
+	ADDR   bufpos = 0; // fpos of buffer[0] in file
+	ADDR   fsize  = 0; // file size
+
+	bool fill_buffer();
+};
+
+using BufferedFilePtr = RCPtr<BufferedFile>;
+
+} // namespace kio::Devices
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -28,6 +28,20 @@ uint32 File::ioctl(IoCtl cmd, void*, void*)
 	}
 }
 
+const void* File::mmap() noexcept
+{
+	const void* data = nullptr;
+	try
+	{
+		ioctl(IoCtl::CTRL_MMAP, &data);
+	}
+	catch (...)
+	{
+		data = nullptr;
+	}
+	return data;
+}
+
 int File::getc(__unused uint timeout_us)
 {
 	SIZE count = read(&last_char, 1, true);
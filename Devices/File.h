@@ -56,6 +56,10 @@ public:
 
 	bool is_eof() const noexcept { return getFpos() >= getSize(); }
 
+	// get pointer to the file data if the file is in memory, e.g. an uncompressed resource file in flash.
+	// the size of the data is getSize(). returns nullptr if the file can't be memory-mapped.
+	const void* mmap() noexcept;
+
 protected:
 	bool eof_pending() const noexcept { return flags & EOF_PENDING; }
 	void set_eof_pending() noexcept { flags = flags | EOF_PENDING; }
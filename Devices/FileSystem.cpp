@@ -10,6 +10,7 @@
 #include "RsrcFS.h"
 #include "SDCard.h"
 #include "Trace.h"
+#include "WearLevelingDevice.h"
 #include "cdefs.h"
 #include "cstrings.h"
 #include "ff15/source/ffconf.h"
@@ -31,6 +32,17 @@ static FileSystemPtr cwd;
 
 // ====================================================
 
+#if defined FLASH_BLOCKDEVICE && FLASH_BLOCKDEVICE
+static BlockDevicePtr new_flash_device(uint32 size) throws
+{
+  #if defined FLASH_WEAR_LEVELING && FLASH_WEAR_LEVELING
+	return new WearLevelingDevice(new QspiFlashDevice<9>(size));
+  #else
+	return new QspiFlashDevice<9>(size);
+  #endif
+}
+#endif
+
 static int index_of(cstr name) noexcept
 {
 	for (int i = 0; i < FF_VOLUMES; i++)
@@ -81,7 +93,7 @@ void makeFS(cstr devicename, cstr type) throws
 #if defined FLASH_BLOCKDEVICE && FLASH_BLOCKDEVICE
 	if (lceq(devicename, "flash"))
 	{
-		makeFS(new QspiFlashDevice<9>(FLASH_BLOCKDEVICE), type);
+		makeFS(new_flash_device(FLASH_BLOCKDEVICE), type);
 		if constexpr (prefs_size) Preferences().write(tag_flashdisk_size, uint32(FLASH_BLOCKDEVICE));
 		return;
 	}
@@ -151,7 +163,7 @@ FileSystemPtr mount(cstr name) throws
 	{
 		uint32 size = FLASH_BLOCKDEVICE;
 		if constexpr (prefs_size) size = Preferences().read<uint32>(tag_flashdisk_size, size);
-		return new FatFS(name, new QspiFlashDevice<9>(size));
+		return new FatFS(name, new_flash_device(size));
 	}
 #endif
 	throw UNKNOWN_DEVICE;
@@ -37,14 +37,14 @@ bool isHeatShrinkEncoded(File* file)
 	if (file == nullptr) return false;
 	ADDR fpos  = file->getFpos();
 	ADDR fsize = file->getSize();
-	if (fpos + 12 < fsize) return false;
+	if (fpos + 12 > fsize) return false;
 	uint32 magic = file->read_LE<uint32>();
 	uint32 usize = file->read_LE<uint32>();
 	uint32 csize = file->read_LE<uint32>();
 	file->setFpos(fpos);
 	(void)usize;
 	if ((csize >> 24) == 0) return false;
-	if (fpos + 12 + csize > fsize) return false;
+	if (fpos + 12 + (csize & 0x00ffffff) > fsize) return false;
 	if (magic != HeatShrinkDecoder::magic) return false;
 	return true;
 }
@@ -73,16 +73,31 @@ HeatShrinkDecoder::HeatShrinkDecoder(FilePtr file, uint32 usize, uint32 csize) :
 
 void HeatShrinkDecoder::init()
 {
-	uint8 wbits = csize >> 28;
-	uint8 lbits = (csize >> 24) & 0x0f;
-	csize		= csize & 0x00ffffff;
+	uint8 wbits			 = csize >> 28;
+	uint8 lbits			 = (csize >> 24) & 0x0f;
+	bool  has_checkpoints = usize & 0x40000000;
+	csize				 = csize & 0x00ffffff;
+	usize				 = usize & 0x3fffffff;
 
 	if (lbits < 4 || lbits > 12) throw "illegal compression parameters";
 	if (wbits <= lbits || wbits > 14) throw "illegal compression parameters";
 
-	decoder_alloc(100, wbits, lbits);
-
 	cdata = uint32(file->getFpos());
+	table = csize;
+
+	if (has_checkpoints)
+	{
+		// read block size from the end of the checkpoint table:
+		if (csize < 4) throw "data corrupted";
+		file->setFpos(cdata + csize - 4);
+		block_size		  = file->read_LE<uint32>();
+		uint32 num_blocks = block_size ? (usize + block_size - 1) / block_size : 0;
+		if (num_blocks == 0 || csize < num_blocks * 4) throw "data corrupted";
+		table = csize - num_blocks * 4;
+		file->setFpos(cdata);
+	}
+
+	decoder_alloc(100, wbits, lbits);
 }
 
 HeatShrinkDecoder::~HeatShrinkDecoder() noexcept
@@ -109,9 +124,44 @@ SIZE HeatShrinkDecoder::read(void* _data, SIZE size, bool partial)
 		if (eof_pending()) throw END_OF_FILE;
 		if (size == 0) set_eof_pending();
 	}
-	uint8* data		 = reinterpret_cast<uint8*>(_data);
-	uint32 remaining = size;
+	uint8* data = reinterpret_cast<uint8*>(_data);
+
+	if (block_size == 0)
+	{
+		decode(data, size);
+		return size;
+	}
+
+	// with checkpoints: the blocks must be decoded separately
+	for (uint32 remaining = size; remaining;)
+	{
+		if (upos - ublock == block_size) start_block(upos / block_size);
+		uint32 cnt = std::min(remaining, ublock + block_size - upos);
+		decode(data, cnt);
+		data += cnt;
+		remaining -= cnt;
+	}
+	return size;
+}
+
+void HeatShrinkDecoder::start_block(uint32 n)
+{
+	// start decoding at block n: reset the decoder and seek to the checkpoint
+
+	decoder_reset();
+	if (n == 0) cpos = 0;
+	else
+	{
+		file->setFpos(cdata + table + (n - 1) * 4);
+		cpos = file->read_LE<uint32>();
+		if unlikely (cpos > table) throw "data corrupted";
+	}
+	file->setFpos(cdata + cpos);
+	upos = ublock = n * block_size;
+}
 
+void HeatShrinkDecoder::decode(uint8* data, uint32 remaining)
+{
 	for (;;)
 	{
 		size_t cnt	  = 0;
@@ -120,10 +170,10 @@ SIZE HeatShrinkDecoder::read(void* _data, SIZE size, bool partial)
 		upos += cnt;
 		data += cnt;
 		remaining -= cnt;
-		if (remaining == 0) return size;
+		if (remaining == 0) return;
 
 		uint8  buffer[100];
-		uint32 avail = file->read(buffer, std::min(csize - cpos, uint32(sizeof(buffer))));
+		uint32 avail = file->read(buffer, std::min(table - cpos, uint32(sizeof(buffer))));
 		if unlikely (avail == 0) throw "data corrupted"; // cpos == csize
 		result = decoder_sink(buffer, avail, &cnt);
 		assert(result >= 0);
@@ -142,7 +192,13 @@ void HeatShrinkDecoder::setFpos(ADDR new_upos)
 		return;
 	}
 
-	if (uint32(new_upos) < upos)
+	if (block_size)
+	{
+		// with checkpoints: go to start of block if new_upos is in another block or before upos:
+		uint32 n = uint32(new_upos) / block_size;
+		if (uint32(new_upos) < upos || n * block_size != ublock) start_block(n);
+	}
+	else if (uint32(new_upos) < upos)
 	{
 		decoder_reset();
 		file->setFpos(cdata);
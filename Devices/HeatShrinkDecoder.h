@@ -16,7 +16,8 @@ extern bool isHeatShrinkEncoded(File*);
 	This allows easy decompression of all files read, because class HeatShrinkDecoder implements
 	the File interface just like any other file does. The data receiver just must provide
 	an initialization with an open File instead of opening it itself.
-	class HeatShrinkDecoder supports setFPos() but it is slow.
+	class HeatShrinkDecoder supports setFPos() but it is slow,
+	except if the file was written with checkpoints: then it decodes at most one block.
 */
 class HeatShrinkDecoder : public File
 {
@@ -31,6 +32,7 @@ public:
 
 	/*	Wrap another file using the provided usize and csize and start decompression at the current fpos.
 		csize must contain the wbits and lbits in the MSB.
+		usize may contain the flags for compressed and checkpoints in the MSB.
 	*/
 	HeatShrinkDecoder(FilePtr file, uint32 usize, uint32 csize);
 	virtual ~HeatShrinkDecoder() noexcept override;
@@ -48,8 +50,14 @@ public:
 	uint32	upos  = 0; // position inside uncompressed data
 	uint32	cpos  = 0; // position inside compressed data
 
+	uint32 block_size = 0; // checkpoint interval, 0 = no checkpoints
+	uint32 table	  = 0; // start of checkpoint table in cdata[]
+	uint32 ublock	  = 0; // start of current block in uncompressed data
+
 private:
 	void init();
+	void decode(uint8* data, uint32 size);
+	void start_block(uint32 n);
 
 	uint16 input_size;	 /* bytes in input buffer */
 	uint16 input_index;	 /* offset to next unprocessed input byte */
@@ -69,6 +69,14 @@ HeatShrinkEncoder::HeatShrinkEncoder(FilePtr file, uint8 windowbits, uint8 looka
 	encoder_reset();
 }
 
+HeatShrinkEncoder::HeatShrinkEncoder(
+	FilePtr file, uint8 windowbits, uint8 lookaheadbits, bool write_magic, uint32 block_size) :
+	HeatShrinkEncoder(file, windowbits, lookaheadbits, write_magic)
+{
+	if (block_size && block_size < 1u << windowbits) throw "checkpoint interval too small";
+	this->block_size = block_size;
+}
+
 HeatShrinkEncoder::~HeatShrinkEncoder() noexcept
 {
 	// flush all data to the target file.
@@ -99,11 +107,19 @@ void HeatShrinkEncoder::finish()
 		flush();
 		encoder_free();
 
+		if (file && block_size)
+		{
+			// append the checkpoint table:
+			for (uint i = 0; i < checkpoints.count(); i++) file->write_LE(checkpoints[i]);
+			file->write_LE(block_size);
+			csize += checkpoints.count() * 4 + 4;
+		}
+
 		if (file)
 		{
 			assert(file->getFpos() == cdata + csize);
 			file->setFpos(cdata - 8);
-			file->write_LE(usize | 0x80000000);
+			file->write_LE(usize | 0x80000000 | (block_size ? 0x40000000 : 0));
 			file->write_LE(csize | uint32(windowbits << 28) | uint32(lookaheadbits << 24));
 			file->setFpos(cdata + csize);
 		}
@@ -130,6 +146,17 @@ void HeatShrinkEncoder::flush()
 	}
 }
 
+void HeatShrinkEncoder::restart()
+{
+	// start a new block: flush all data and reset the encoder.
+	// the decoder can start decoding at this position with an empty window.
+
+	encoder_finish();
+	flush();
+	checkpoints.append(csize);
+	encoder_reset();
+}
+
 SIZE HeatShrinkEncoder::write(const void* _data, SIZE size, bool)
 {
 	const uint8* data	   = reinterpret_cast<const uint8*>(_data);
@@ -137,7 +164,18 @@ SIZE HeatShrinkEncoder::write(const void* _data, SIZE size, bool)
 
 	for (;;)
 	{
-		SIZE cnt = encoder_write(data, remaining);
+		SIZE cnt = remaining;
+
+		if (block_size)
+		{
+			// don't write across the end of a block.
+			// start the next block only when more data is written, so that there are no empty blocks:
+			uint32 n = usize % block_size;
+			if (n == 0 && remaining && usize > checkpoints.count() * block_size) restart();
+			cnt = std::min(cnt, SIZE(block_size - n));
+		}
+
+		cnt = encoder_write(data, cnt);
 
 		usize += cnt;
 		data += cnt;
@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #pragma once
+#include "Array.h"
 #include "HeatShrinkDecoder.h"
 
 // Use indexing for compression (much faster but requires much more space.)
@@ -22,10 +23,16 @@ namespace kio::Devices
 	HeatShrink encoded file header:
 	all fields are little endian
 		uint32	magic
-		uint32  usize | 0x80000000
+		uint32  usize | 0x80000000 | (checkpoints ? 0x40000000 : 0)
 		uint24	csize
 		uint8	wbits << 4 + lbits
 		uint8	cdata[csize]
+
+	With checkpoints the compression is restarted every `block_size` bytes of uncompressed data
+	and the decoder can seek to the start of any block. cdata[] is then followed by the checkpoint table,
+	which is included in csize:
+		uint32  offset[num_blocks-1]  start of block 1++ in cdata[]
+		uint32  block_size
 */
 class HeatShrinkEncoder : public File
 {
@@ -42,6 +49,11 @@ public:
 	*/
 	HeatShrinkEncoder(FilePtr file, uint8 windowbits = 12, uint8 lookaheadbits = 6, bool write_magic = true);
 
+	/*	Create a compressed file wrapper with checkpoints every block_size bytes of uncompressed data.
+		This allows fast random access in the HeatShrinkDecoder at the cost of a slightly worse compression.
+	*/
+	HeatShrinkEncoder(FilePtr file, uint8 windowbits, uint8 lookaheadbits, bool write_magic, uint32 block_size);
+
 	/*	`close()` the encoder but do not actively close the target file.
 	*/
 	virtual ~HeatShrinkEncoder() noexcept override;
@@ -71,8 +83,12 @@ public:
 	uint32	csize = 0; // compressed size (size of cdata[])
 	uint32	usize = 0; // uncompressed size (uncompressed file size)
 
+	uint32		  block_size = 0; // checkpoint interval, 0 = no checkpoints
+	Array<uint32> checkpoints;	  // start of block 1++ in cdata[]
+
 private:
 	void flush();
+	void restart();
 	void encoder_free();
 	void encoder_reset();
 
@@ -3,7 +3,11 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "QspiFlashDevice.h"
+#include "Dispatcher.h"
 #include "Flash.h"
+#include "Logger.h"
+#include "timing.h"
+#include <string.h>
 
 
 namespace kio::Devices
@@ -34,11 +38,207 @@ QspiFlashDevice<ssw>::QspiFlashDevice(uint32 size, Flags flags) throws :
 	QspiFlashDevice(Flash::flash_size() - size, size - prefs_size, flags)
 {}
 
+template<int ssw>
+QspiFlashDevice<ssw>::~QspiFlashDevice() noexcept
+{
+	// the destructor can't throw: call sync() before to get write errors.
+
+	try
+	{
+		flushWriteCache();
+	}
+	catch (Error e)
+	{
+		logline("QspiFlashDevice: write cache not flushed: %s", e);
+	}
+	catch (...)
+	{}
+	free_cache();
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::free_cache() noexcept
+{
+	if (flush_scheduled) Dispatcher::removeHandler(flush_handler, this);
+	flush_scheduled = false;
+
+	for (uint i = 0; i < cache_count; i++) delete[] cache[i].data;
+	delete[] cache;
+	cache		= nullptr;
+	cache_count = 0;
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::setWriteCache(uint num_blocks, uint timeout_ms) throws
+{
+	flushWriteCache();
+	free_cache();
+
+	cache_timeout_us = timeout_ms * 1000;
+	if (num_blocks == 0) return;
+
+	cache = new CachedBlock[num_blocks];
+	for (uint i = 0; i < num_blocks; i++) cache[i].data = new uint8[Flash::esize];
+	cache_count = num_blocks;
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::flushWriteCache() throws
+{
+	for (uint i = 0; i < cache_count; i++) flush_block(cache[i]);
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::flush_block(CachedBlock& e) throws
+{
+	// write the cached erase block to flash.
+	// sectors which were not written are read from flash, then the block is erased and programmed at once.
+
+	if (e.dirty == 0) return;
+
+	constexpr uint ssize = 1 << ssw;
+	uint32		   addr	 = flash_addr(e);
+	for (uint i = 0; i < Flash::esize / ssize; i++)
+	{
+		if (~e.dirty & (1u << i)) Flash::readData(addr + i * ssize, e.data + i * ssize, ssize);
+	}
+	e.dirty = 0;
+	Flash::writeData(addr, e.data, Flash::esize);
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::flush_expired() throws
+{
+	for (uint i = 0; i < cache_count; i++)
+	{
+		if (cache[i].dirty && now() - cache[i].since >= int(cache_timeout_us)) flush_block(cache[i]);
+	}
+}
+
+template<int ssw>
+int QspiFlashDevice<ssw>::flush_handler(void* data) noexcept
+{
+	// Dispatcher handler: flush expired blocks and reschedule for the next one
+
+	QspiFlashDevice* self = reinterpret_cast<QspiFlashDevice*>(data);
+	try
+	{
+		self->flush_expired();
+	}
+	catch (Error e)
+	{
+		logline("QspiFlashDevice: write cache not flushed: %s", e);
+	}
+	catch (...)
+	{}
+
+	int delay = 0;
+	for (uint i = 0; i < self->cache_count; i++)
+	{
+		CachedBlock& e = self->cache[i];
+		if (e.dirty == 0) continue;
+		int d = max(1, int(self->cache_timeout_us) - (now() - e.since));
+		if (delay == 0 || d < delay) delay = d;
+	}
+	self->flush_scheduled = delay != 0;
+	return delay;
+}
+
+template<int ssw>
+typename QspiFlashDevice<ssw>::CachedBlock& QspiFlashDevice<ssw>::get_block(uint32 block) throws
+{
+	// get the cache entry for the erase block.
+	// if the block is not in the cache then use a free entry or evict the oldest one.
+
+	CachedBlock* unused = nullptr;
+	CachedBlock* oldest = nullptr;
+	for (uint i = 0; i < cache_count; i++)
+	{
+		CachedBlock& e = cache[i];
+		if (e.dirty == 0) unused = &e;
+		else if (e.block == block) return e;
+		else if (!oldest || e.since < oldest->since) oldest = &e;
+	}
+
+	if (!unused)
+	{
+		flush_block(*oldest);
+		unused = oldest;
+	}
+
+	unused->block = block;
+	unused->since = now();
+	if (!flush_scheduled && cache_timeout_us)
+	{
+		Dispatcher::addWithDelay(flush_handler, this, int32(cache_timeout_us));
+		flush_scheduled = true;
+	}
+	return *unused;
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::cache_write(ADDR addr, const uint8* data, SIZE size) throws
+{
+	// write data into the cache. data = nullptr: erase.
+	// sectors which are only partially written and not yet in the cache are read from flash.
+
+	constexpr uint smask = (1 << ssw) - 1;
+	constexpr uint emask = Flash::esize - 1;
+
+	while (size)
+	{
+		CachedBlock& e	  = get_block(uint32(addr >> Flash::sse));
+		uint		 offs = uint(addr) & emask;
+		uint		 n	  = min(size, Flash::esize - offs);
+		uint		 i0	  = offs >> ssw;
+		uint		 i1	  = (offs + n - 1) >> ssw;
+
+		if ((offs & smask) && (~e.dirty & (1u << i0)))
+			Flash::readData(flash_addr(e) + (i0 << ssw), e.data + (i0 << ssw), 1 << ssw);
+		if (((offs + n) & smask) && (~e.dirty & (1u << i1)))
+			Flash::readData(flash_addr(e) + (i1 << ssw), e.data + (i1 << ssw), 1 << ssw);
+
+		if (data) memcpy(e.data + offs, data, n), data += n;
+		else memset(e.data + offs, 0xff, n);
+		e.dirty |= (2u << i1) - (1u << i0);
+
+		addr += n;
+		size -= n;
+	}
+}
+
+template<int ssw>
+void QspiFlashDevice<ssw>::cache_read(ADDR addr, uint8* data, SIZE size) noexcept
+{
+	// overlay data read from flash with the dirty sectors in the cache
+
+	constexpr uint ssize = 1 << ssw;
+	ADDR		   end	 = addr + size;
+
+	for (uint i = 0; i < cache_count; i++)
+	{
+		CachedBlock& e = cache[i];
+		if (e.dirty == 0) continue;
+
+		ADDR a0 = ADDR(e.block) << Flash::sse;
+		if (a0 >= end || a0 + Flash::esize <= addr) continue;
+
+		for (uint j = 0; j < Flash::esize / ssize; j++)
+		{
+			if (~e.dirty & (1u << j)) continue;
+			ADDR s0 = max(addr, a0 + j * ssize);
+			ADDR s1 = min(end, a0 + (j + 1) * ssize);
+			if (s0 < s1) memcpy(data + (s0 - addr), e.data + (s0 - a0), s1 - s0);
+		}
+	}
+}
+
 template<int ssw>
 void QspiFlashDevice<ssw>::readSectors(LBA block, void* data, SIZE count) throws
 {
 	clamp_blocks(block, count);
 	Flash::readData((first_sector + block) << ssw, data, count << ssw);
+	if (cache_count) cache_read(ADDR(block) << ssw, uptr(data), count << ssw);
 }
 
 template<int ssw>
@@ -46,6 +246,7 @@ void QspiFlashDevice<ssw>::readData(ADDR addr, void* data, SIZE size) throws
 {
 	clamp(addr, size);
 	Flash::readData((first_sector << ssw) + addr, data, size);
+	if (cache_count) cache_read(addr, uptr(data), size);
 }
 
 template<int ssw>
@@ -53,7 +254,8 @@ void QspiFlashDevice<ssw>::writeSectors(LBA block, const void* data, SIZE count)
 {
 	if (!isWritable()) throw NOT_WRITABLE;
 	clamp_blocks(block, count);
-	if (data) Flash::writeData((first_sector + block) << ssw, data, count << ssw);
+	if (cache_count) cache_write(ADDR(block) << ssw, cuptr(data), count << ssw);
+	else if (data) Flash::writeData((first_sector + block) << ssw, data, count << ssw);
 	else Flash::eraseData((first_sector + block) << ssw, count << ssw);
 }
 
@@ -62,7 +264,8 @@ void QspiFlashDevice<ssw>::writeData(ADDR addr, const void* data, SIZE size) thr
 {
 	if (!isWritable()) throw NOT_WRITABLE;
 	clamp(addr, size);
-	if (data) Flash::writeData((first_sector << ssw) + addr, data, size);
+	if (cache_count) cache_write(addr, cuptr(data), size);
+	else if (data) Flash::writeData((first_sector << ssw) + addr, data, size);
 	else Flash::eraseData((first_sector << ssw) + addr, size);
 }
 
@@ -71,7 +274,7 @@ uint32 QspiFlashDevice<ssw>::ioctl(IoCtl cmd, void* arg1, void* arg2) throws
 {
 	switch (cmd.cmd)
 	{
-		//case IoCtl::CTRL_SYNC: return 0;
+	case IoCtl::CTRL_SYNC: flushWriteCache(); return 0;
 		//case IoCtl::GET_SECTOR_SIZE: return 1u << ss_write;
 		//case IoCtl::GET_BLOCK_SIZE: return 1u << ss_erase;
 		//case IoCtl::FLUSH_IN: return 0;
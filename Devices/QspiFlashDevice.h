@@ -4,6 +4,7 @@
 
 #pragma once
 #include "BlockDevice.h"
+#include "Flash.h"
 
 
 namespace kio::Devices
@@ -17,8 +18,9 @@ namespace kio::Devices
 	Callbacks suspend_system() and resume_system() should be implemented by the application!
 	see common/pico/SuspendSystem.h.
 
-	Note: Writing to the Qspi flash is unbuffered!
-	TODO: use a sector buffer for writing.
+	Writing to the Qspi flash is unbuffered unless a write cache is set with setWriteCache().
+	Then written sectors are collected in RAM per erase block and each block is erased and
+	programmed only once: on ioctl(CTRL_SYNC), when the block is evicted or when the timeout expired.
 
 	@template param ssw:
 	This is the number of bits per sector used in readSector()/writeSector().
@@ -44,8 +46,46 @@ public:
 	virtual void   writeData(ADDR, const void* data, SIZE size) throws override;
 	virtual uint32 ioctl(IoCtl cmd, void* arg1 = nullptr, void* arg2 = nullptr) throws override;
 
+	virtual ~QspiFlashDevice() noexcept override;
+
+	/*	Set up a write-back cache for 'num_blocks' erase blocks of 4 kB each.
+		Dirty blocks are written after 'timeout_ms' by a Dispatcher handler, on ioctl(CTRL_SYNC),
+		if the block must be evicted to cache another block and in the destructor.
+		Errors in the Dispatcher handler and in the destructor can only be logged:
+		call sync() before the device is destroyed to get write errors.
+		num_blocks = 0 flushes and removes the cache.
+		The cache is off by default.
+	*/
+	void setWriteCache(uint num_blocks, uint timeout_ms = 1000) throws;
+
+	/*	Write all dirty blocks to flash.
+	*/
+	void flushWriteCache() throws;
+
 private:
 	uint32 first_sector;
+
+	struct CachedBlock
+	{
+		uint32 block = 0;		// erase block number in this device
+		uint32 dirty = 0;		// one bit per sector. sectors which are not dirty are not valid.
+		CC	   since;			// time of first write since last flush
+		uint8* data	 = nullptr; // 4 kB
+	};
+
+	CachedBlock* cache			  = nullptr;
+	uint		 cache_count	  = 0;
+	uint32		 cache_timeout_us = 0;
+	bool		 flush_scheduled  = false;
+
+	uint32		 flash_addr(const CachedBlock& e) const noexcept { return (first_sector << ssw) + (e.block << Flash::sse); }
+	void		 flush_block(CachedBlock&) throws;
+	void		 flush_expired() throws;
+	CachedBlock& get_block(uint32 block) throws;
+	void		 cache_write(ADDR, const uint8* data, SIZE) throws;
+	void		 cache_read(ADDR, uint8* data, SIZE) noexcept;
+	void		 free_cache() noexcept;
+	static int	 flush_handler(void*) noexcept;
 };
 
 
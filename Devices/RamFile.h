@@ -4,6 +4,7 @@
 
 #pragma once
 #include "File.h"
+#include <cstring>
 
 /*
 	template class RamFile provides files in ram.
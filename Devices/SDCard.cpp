@@ -3,17 +3,21 @@
 // https://spdx.org/licenses/BSD-2-Clause.html
 
 #include "SDCard.h"
+#include "Dispatcher.h"
 #include "Logger.h"
 #include "common/DiskLight.h"
 #include "common/Trace.h"
 #include "common/cdefs.h"
 #include "common/timing.h"
 #include "crc.h"
-#include <hardware/gpio.h>
-#include <hardware/spi.h>
-#include <pico/stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#if !defined MAKE_TOOLS || !MAKE_TOOLS
+  #include <hardware/dma.h>
+  #include <hardware/gpio.h>
+  #include <hardware/spi.h>
+  #include <pico/stdlib.h>
+#endif
 
 #ifdef PICO_DEFAULT_SPI_CLOCK
 static constexpr uint32 spi_clock = PICO_DEFAULT_SPI_CLOCK;
@@ -22,6 +26,7 @@ static_assert(spi_clock <= 25 * 1000 * 1000);
 static constexpr uint32 spi_clock = 10 * 1000 * 1000;
 #endif
 
+#if !defined MAKE_TOOLS || !MAKE_TOOLS
 // clang-format off
 // assert unchanged definition, then replace c-style casting macros with c++ version:
 #define spi0_hw ((spi_hw_t *)SPI0_BASE)
@@ -37,6 +42,7 @@ static constexpr uint32 spi_clock = 10 * 1000 * 1000;
 #define spi0 reinterpret_cast<spi_inst_t*>(spi0_hw)
 #define spi1 reinterpret_cast<spi_inst_t*>(spi1_hw)
 // clang-format on
+#endif
 
 // some CRCs:
 // CMD0  GOTO_IDLE_STATE   0x95
@@ -120,6 +126,17 @@ SDCard::SDCard(uint8 rx, uint8 cs, uint8 clk, uint8 tx) noexcept :
 	init_spi();
 }
 
+SDCard::~SDCard() noexcept
+{
+	Dispatcher::removeHandler(async_handler, this);
+	abort_async();
+	if (dma_rx >= 0)
+	{
+		dma_channel_unclaim(uint(dma_rx));
+		dma_channel_unclaim(uint(dma_tx));
+	}
+}
+
 void SDCard::init_spi() noexcept
 {
 	// chip select CSn:
@@ -664,6 +681,13 @@ void SDCard::stop_transmission() noexcept
 	if (r1 != 0) debugstr("\nERROR: cmd12 r1=0x%02x  ", r1);
 }
 
+void SDCard::start_read_multiple(uint32 blkidx) throws
+{
+	// CMD18: read multiple blocks
+
+	send_cmd(18, ccs ? blkidx : blkidx << 9, no_deselect);
+}
+
 void SDCard::readSectors(LBA blkidx, void* data, SIZE blkcnt) throws
 {
 	// CMD18: read multiple blocks
@@ -674,35 +698,220 @@ void SDCard::readSectors(LBA blkidx, void* data, SIZE blkcnt) throws
 	uchar* udata = reinterpret_cast<uchar*>(data);
 	if (blkcnt == 1) return read_single_block(blkidx, udata);
 
-	uint retry = blkcnt + 1;
-r:
-	send_cmd(18, ccs ? blkidx : blkidx << 9, no_deselect);
+	readSectorsAsync(blkidx, data, blkcnt);
+	while (!pollAsync()) {}
+}
 
-	while (blkcnt)
+bool SDCard::start_dma(uint8* data, uint32 count) noexcept
+{
+	// start DMA transfer of 'count' bytes from the SPI into data[]:
+	// the tx channel sends 0xff, the rx channel stores the received bytes.
+	// @return false if no DMA channels are available
+
+	static const uint8 ff = 0xff;
+
+	if (dma_rx < 0)
 	{
-		uint8 crc[2];
-		uint8 token = receive_byte_or_throw(100000);
-		if (token != DataToken)
+		dma_rx = dma_claim_unused_channel(false);
+		if (dma_rx < 0) return false;
+		dma_tx = dma_claim_unused_channel(false);
+		if (dma_tx < 0)
 		{
-			stop_transmission();
-			throwReadDataErrorToken(token);
+			dma_channel_unclaim(uint(dma_rx));
+			dma_rx = -1;
+			return false;
 		}
-		read_spi(udata, 512);
-		read_spi(crc, 2);
-		if ((no_crc ? 0 : crc16(udata, 512)) == peek_u16(crc))
+	}
+
+	dma_channel_config c = dma_channel_get_default_config(uint(dma_tx));
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+	channel_config_set_read_increment(&c, false);
+	channel_config_set_write_increment(&c, false);
+	channel_config_set_dreq(&c, spi_get_dreq(spi, true));
+	dma_channel_configure(uint(dma_tx), &c, &spi_get_hw(spi)->dr, &ff, count, false);
+
+	c = dma_channel_get_default_config(uint(dma_rx));
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+	channel_config_set_read_increment(&c, false);
+	channel_config_set_write_increment(&c, true);
+	channel_config_set_dreq(&c, spi_get_dreq(spi, false));
+	dma_channel_configure(uint(dma_rx), &c, data, &spi_get_hw(spi)->dr, count, false);
+
+	dma_start_channel_mask((1u << dma_tx) | (1u << dma_rx));
+	return true;
+}
+
+bool SDCard::dma_busy() const noexcept
+{
+	return dma_channel_is_busy(uint(dma_rx)); //
+}
+
+void SDCard::abort_async() noexcept
+{
+	if (async.dma_data)
+	{
+		dma_channel_abort(uint(dma_tx));
+		dma_channel_abort(uint(dma_rx));
+	}
+	async.blkcnt   = 0;
+	async.dma_data = nullptr;
+	async.crc_data = nullptr;
+}
+
+void SDCard::readSectorsAsync(LBA blkidx, void* data, SIZE blkcnt, AsyncCallback* callback, void* cookie) throws
+{
+	// start CMD18: read multiple blocks
+
+	trace("SDCard::readSectorsAsync");
+	debugstr("%s\n", "SDCard::readSectorsAsync");
+
+	assert(!isBusy());
+
+	async		   = AsyncRead();
+	async.data	   = reinterpret_cast<uint8*>(data);
+	async.blkidx   = blkidx;
+	async.retry	   = blkcnt + 1;
+	async.callback = callback;
+	async.cookie   = cookie;
+
+	if (blkcnt)
+	{
+		start_read_multiple(blkidx);
+		async.blkcnt = blkcnt;
+		async.start	 = now();
+	}
+
+	if (callback) Dispatcher::addHandler(async_handler, this);
+}
+
+bool SDCard::check_crc() throws
+{
+	// check the CRC of the last received block.
+	// on error restart reading at this block.
+	// @return true if restarted
+
+	uint8* data = async.crc_data;
+	if (!data) return false;
+
+	async.crc_data = nullptr;
+	if ((no_crc ? 0 : crc16(data, 512)) == async.crc)
+	{
+		async.blkcnt--;
+		return false;
+	}
+
+	if (async.dma_data)
+		while (dma_busy()) {}
+	async.dma_data = nullptr;
+	stop_transmission();
+	if (async.retry-- == 0) throw CRC_ERROR;
+	logline("crc_error");
+
+	async.blkidx -= LBA(async.data - data) >> 9;
+	async.data = data;
+	start_read_multiple(async.blkidx);
+	async.start = now();
+	return true;
+}
+
+bool SDCard::pollAsync() throws
+{
+	// advance the state machine:
+	// receive token -> start DMA -> check CRC of previous block while DMA is running -> DMA done -> receive CRC
+
+	if (async.blkcnt == 0) return true;
+
+	try
+	{
+		if (async.dma_data)
 		{
-			blkidx++;
-			udata += 512;
-			blkcnt--;
-			continue;
+			if (dma_busy())
+			{
+				check_crc();
+				return false;
+			}
+			if (check_crc()) return false;
+
+			uint8 crc[2];
+			read_spi(crc, 2);
+			async.crc_data = async.dma_data;
+			async.crc	   = peek_u16(crc);
+			async.dma_data = nullptr;
+			async.start	   = now();
+		}
+
+		if (async.blkcnt > (async.crc_data != nullptr))
+		{
+			// wait for the data token of the next block but don't block the CPU:
+			uint8 token = 0xff;
+			for (uint i = 0; i < 8 && token == 0xff; i++) token = read_byte();
+			if (token == 0xff)
+			{
+				if (now() - async.start > 100000) throwDeviceNotResponding();
+				check_crc();
+				return false;
+			}
+			if (token != DataToken)
+			{
+				stop_transmission();
+				throwReadDataErrorToken(token);
+			}
+
+			uint8* data = async.data;
+			async.data += 512;
+			async.blkidx++;
+
+			if (start_dma(data, 512))
+			{
+				async.dma_data = data;
+				check_crc(); // while the DMA is running
+				return false;
+			}
+
+			// no DMA channel available: polled transfer
+			uint8 crc[2];
+			read_spi(data, 512);
+			read_spi(crc, 2);
+			if (check_crc()) return false;
+			async.crc_data = data;
+			async.crc	   = peek_u16(crc);
+			async.start	   = now();
+			return false;
 		}
+
+		if (check_crc()) return false;
 		stop_transmission();
-		if (retry) logline("crc_error");
-		if (retry--) goto r;
-		else throw CRC_ERROR;
+		return true;
 	}
+	catch (...)
+	{
+		abort_async();
+		throw;
+	}
+}
 
-	stop_transmission();
+int SDCard::async_handler(void* data) noexcept
+{
+	// Dispatcher handler for readSectorsAsync() with callback
+
+	SDCard* self  = reinterpret_cast<SDCard*>(data);
+	cstr	error = nullptr;
+
+	try
+	{
+		if (!self->pollAsync()) return 20;
+	}
+	catch (cstr e)
+	{
+		error = e;
+	}
+	catch (...)
+	{
+		error = UNKNOWN_ERROR;
+	}
+
+	self->async.callback(self->async.cookie, error);
+	return 0;
 }
 
 void SDCard::writeSectors(LBA blkidx, const void* data, SIZE blkcnt) throws
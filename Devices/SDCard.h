@@ -8,7 +8,11 @@
 #include "SerialDevice.h"
 #include "cdefs.h"
 #include "standard_types.h"
-#include <hardware/spi.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <hardware/spi.h>
+#endif
 
 
 namespace kio::Devices
@@ -68,6 +72,7 @@ public:
 	static SDCard* defaultInstance();
 
 	SDCard(uint8 rx, uint8 cs, uint8 clk, uint8 tx) noexcept;
+	virtual ~SDCard() noexcept override;
 
 	//virtual void read (ADDR q, uint8* bu, SIZE) override;
 	//virtual void write (ADDR z, const uint8* bu, SIZE) override;
@@ -76,6 +81,22 @@ public:
 	virtual void   writeSectors(LBA, const void* bu, SIZE) throws override;
 	virtual uint32 ioctl(IoCtl, void* arg1 = nullptr, void* arg2 = nullptr) throws override;
 
+	/*	Read sectors in the background using DMA.
+		The data of each block is transferred by DMA while the CPU checks the CRC of the previous block.
+		The transfer is advanced by pollAsync(). If a callback is given then a Dispatcher handler
+		calls pollAsync() and finally the callback with error = nullptr or the error message.
+		Otherwise the application must call pollAsync() until it returns true.
+		No other function of the SDCard must be called while the read is in progress.
+	*/
+	using AsyncCallback = void(void* cookie, cstr error) noexcept;
+	void readSectorsAsync(LBA, void* bu, SIZE, AsyncCallback* = nullptr, void* cookie = nullptr) throws;
+
+	/*	Advance the asynchronous read.
+		@return true when all sectors were read or if no read is in progress.
+	*/
+	bool pollAsync() throws;
+	bool isBusy() const noexcept { return async.blkcnt != 0; }
+
 	void printSCR(SerialDevice*, bool v = 1);
 	void printCID(SerialDevice*, bool v = 1);
 	void printCSD(SerialDevice*, bool v = 1);
@@ -111,8 +132,33 @@ private:
 	void write_csd();										   // CMD27  TODO
 	void set_blocklen(uint);								   // CMD16
 	void read_single_block(uint32 blkidx, uint8* data);		   // CMD17
+	void start_read_multiple(uint32 blkidx);				   // CMD18
 	void write_single_block(uint32 blkidx, const uint8* data); // CMD24
 
+	struct AsyncRead
+	{
+		uint8*		   data		= nullptr; // next block to receive
+		LBA			   blkidx	= 0;	   // next block to receive
+		SIZE		   blkcnt	= 0;	   // blocks not yet verified, incl. dma_data and crc_data
+		uint		   retry	= 0;	   //
+		uint8*		   dma_data = nullptr; // block in transfer
+		uint8*		   crc_data = nullptr; // block received but CRC not yet checked
+		uint16		   crc		= 0;	   // received CRC for crc_data
+		CC			   start;			   // start of token wait
+		AsyncCallback* callback = nullptr;
+		void*		   cookie	= nullptr;
+	} async;
+
+	int dma_rx = -1;
+	int dma_tx = -1;
+
+	bool start_dma(uint8* data, uint32 count) noexcept;
+	bool dma_busy() const noexcept;
+	bool check_crc() throws;
+	void abort_async() noexcept;
+
+	static int async_handler(void*) noexcept;
+
 	void __attribute__((noreturn)) throwDeviceNotResponding();
 	void __attribute__((noreturn)) throwWriteDataErrorToken(uint8 n);
 	void __attribute__((noreturn)) throwReadDataErrorToken(uint8 n);
@@ -0,0 +1,372 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "WearLevelingDevice.h"
+#include "Dispatcher.h"
+#include <algorithm>
+#include <string.h>
+
+
+namespace kio::Devices
+{
+
+static constexpr uint none	   = ~0u;
+static constexpr uint ssize	   = 1 << WearLevelingDevice::ssw;
+static constexpr uint gc_delay = 20 * 1000; // µs
+
+static uint log2(uint n) noexcept
+{
+	uint i = 0;
+	while ((1u << i) < n) i++;
+	return i;
+}
+
+WearLevelingDevice::WearLevelingDevice(BlockDevicePtr flash, uint spare) throws :
+	BlockDevice(0, ssw, ssw, 0, readable | writable | overwritable),
+	flash(flash),
+	spare_blocks(max(3u, spare))
+{
+	assert(flash);
+
+	ss_block = log2(flash->eraseBlockSize());
+	if (ss_block < 10 || ss_block > 16) throw "FTL: unsupported erase block size";
+	if (flash->ss_write > ssw) throw "FTL: unsupported write sector size";
+	if (!flash->isWritable()) throw NOT_WRITABLE;
+
+	num_blocks		= uint(flash->totalSize() >> ss_block);
+	slots_per_block = min((1u << (ss_block - ssw)) - 1, (ssize - header_size) / 4); // header must fit in sector 0
+	if (num_blocks <= spare_blocks) throw "FTL: flash disk too small";
+	if (num_blocks * slots_per_block >= unmapped) throw "FTL: flash disk too large";
+
+	sector_count = (num_blocks - spare_blocks) * slots_per_block;
+	blocks		 = std::unique_ptr<BlockInfo[]>(new BlockInfo[num_blocks]);
+	map			 = std::unique_ptr<uint16[]>(new uint16[sector_count]);
+	std::fill_n(map.get(), sector_count, unmapped);
+
+	scan();
+}
+
+WearLevelingDevice::~WearLevelingDevice() noexcept
+{
+	if (gc_scheduled) Dispatcher::removeHandler(gc_handler, this);
+
+	try
+	{
+		flash->sync();
+	}
+	catch (...)
+	{}
+}
+
+void WearLevelingDevice::scan() throws
+{
+	// read the headers of all blocks and rebuild the sector map.
+	// blocks are replayed in the order of their sequence numbers so that newer slots win.
+
+	std::unique_ptr<uint32[]> header {new uint32[ssize / 4]};
+	std::unique_ptr<uint32[]> seq {new uint32[num_blocks]};
+	std::unique_ptr<uint[]>	  order {new uint[num_blocks]};
+	std::unique_ptr<bool[]>	  has_header {new bool[num_blocks]};
+	uint					  num_used	   = 0;
+	uint32					  total_erases = 0;
+
+	for (uint b = 0; b < num_blocks; b++)
+	{
+		BlockInfo& bi = blocks[b];
+		flash->readData(block_addr(b), header.get(), header_size + slots_per_block * 4);
+
+		has_header[b] = header[0] == magic;
+		if (has_header[b])
+		{
+			bi.erase_count = header[1];
+			seq[b]		   = header[2];
+			sequence	   = max(sequence, header[2] + 1);
+			while (bi.written < slots_per_block && header[3 + bi.written] != 0xffffffffu) bi.written++;
+			order[num_used++] = b;
+			total_erases += bi.erase_count;
+			continue;
+		}
+
+		// no header: the block is either erased or contains foreign data:
+		bi.erased = true;
+		for (uint i = 0; i < 1u << (ss_block - ssw) && bi.erased; i++)
+		{
+			flash->readData(block_addr(b) + (i << ssw), header.get(), ssize);
+			for (uint j = 0; j < ssize / 4 && bi.erased; j++) bi.erased = header[j] == 0xffffffffu;
+		}
+	}
+
+	// erase count of blocks without header is unknown:
+	uint32 avg = num_used ? total_erases / num_used : 0;
+	for (uint b = 0; b < num_blocks; b++)
+		if (!has_header[b]) blocks[b].erase_count = avg;
+
+	std::sort(order.get(), order.get() + num_used, [&](uint a, uint b) { return int32(seq[a] - seq[b]) < 0; });
+
+	for (uint i = 0; i < num_used; i++)
+	{
+		uint b = order[i];
+		flash->readData(block_addr(b), header.get(), header_size + slots_per_block * 4);
+		for (uint slot = 0; slot < blocks[b].written; slot++)
+		{
+			LBA lba = header[3 + slot];
+			if (lba >= sector_count) continue;
+			unmap(lba);
+			map[lba] = uint16(b * slots_per_block + slot);
+			blocks[b].valid++;
+		}
+	}
+
+	// partially written blocks are not continued:
+	// the slot after the last lba may contain data of an interrupted write.
+	open_block = none;
+}
+
+uint WearLevelingDevice::numFreeBlocks() const noexcept
+{
+	uint n = 0;
+	for (uint b = 0; b < num_blocks; b++) n += b != open_block && blocks[b].valid == 0;
+	return n;
+}
+
+void WearLevelingDevice::unmap(LBA lba) noexcept
+{
+	uint16& p = map[lba];
+	if (p == unmapped) return;
+	blocks[p / slots_per_block].valid--;
+	p = unmapped;
+}
+
+void WearLevelingDevice::open_new_block(bool foreground_gc) throws
+{
+	// make the free block with the lowest erase count the new open block.
+	// if foreground_gc is set then first make sure that there is one more free block for garbage collection.
+
+	if (foreground_gc)
+	{
+		while (numFreeBlocks() < 2)
+		{
+			uint victim = find_victim();
+			if (victim == none) break;
+			relocate(victim);
+		}
+	}
+
+	uint best = none;
+	for (uint b = 0; b < num_blocks; b++)
+	{
+		if (b == open_block || blocks[b].valid) continue;
+		if (best == none || blocks[b].erase_count < blocks[best].erase_count) best = b;
+	}
+	if (best == none) throw "FTL: no free block";
+
+	BlockInfo& bi = blocks[best];
+	if (!bi.erased)
+	{
+		flash->writeSectors(LBA(block_addr(best) >> flash->ss_write), nullptr, 1u << (ss_block - flash->ss_write));
+		bi.erase_count++;
+	}
+
+	uint32 header[3] = {magic, bi.erase_count, sequence++};
+	flash->writeData(block_addr(best), header, header_size);
+
+	bi.written = 0;
+	bi.valid   = 0;
+	bi.erased  = false;
+	open_block = best;
+}
+
+void WearLevelingDevice::write_sector(LBA lba, const void* data, bool foreground_gc) throws
+{
+	// append the sector to the open block:
+	// first write the data, then the lba in the header.
+
+	if (open_block == none || blocks[open_block].written == slots_per_block) open_new_block(foreground_gc);
+
+	BlockInfo& bi	= blocks[open_block];
+	uint	   slot = bi.written++;
+	uint	   p	= open_block * slots_per_block + slot;
+
+	flash->writeData(slot_addr(p), data, ssize);
+	uint32 n = lba;
+	flash->writeData(block_addr(open_block) + header_size + slot * 4, &n, 4);
+
+	unmap(lba);
+	map[lba] = uint16(p);
+	bi.valid++;
+}
+
+void WearLevelingDevice::relocate(uint block) throws
+{
+	// copy all valid sectors of the block into the open block.
+	// thereafter the block is free.
+
+	assert(block != open_block);
+
+	std::unique_ptr<uint32[]> header {new uint32[(header_size / 4 + slots_per_block)]};
+	std::unique_ptr<uint8[]>  bu {new uint8[ssize]};
+	flash->readData(block_addr(block), header.get(), header_size + slots_per_block * 4);
+
+	for (uint slot = 0; slot < blocks[block].written && blocks[block].valid; slot++)
+	{
+		LBA	 lba = header[3 + slot];
+		uint p	 = block * slots_per_block + slot;
+		if (lba >= sector_count || map[lba] != p) continue;
+
+		flash->readData(slot_addr(p), bu.get(), ssize);
+		write_sector(lba, bu.get(), false);
+	}
+
+	assert(blocks[block].valid == 0);
+}
+
+uint WearLevelingDevice::find_victim() const noexcept
+{
+	// find the block with the fewest valid sectors
+
+	uint victim = none;
+	for (uint b = 0; b < num_blocks; b++)
+	{
+		const BlockInfo& bi = blocks[b];
+		if (b == open_block || bi.valid == 0 || bi.valid == slots_per_block) continue;
+		if (victim == none || bi.valid < blocks[victim].valid) victim = b;
+	}
+	return victim;
+}
+
+uint WearLevelingDevice::find_cold_block() const noexcept
+{
+	// find a block with static data which has a much lower erase count than the most worn block
+
+	uint   cold		 = none;
+	uint32 max_count = 0;
+	for (uint b = 0; b < num_blocks; b++)
+	{
+		const BlockInfo& bi = blocks[b];
+		max_count			= max(max_count, bi.erase_count);
+		if (b == open_block || bi.valid == 0) continue;
+		if (cold == none || bi.erase_count < blocks[cold].erase_count) cold = b;
+	}
+	return cold != none && max_count - blocks[cold].erase_count > wear_threshold ? cold : none;
+}
+
+bool WearLevelingDevice::collectGarbage() throws
+{
+	if (numFreeBlocks() < spare_blocks - 1)
+	{
+		uint victim = find_victim();
+		if (victim != none)
+		{
+			relocate(victim);
+			return true;
+		}
+	}
+
+	uint cold = find_cold_block();
+	if (cold != none)
+	{
+		relocate(cold);
+		return true;
+	}
+	return false;
+}
+
+int WearLevelingDevice::gc_handler(void* data) noexcept
+{
+	WearLevelingDevice* self = reinterpret_cast<WearLevelingDevice*>(data);
+
+	bool more = false;
+	try
+	{
+		more = self->collectGarbage();
+	}
+	catch (...)
+	{}
+
+	self->gc_scheduled = more;
+	return more ? int(gc_delay) : 0;
+}
+
+void WearLevelingDevice::readSectors(LBA lba, void* data, SIZE count) throws
+{
+	clamp_blocks(lba, count);
+
+	uint8* z = reinterpret_cast<uint8*>(data);
+	for (uint i = 0; i < count; i++, z += ssize)
+	{
+		uint p = map[lba + i];
+		if (p == unmapped) memset(z, 0xff, ssize);
+		else flash->readData(slot_addr(p), z, ssize);
+	}
+}
+
+void WearLevelingDevice::writeSectors(LBA lba, const void* data, SIZE count) throws
+{
+	if (!isWritable()) throw NOT_WRITABLE;
+	clamp_blocks(lba, count);
+
+	const uint8* q = reinterpret_cast<const uint8*>(data);
+	for (uint i = 0; i < count; i++)
+	{
+		if (q) write_sector(lba + i, q + (i << ssw));
+		else unmap(lba + i);
+	}
+
+	if (!gc_scheduled)
+	{
+		Dispatcher::addWithDelay(gc_handler, this, gc_delay);
+		gc_scheduled = true;
+	}
+}
+
+uint32 WearLevelingDevice::ioctl(IoCtl cmd, void* arg1, void* arg2) throws
+{
+	switch (cmd.cmd)
+	{
+	case IoCtl::CTRL_SYNC: return flash->ioctl(cmd);
+	case IoCtl::CTRL_TRIM:
+	{
+		if (cmd.arg1 != cmd.LBA || cmd.arg2 != cmd.SIZE || !arg1 || !arg2) throw INVALID_ARGUMENT;
+		LBA	 lba   = *reinterpret_cast<LBA*>(arg1);
+		SIZE count = *reinterpret_cast<SIZE*>(arg2);
+		writeSectors(lba, nullptr, count);
+		return 0;
+	}
+	default: //
+		return BlockDevice::ioctl(cmd, arg1, arg2);
+	}
+}
+
+} // namespace kio::Devices
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,139 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "BlockDevice.h"
+#include <memory>
+
+
+namespace kio::Devices
+{
+
+/*
+	Log-structured flash translation layer with wear leveling.
+
+	The WearLevelingDevice is put between a FileSystem and a flash BlockDevice, e.g. a QspiFlashDevice.
+	Logical sectors of 512 bytes are never overwritten in place but appended to the currently open
+	erase block and remapped. Thereby frequently written sectors like the FAT and directories
+	don't wear out their erase block and most writes only need a program and no erase cycle.
+
+	Layout of each erase block on the flash device:
+	  sector 0:  header: magic, erase count, sequence number and the logical sector number for each slot
+	  sector 1…: slots for logical sectors
+	The header must fit in sector 0: with erase blocks larger than 32 kB the last sectors are not used.
+	The data is written before the lba in the header, so a slot becomes valid only when complete.
+	On construction all headers are read to rebuild the sector map. For the same lba the slot in the
+	block with the highest sequence number and the highest slot index wins.
+
+	Garbage collection copies the remaining valid sectors of the block with the fewest valid sectors
+	into the open block. This is done in the background by a Dispatcher handler and in the foreground
+	if there is no free block left for writing. Free blocks are used in order of their erase count.
+	Blocks with static data are relocated if their erase count falls behind too far.
+
+	The underlying device must have an erase block size of 1 kB to 64 kB and must support writing
+	to erased flash without erasing. It should be formatted with the FileSystem after the FTL was
+	put on top of it, because the sector map of an unformatted device is empty.
+	Trimmed sectors are only removed from the map in RAM and may come back after a restart.
+*/
+class WearLevelingDevice : public BlockDevice
+{
+public:
+	// create the FTL on top of the flash device.
+	// 'spare_blocks' erase blocks are reserved for garbage collection. minimum is 3.
+	WearLevelingDevice(BlockDevicePtr flash, uint spare_blocks = 4) throws;
+	virtual ~WearLevelingDevice() noexcept override;
+
+	// BlockDevice interface:
+	virtual void   readSectors(LBA, void* data, SIZE count) throws override;
+	virtual void   writeSectors(LBA, const void* data, SIZE count) throws override;
+	virtual uint32 ioctl(IoCtl cmd, void* arg1 = nullptr, void* arg2 = nullptr) throws override;
+
+	// statistics:
+	uint   numBlocks() const noexcept { return num_blocks; }
+	uint32 eraseCount(uint block) const noexcept { return blocks[block].erase_count; }
+	uint   numFreeBlocks() const noexcept;
+
+	/*	Do one step of garbage collection or static wear leveling.
+		This is called by the Dispatcher after writing but can also be called by the application.
+		@return true if there is more work to do
+	*/
+	bool collectGarbage() throws;
+
+	static constexpr int	ssw			   = 9;
+	static constexpr uint32 magic		   = 0x4c57544b; // "KTWL"
+	static constexpr uint16 unmapped	   = 0xffff;
+	static constexpr uint32 wear_threshold = 16;		 // max. difference in erase counts for static data
+	static constexpr uint	header_size	   = 3 * 4;		 // magic, erase_count, sequence
+
+private:
+	struct BlockInfo
+	{
+		uint32 erase_count = 0;
+		uint16 written	   = 0;		// number of slots written
+		uint16 valid	   = 0;		// number of slots with valid data
+		bool   erased	   = false; // block is erased: no header
+	};
+
+	BlockDevicePtr				 flash;
+	uint						 num_blocks;
+	uint						 slots_per_block;
+	uint						 spare_blocks;
+	uint						 ss_block;			  // log2 of erase block size of the flash device
+	uint32						 sequence	  = 0;	  // for the next opened block
+	uint						 open_block	  = ~0u;  // block for writing
+	bool						 gc_scheduled = false; // Dispatcher handler
+	std::unique_ptr<BlockInfo[]> blocks;
+	std::unique_ptr<uint16[]>	 map; // lba -> block * slots_per_block + slot
+
+	ADDR block_addr(uint block) const noexcept { return ADDR(block) << ss_block; }
+	ADDR slot_addr(uint slot) const noexcept
+	{
+		return block_addr(slot / slots_per_block) + ((slot % slots_per_block + 1) << ssw);
+	}
+
+	void scan() throws;
+	void unmap(LBA) noexcept;
+	void write_sector(LBA, const void* data, bool foreground_gc = true) throws;
+	void open_new_block(bool foreground_gc) throws;
+	void relocate(uint block) throws;
+	uint find_victim() const noexcept;
+	uint find_cold_block() const noexcept;
+
+	static int gc_handler(void*) noexcept;
+};
+
+using WearLevelingDevicePtr = RCPtr<WearLevelingDevice>;
+
+} // namespace kio::Devices
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -166,6 +166,7 @@ struct IoCtl
 		CTRL_RESET = 80, // reset internal state, discard pending input and output, keep connected
 		CTRL_CONNECT,	 // connect to hardware, load removable disk
 		CTRL_DISCONNECT, // disconnect from hardware, unload removable disk
+		CTRL_MMAP,		 // File: get pointer to the file data in memory: arg1 = const void**
 	};
 
 	enum Arg {
@@ -3,6 +3,7 @@
 // https://spdx.org/licenses/BSD-2-Clause.html
 
 #pragma once
+#include "cdefs.h"
 #include "standard_types.h"
 
 
@@ -9,7 +9,9 @@
 #include "Trace.h"
 #include "cdefs.h"
 #include "cstrings.h"
-#include <pico/stdio.h>
+#if !defined MAKE_TOOLS || !MAKE_TOOLS
+  #include <pico/stdio.h>
+#endif
 #include <utility>
 
 namespace kio ::Devices
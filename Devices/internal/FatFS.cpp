@@ -13,7 +13,9 @@
 #include "devices_types.h"
 #include "ff15/source/diskio.h"
 #include "ff15/source/ffconf.h"
-#include <pico/stdio.h>
+#if !defined MAKE_TOOLS || !MAKE_TOOLS
+  #include <pico/stdio.h>
+#endif
 
 // volume names as required by FatFS:
 constexpr char NoDevice[]			 = "";
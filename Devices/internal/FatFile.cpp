@@ -59,10 +59,52 @@ uint32 FatFile::ioctl(IoCtl cmd, void* arg1, void* arg2)
 	}
 }
 
+uint FatFile::enableFastSeek(uint32* buffer, uint count)
+{
+	// build the cluster link map table:
+	// if no buffer is supplied, then first get the required size with a minimal table.
+
+	trace(__func__);
+	static_assert(sizeof(DWORD) == sizeof(uint32));
+
+	disableFastSeek();
+
+	if (!buffer)
+	{
+		DWORD probe[4] = {NELEM(probe)};
+		fatfile.cltbl  = probe;
+		FRESULT err	   = f_lseek(&fatfile, CREATE_LINKMAP);
+		fatfile.cltbl  = nullptr;
+		if (err && err != FR_NOT_ENOUGH_CORE) throw tostr(err);
+
+		count  = probe[0];
+		clmt   = std::unique_ptr<DWORD[]>(new DWORD[count]);
+		buffer = clmt.get();
+	}
+
+	if (count < 2) throw INVALID_ARGUMENT;
+	buffer[0]	  = count;
+	fatfile.cltbl = buffer;
+	FRESULT err	  = f_lseek(&fatfile, CREATE_LINKMAP);
+	if (err)
+	{
+		disableFastSeek();
+		throw err == FR_NOT_ENOUGH_CORE ? "FatFile: CLMT buffer too small" : tostr(err);
+	}
+	return buffer[0];
+}
+
+void FatFile::disableFastSeek() noexcept
+{
+	fatfile.cltbl = nullptr;
+	clmt.reset();
+}
+
 void FatFile::truncate()
 {
 	trace(__func__);
 
+	disableFastSeek();
 	FRESULT err = f_truncate(&fatfile);
 	if (err) throw tostr(err);
 }
@@ -87,6 +129,8 @@ SIZE FatFile::write(const void* data, SIZE size, bool partial)
 {
 	trace(__func__);
 
+	if (fatfile.cltbl && f_tell(&fatfile) + size > f_size(&fatfile)) disableFastSeek();
+
 	SIZE	count = 0;
 	FRESULT err	  = f_write(&fatfile, data, size, &count);
 	if unlikely (err) throw tostr(err);
@@ -119,6 +163,8 @@ void FatFile::putc(char c)
 {
 	trace(__func__);
 
+	if (fatfile.cltbl && f_tell(&fatfile) >= f_size(&fatfile)) disableFastSeek();
+
 	SIZE	count = 0;
 	FRESULT err	  = f_write(&fatfile, &c, 1, &count);
 	if unlikely (err) throw tostr(err);
@@ -152,6 +198,7 @@ void FatFile::setFpos(ADDR addr)
 	trace(__func__);
 
 	clear_eof_pending();
+	if (fatfile.cltbl && addr > f_size(&fatfile)) disableFastSeek(); // expand file
 	FRESULT err = f_lseek(&fatfile, addr);
 	if (err) throw tostr(err);
 }
@@ -164,6 +211,7 @@ void FatFile::close()
 
 	trace(__func__);
 
+	disableFastSeek();
 	FRESULT err = f_close(&fatfile);
 	device		= nullptr;
 	if (err) throw tostr(err);
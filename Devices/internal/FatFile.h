@@ -6,6 +6,7 @@
 
 #include "File.h"
 #include "ff15/source/ff.h"
+#include <memory>
 
 namespace kio::Devices
 {
@@ -39,9 +40,22 @@ public:
 	virtual void close() override;
 	virtual void truncate() override;
 
+	/*	Enable fast seek for random access in large files.
+		This builds a cluster link map table (CLMT) so that setFpos() no longer follows the FAT chain
+		from the start of the file. The table needs 2 entries per fragment of the file + 1.
+		If no buffer is supplied then a buffer of the required size is allocated.
+		A supplied buffer must stay valid until fast seek is disabled or the file is closed.
+		Fast seek is disabled automatically if the file is expanded or truncated.
+		@return number of table entries used
+	*/
+	uint enableFastSeek(uint32* buffer = nullptr, uint count = 0) throws;
+	void disableFastSeek() noexcept;
+	bool isFastSeekEnabled() const noexcept { return fatfile.cltbl != nullptr; }
+
 private:
-	FatFSPtr device; // keep alive
-	FIL		 fatfile;
+	FatFSPtr				 device; // keep alive
+	FIL						 fatfile;
+	std::unique_ptr<DWORD[]> clmt; // allocated by enableFastSeek()
 
 	FatFile(FatFSPtr device, cstr path, FileOpenMode mode);
 	friend class FatDir;
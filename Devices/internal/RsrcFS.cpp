@@ -35,7 +35,7 @@ inline uint32 peek24(cuint8* p)
 
 inline bool is_compressed(cuptr p) { return p[3] & 0x80; }
 
-inline uint32 usize(cuptr p) { return peek32(p) & 0x7fffffff; }
+inline uint32 usize(cuptr p) { return peek32(p) & 0x3fffffff; }
 
 inline uint32 csize(cuptr p)
 {
@@ -72,6 +72,90 @@ static const uint8* next_direntry(cuptr p, cstr pattern)
 }
 
 
+// ***********************************************************************
+// Index
+
+static constexpr char index_name[] = "\x01index";
+
+inline bool has_index(cuptr data)
+{
+	return data && memcmp(data, index_name, sizeof(index_name)) == 0;
+}
+
+static cuptr first_direntry(cuptr data)
+{
+	// get first file, skipping the index
+
+	cuptr p = data;
+	if (p && has_index(data)) p = next_direntry(p);
+	return p && *p ? p : nullptr;
+}
+
+static int lccmp(cstr a, cstr b, uint maxlen = ~0u)
+{
+	// compare strings, case-insensitive, same as in the RsrcFileWriter
+
+	for (; maxlen; maxlen--)
+	{
+		uchar c = uchar(to_lower(*a++));
+		uchar d = uchar(to_lower(*b++));
+		if (c != d) return c < d ? -1 : 1;
+		if (c == 0) return 0;
+	}
+	return 0;
+}
+
+static cuptr find_in_index(cuptr data, cstr name, bool is_prefix)
+{
+	// binary search for the first file name >= name
+	// returns the entry if it's name is equal to `name` or starts with `name` if is_prefix.
+	// names which differ only in case are sorted case-sensitively:
+	// if there are multiple matches then prefer the one with the same case, else return the first one.
+
+	cuptr  p	   = skip(data); // -> size
+	uint32 count   = peek32(p + 4);
+	cuptr  offsets = p + 8;
+
+	auto entry = [=](uint i) { return data + peek32(offsets + i * 4); };
+
+	uint a = 0, e = count;
+	while (a < e)
+	{
+		uint i = (a + e) / 2;
+		if (lccmp(cptr(entry(i)), name) < 0) a = i + 1;
+		else e = i;
+	}
+	if (a == count) return nullptr;
+
+	if (is_prefix) return lccmp(cptr(entry(a)), name, strlen(name)) == 0 ? entry(a) : nullptr;
+	if (lccmp(cptr(entry(a)), name) != 0) return nullptr;
+
+	for (uint i = a; i < count && lccmp(cptr(entry(i)), name) == 0; i++)
+	{
+		if (strcmp(cptr(entry(i)), name) == 0) return entry(i);
+	}
+	return entry(a);
+}
+
+static cuptr find_file(cuptr data, cstr path)
+{
+	// find file with exact name. wildcards are allowed.
+
+	bool has_wildcards = strpbrk(path, "*?") != nullptr;
+	if (has_index(data) && !has_wildcards) return find_in_index(data, path, false);
+	else return next_direntry(first_direntry(data), path);
+}
+
+static cuptr find_file_in_dir(cuptr data, cstr path)
+{
+	// find the first file in directory
+
+	bool has_wildcards = strpbrk(path, "*?") != nullptr;
+	if (has_index(data) && !has_wildcards) return find_in_index(data, *path ? catstr(path, "/") : path, true);
+	else return next_direntry(first_direntry(data), *path ? catstr(path, "/*") : "*");
+}
+
+
 // ***********************************************************************
 // Resource File System
 
@@ -81,10 +165,10 @@ uint64 RsrcFS::getSize()
 
 	trace(__func__);
 
-	if (!resource_file_data) return 0;
-	cuptr p = resource_file_data;
+	if (!data) return 0;
+	cuptr p = data;
 	while (*p) { p = next_entry(p); }
-	return uint(p - resource_file_data);
+	return uint(p - data);
 }
 
 DirectoryPtr RsrcFS::openDir(cstr path)
@@ -94,9 +178,8 @@ DirectoryPtr RsrcFS::openDir(cstr path)
 
 	cstr full_path = makeFullPath(path);
 
-	path		 = strchr(full_path, ':') + 2;
-	cstr pattern = *path == 0 ? "*" : catstr(path, "/*");
-	if (next_direntry(resource_file_data, pattern)) return new RsrcDir(this, full_path);
+	path = strchr(full_path, ':') + 2;
+	if (find_file_in_dir(data, path)) return new RsrcDir(this, full_path);
 	else throw DIRECTORY_NOT_FOUND;
 }
 
@@ -119,7 +202,7 @@ FilePtr RsrcFS::openFile(cstr path, FileOpenMode mode)
 
 	path = strchr(makeFullPath(path), ':') + 2;
 	if (mode & ~READ) throw NOT_WRITABLE;
-	cuint8* p = next_direntry(resource_file_data, path);
+	cuint8* p = find_file(data, path);
 	if (!p) throw FILE_NOT_FOUND;
 
 	p = skip(p);
@@ -133,11 +216,25 @@ ADDR RsrcFS::getFileSize(cstr path) throws
 	assert(path);
 
 	path	  = strchr(makeFullPath(path), ':') + 2;
-	cuint8* p = next_direntry(resource_file_data, path);
+	cuint8* p = find_file(data, path);
 	if (!p) throw FILE_NOT_FOUND;
 	return usize(skip(p));
 }
 
+const uint8* RsrcFS::getData(cstr path, uint32* size) throws
+{
+	trace(__func__);
+	assert(path);
+
+	path	  = strchr(makeFullPath(path), ':') + 2;
+	cuint8* p = find_file(data, path);
+	if (!p) throw FILE_NOT_FOUND;
+
+	p = skip(p);
+	if (size) *size = usize(p);
+	return is_compressed(p) ? nullptr : p + 4;
+}
+
 
 FileType RsrcFS::getFileType(cstr path) noexcept
 {
@@ -146,8 +243,8 @@ FileType RsrcFS::getFileType(cstr path) noexcept
 
 	path = strchr(makeFullPath(path), ':') + 2;
 	if (*path == 0) return FileType::DirectoryFile; // root dir
-	if (next_direntry(resource_file_data, path)) return FileType::RegularFile;
-	if (next_direntry(resource_file_data, catstr(path, "/*"))) return FileType::DirectoryFile;
+	if (find_file(data, path)) return FileType::RegularFile;
+	if (find_file_in_dir(data, path)) return FileType::DirectoryFile;
 	else return FileType::NoFile;
 }
 
@@ -156,14 +253,15 @@ FileType RsrcFS::getFileType(cstr path) noexcept
 // Resource Directory
 
 RsrcDir::RsrcDir(RCPtr<RsrcFS> fs, cstr full_path) : //
-	Directory(std::move(fs), full_path),
-	dpos(resource_file_data)
+	Directory(fs, full_path),
+	data(fs->data),
+	dpos(first_direntry(data))
 {}
 
 void RsrcDir::rewind() throws
 {
 	trace(__func__);
-	dpos = resource_file_data;
+	dpos = first_direntry(data);
 	subdirs.purge();
 }
 
@@ -23,11 +23,23 @@ namespace kio::Devices
 
 	compressed[] =
 	  char[] filename   0-terminated string
-	  uint32 size       uncompressed data size | 0x80000000
-	  uint24 csize      sizeof cdata[]
+	  uint32 size       uncompressed data size | 0x80000000 | (checkpoints ? 0x40000000 : 0)
+	  uint24 csize      sizeof cdata[] incl. checkpoint table, see HeatShrinkEncoder
 	  uint8  flags		wbits<<4 + lbits
 	  char[] data       compressed file data
 
+	index[] =			optional. if present then it is the first entry. added in 2025.
+	  char[] "\x01index" 0-terminated string
+	  uint32 size       sizeof data[]
+	  uint32 count      number of files
+	  uint32 offset[]   offsets of the files from resource_file_data[]
+						sorted by filename, case-insensitive, compared with to_lower().
+						names which differ only in case are sorted case-sensitively.
+
+	The index is stored like an uncompressed file, so the linear format remains valid.
+	If the index is present then files and directories are found with a binary search,
+	else the entries are searched linearly.
+
 ALT uncompressed[] =
 	  char[] filename   0-terminated string
 	  uint24 size       data size (after flag)
@@ -45,7 +57,8 @@ ALT	compressed[] =
 class RsrcFS final : public FileSystem
 {
 public:
-	RsrcFS(cstr name = "rsrc") throws : FileSystem(name) {}
+	// data: the resource file data, normally the resource_file_data[] created by the RsrcFileWriter.
+	RsrcFS(cstr name = "rsrc", const uint8* data = resource_file_data) throws : FileSystem(name), data(data) {}
 
 	virtual uint64		 getFree() override { return 0; }
 	virtual uint64		 getSize() override;
@@ -59,6 +72,15 @@ public:
 	virtual void	 setFmode(cstr, FileMode, uint8) throws override { throw NOT_WRITABLE; }
 	virtual void	 setMtime(cstr, uint32) throws override { throw NOT_WRITABLE; }
 	virtual ADDR	 getFileSize(cstr path) throws override;
+
+	// get pointer to the data of an uncompressed file in flash and store it's size in `size`.
+	// the data is not copied. there is no alignment: the data starts right after the file's header.
+	// returns nullptr if the file is compressed. throws FILE_NOT_FOUND.
+	const uint8* getData(cstr path, uint32* size = nullptr) throws;
+
+private:
+	friend class RsrcDir;
+	const uint8* data;
 };
 
 
@@ -69,6 +91,7 @@ public:
 	virtual FileInfo next(cstr pattern = nullptr) throws override;
 
 private:
+	cuptr		data;
 	cuptr		dpos = nullptr;
 	Array<cstr> subdirs; // so far returned by next()
 
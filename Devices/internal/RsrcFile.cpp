@@ -15,6 +15,19 @@ RsrcFile::RsrcFile(const uchar* data, uint32 size) : //
 	fsize(size)
 {}
 
+uint32 RsrcFile::ioctl(IoCtl cmd, void* arg1, void* arg2)
+{
+	// CTRL_MMAP: the data is directly accessible in flash or rom
+
+	if (cmd.cmd == IoCtl::CTRL_MMAP)
+	{
+		assert(arg1);
+		*reinterpret_cast<const void**>(arg1) = data;
+		return fsize;
+	}
+	return File::ioctl(cmd, arg1, arg2);
+}
+
 void RsrcFile::setFpos(ADDR new_fpos)
 {
 	clear_eof_pending();
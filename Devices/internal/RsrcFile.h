@@ -13,17 +13,19 @@ namespace kio::Devices
 	class RsrcFile reads from data in Flash or Rom.
 	compressed files are wrapped in a HeatShrinkDecoder by the RsrcFS,
 	so you always get the uncompressed data.
+	uncompressed files can be memory-mapped with File::mmap().
 */
 class RsrcFile final : public File
 {
 public:
 	~RsrcFile() noexcept override = default;
 
-	virtual ADDR getSize() const noexcept override { return fsize; }
-	virtual ADDR getFpos() const noexcept override { return fpos; }
-	virtual void setFpos(ADDR) override;
-	virtual SIZE read(void* data, SIZE, bool partial = false) override;
-	virtual void close() override {}
+	virtual uint32 ioctl(IoCtl cmd, void* arg1 = nullptr, void* arg2 = nullptr) override;
+	virtual ADDR   getSize() const noexcept override { return fsize; }
+	virtual ADDR   getFpos() const noexcept override { return fpos; }
+	virtual void   setFpos(ADDR) override;
+	virtual SIZE   read(void* data, SIZE, bool partial = false) override;
+	virtual void   close() override {}
 
 private:
 	const uint8* data  = nullptr;
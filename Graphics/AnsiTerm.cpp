@@ -270,6 +270,7 @@ void AnsiTerm::apply_margins() noexcept
 			b = b * display->CHAR_HEIGHT;
 
 			display->hideCursor();
+			full_pixmap->resetFirstRow(); // undo fast scrolling: the window uses physical rows
 			CanvasPtr partial_pixmap = full_pixmap->cloneWindow(l, t, r - l, b - t);
 			display					 = new TextVDU(partial_pixmap);
 		}
@@ -1959,6 +1960,23 @@ inline void AnsiTerm::print_char(char c)
 	else if (!auto_wrap) display->limitCursorPosition();
 }
 
+void AnsiTerm::print_run(cptr s, uint n)
+{
+	// print a run of printable ascii chars.
+	// same as print_char() for each char: note that showCursor() wraps the cursor position even if !auto_wrap.
+	// in insert mode or with a hidden cursor and no auto wrap the chars are printed one by one.
+
+	wcnt = 0;
+	if unlikely (insert_mode || (!cursor_visible && !auto_wrap))
+	{
+		while (n--) print_char(*s++);
+		return;
+	}
+
+	display->printRun(s, int(n));
+	if (cursor_visible) display->showCursor();
+}
+
 void AnsiTerm::handle_Utf8ArgsPending(char c)
 {
 	wbu[wcnt++] = uchar(c);
@@ -2082,18 +2100,33 @@ void AnsiTerm::putc(char c)
 	log_rbu();
 }
 
+static inline bool is_printable_ascii(char c) { return uchar(c) >= 0x20 && uchar(c) <= 0x7f; }
+
 uint AnsiTerm::write(const char* text, uint size)
 {
-	for (uint i = 0; i < size; i++) { putc(text[i]); }
+	// runs of printable ascii chars are printed with one call to print_run().
+	// all other chars are handled by putc().
+
+	cptr p = text;
+	cptr e = text + size;
+
+	while (p < e)
+	{
+		if (wstate == NothingPending && is_printable_ascii(*p))
+		{
+			cptr a = p;
+			while (++p < e && is_printable_ascii(*p)) {}
+			print_run(a, uint(p - a));
+		}
+		else putc(*p++);
+	}
 	return size;
 }
 
 uint AnsiTerm::puts(cstr s)
 {
 	if unlikely (!s) return 0;
-	cptr s0 = s;
-	while (*s) { putc(*s++); }
-	return uint(s - s0);
+	return write(s, uint(strlen(s)));
 }
 
 uint AnsiTerm::printf(cstr fmt, va_list va)
@@ -204,6 +204,7 @@ private:
 	int	 next_tab(int col) noexcept;
 	int	 prev_tab(int col) noexcept;
 	void print_char(char);
+	void print_run(cptr, uint);
 	void put_csi_response(cstr fmt, ...) __printflike(2, 3);
 };
 
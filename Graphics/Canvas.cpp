@@ -4,6 +4,7 @@
 
 #include "Canvas.h"
 #include "fixint.h"
+#include <memory>
 
 
 namespace kio::Graphics
@@ -184,6 +185,54 @@ void Canvas::copyRect(coord zx, coord zy, coord qx, coord qy, coord w, coord h)
 	}
 }
 
+void Canvas::resetFirstRow() noexcept
+{
+	// rotate rows so that row first_row becomes row 0.
+	// the rows are rotated in gcd(height, first_row) cycles:
+	// the first row of each cycle is saved pixel by pixel, all other rows are moved with copyRect().
+	// attribute modes: copyRect() needs whole attribute cells, so the rows are rotated in blocks of attrheight rows.
+	// if first_row or height is not a multiple of attrheight then all rows must be moved pixel by pixel.
+
+	int k = first_row;
+	if (k == 0) return;
+
+	coord n		   = 1; // rows per block
+	bool  by_pixel = false;
+	if (is_attribute_mode(colormode))
+	{
+		if (k % attrheight == 0 && height % attrheight == 0) n = attrheight;
+		else by_pixel = true;
+	}
+
+	std::unique_ptr<uint[]> colors {new uint[uint(width * n)]};
+	std::unique_ptr<uint[]> inks {new uint[uint(width * n)]};
+
+	for (coord start = 0, moved = 0; moved < height; start += n)
+	{
+		for (coord i = 0; i < width * n; i++) { colors[i] = get_pixel(i % width, start + i / width, &inks[i]); }
+
+		coord y = start;
+		for (;;)
+		{
+			coord q = y + k < height ? y + k : y + k - height;
+			moved += n;
+			if (q == start) break;
+			if (!by_pixel) copyRect(0, y, 0, q, width, n);
+			else
+				for (coord x = 0; x < width; x++)
+				{
+					uint ink, color = get_pixel(x, q, &ink);
+					set_pixel(x, y, color, ink);
+				}
+			y = q;
+		}
+
+		for (coord i = 0; i < width * n; i++) { set_pixel(i % width, y + i / width, colors[i], inks[i]); }
+	}
+
+	first_row = 0;
+}
+
 void Canvas::draw_hline_bmp(coord x, coord y, coord w, const uint8* q, uint color, uint ink) noexcept
 {
 	// helper:
@@ -58,6 +58,12 @@ public:
 	const bool		 allocated; // whether pixmap[] was allocated and will be deleted in dtor
 	char			 padding = 0;
 
+	// wrap-around start row for the FrameBuffer:
+	// the FrameBuffer displays rows [first_row .. height[ followed by rows [0 .. first_row[.
+	// this allows to scroll the whole screen by changing first_row and clearing the new rows.
+	// all drawing functions still use the physical row in pixmap[].
+	coord first_row = 0;
+
 	ColorDepth colordepth() const noexcept { return get_colordepth(colormode); } // log2 of bits per color in attr[]
 	AttrMode   attrmode() const noexcept { return get_attrmode(colormode); }	 // log2 of bits per color in pixmap[]
 	AttrWidth  attrwidth() const noexcept { return get_attrwidth(colormode); }	 // log2 of width of attribute cells
@@ -122,6 +128,13 @@ public:
 	virtual void copyRect(coord zx, coord zy, coord qx, coord qy, coord w, coord h) noexcept;
 	virtual void copyRect(coord zx, coord zy, const Canvas& src, coord qx, coord qy, coord w, coord h) noexcept;
 
+	/* _______________________________________________________________________________________
+	   rotate the rows in pixmap[] so that first_row can be reset to 0 without changing the displayed image.
+		- must be called before windows are created, because windows use the physical rows.
+		- the default implementation moves pixel by pixel.
+	*/
+	virtual void resetFirstRow() noexcept;
+
 	/* _______________________________________________________________________________________
 	   copy bitmaps:
 	   - drawBmp():  draw rectangular area from bitmap: set `1` bits with color, skip `0` bits
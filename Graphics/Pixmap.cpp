@@ -3,6 +3,9 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "Pixmap.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
 
 
 namespace kio::Graphics
@@ -110,6 +113,48 @@ void DirectColorPixmap::copyRect(coord zx, coord zy, const Canvas& q, coord qx,
 	copyRect(zx, zy, static_cast<const Pixmap&>(q), qx, qy, w, h);
 }
 
+template<ColorMode CM>
+void DirectColorPixmap::resetFirstRow() noexcept
+{
+	// the rows of an allocated pixmap are contiguous in memory.
+	// the rows of a window are rotated row by row in gcd(height, first_row) cycles,
+	// except if the last byte of a row is shared with pixels outside the window.
+
+	int k = first_row;
+	if (k == 0) return;
+
+	if (allocated)
+	{
+		std::rotate(pixmap, pixmap + k * row_offset, pixmap + height * row_offset);
+		first_row = 0;
+		return;
+	}
+
+	if ((width << CD) % 8) return Canvas::resetFirstRow();
+
+	uint					 row_size = uint(width << CD) / 8;
+	std::unique_ptr<uint8[]> buffer {new uint8[row_size]};
+
+	for (coord start = 0, moved = 0; moved < height; start++)
+	{
+		memcpy(buffer.get(), pixmap + start * row_offset, row_size);
+
+		coord y = start;
+		for (;;)
+		{
+			coord q = y + k < height ? y + k : y + k - height;
+			moved++;
+			if (q == start) break;
+			memcpy(pixmap + y * row_offset, pixmap + q * row_offset, row_size);
+			y = q;
+		}
+
+		memcpy(pixmap + y * row_offset, buffer.get(), row_size);
+	}
+
+	first_row = 0;
+}
+
 template<ColorMode CM>
 void DirectColorPixmap::copyRect(const Point& z, const Pixmap& q) noexcept
 {
@@ -81,6 +81,11 @@ public:
 	constexpr Pixmap(const Size& size, uint8* pixels, int row_offset) noexcept;
 	constexpr Pixmap(coord w, coord h, uint8* pixels, int row_offset) noexcept;
 
+	// not allocating: wrap read-only pixels, e.g. memory-mapped from a resource file in flash.
+	// the pixmap must not be drawn into: use it as a source e.g. for copyRect().
+	constexpr Pixmap(const Size& size, const uint8* pixels, int row_offset) noexcept;
+	constexpr Pixmap(coord w, coord h, const uint8* pixels, int row_offset) noexcept;
+
 	// window into other pixmap:
 	Pixmap(Pixmap& q, const Rect& r) noexcept;
 	Pixmap(Pixmap& q, const Point& p, const Size& size) noexcept;
@@ -117,6 +122,7 @@ public:
 	//virtual void clear(uint color) noexcept override;
 	virtual void copyRect(coord x, coord y, coord qx, coord qy, coord w, coord h) noexcept override;
 	virtual void copyRect(coord x, coord y, const Canvas& q, coord qx, coord qy, coord w, coord h) noexcept override;
+	virtual void resetFirstRow() noexcept override;
 	//virtual void readBmp(coord x, coord y, uint8*, int roffs, coord w, coord h, uint c, uint = 0) noexcept override;
 	virtual void drawBmp(coord x, coord y, const uint8*, int ro, coord w, coord h, uint c, uint = 0) noexcept override;
 	virtual void drawChar(coord x, coord y, const uint8* bmp, coord h, uint color, uint ink = 0) noexcept override;
@@ -200,6 +206,17 @@ constexpr DirectColorPixmap::Pixmap(const Size& sz, uint8* pixels, int row_offse
 	Pixmap(sz.width, sz.height, CM, attrheight_none, pixels, row_offset)
 {}
 
+// not allocating: wrap read-only pixels:
+template<ColorMode CM>
+constexpr DirectColorPixmap::Pixmap(coord w, coord h, const uint8* pixels, int row_offset) noexcept :
+	Pixmap(w, h, CM, attrheight_none, const_cast<uint8*>(pixels), row_offset)
+{}
+
+template<ColorMode CM>
+constexpr DirectColorPixmap::Pixmap(const Size& sz, const uint8* pixels, int row_offset) noexcept :
+	Pixmap(sz.width, sz.height, CM, attrheight_none, const_cast<uint8*>(pixels), row_offset)
+{}
+
 // window into other pixmap:
 template<ColorMode CM>
 DirectColorPixmap::Pixmap(Pixmap& q, coord x, coord y, coord w, coord h) noexcept :
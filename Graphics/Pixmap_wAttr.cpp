@@ -44,6 +44,21 @@ void AttrModePixmap::clear(uint color) noexcept
 	super::fill_rect(0, 0, width, height, 0); // all pixels: ink := 0
 }
 
+template<ColorMode CM>
+void AttrModePixmap::resetFirstRow() noexcept
+{
+	// the attributes can be rotated in memory too if first_row is a multiple of the attribute cell height.
+	// else the rows must be moved pixel by pixel to update the attributes.
+	// the pixels of a window can only be rotated in memory if it's rows don't share a byte with other pixels.
+
+	if (first_row % attrheight || height % attrheight) return Canvas::resetFirstRow();
+	if (!allocated && (width << super::CD) % 8) return Canvas::resetFirstRow();
+
+	attributes.first_row = first_row / attrheight;
+	attributes.resetFirstRow();
+	super::resetFirstRow();
+}
+
 template<ColorMode CM>
 void AttrModePixmap::xorRect(coord x1, coord y1, coord w, coord h, uint color) noexcept
 {
@@ -35,7 +35,9 @@ public:
 	static constexpr int		pixel_per_attr	= 1 << AW;
 
 	using super = Pixmap<ColorMode(AM)>;
+	using Canvas::allocated;
 	using Canvas::attrheight;
+	using Canvas::first_row;
 	using Canvas::height;
 	using Canvas::size;
 	using Canvas::width;
@@ -105,6 +107,7 @@ public:
 	virtual void clear(uint color) noexcept override;
 	virtual void copyRect(coord x, coord y, coord qx, coord qy, coord w, coord h) noexcept override;
 	virtual void copyRect(coord x, coord y, const Canvas& q, coord qx, coord qy, coord w, coord h) noexcept override;
+	virtual void resetFirstRow() noexcept override;
 	//virtual void readBmp(coord x, coord y, uint8*, int roffs, coord w, coord h, uint c, uint = 0) noexcept override;
 	virtual void drawBmp(coord x, coord y, const uint8*, int ro, coord w, coord h, uint c, uint ink) noexcept override;
 	virtual void drawChar(coord x, coord y, const uint8* bmp, coord h, uint color, uint ink) noexcept override;
@@ -49,12 +49,35 @@ TextVDU::TextVDU(CanvasPtr _pixmap) noexcept :
 	bits_per_color(uint8(1 << colordepth)), // bits per color in pixmap[] or attributes[]
 	bits_per_pixel(is_attribute_mode(colormode) ? uint8(1 << attrmode) : bits_per_color), // bpp in pixmap[]
 	cols(pixmap->width / CHAR_WIDTH),
-	rows(pixmap->height / CHAR_HEIGHT)
+	rows(pixmap->height / CHAR_HEIGHT),
+	fast_scroll(pixmap->allocated && pixmap->height == rows * CHAR_HEIGHT)
 {
 	cursorVisible = false;
+	if (fast_scroll) set_top_row(top_row());
+	setGlyphCacheSize(default_glyph_cache_size);
 	reset();
 }
 
+void TextVDU::setGlyphCacheSize(uint n) noexcept
+{
+	// set size of the glyph cache and clear it.
+	// max. 256 glyphs. if the cache can't be allocated then there is no cache.
+
+	// the cache and the slot table are only allocated if the cache is enabled.
+
+	n = min(n, 256u);
+	glyph_cache.reset(n ? new (std::nothrow) CachedGlyph[n] : nullptr);
+	glyph_cache_slot.reset(glyph_cache ? new (std::nothrow) uint8[256] : nullptr);
+	if (!glyph_cache_slot) glyph_cache.reset();
+	else memset(glyph_cache_slot.get(), 0, 256);
+
+	glyph_cache_size   = glyph_cache ? n : 0;
+	glyph_cache_count  = 0;
+	glyph_cache_clock  = 0;
+	glyph_cache_hits   = 0;
+	glyph_cache_misses = 0;
+}
+
 void TextVDU::reset() noexcept
 {
 	// all settings = default, home cursor
@@ -84,6 +107,7 @@ void TextVDU::cls() noexcept
 	cursorVisible = false;
 
 	pixmap->clear(bgcolor);
+	if (fast_scroll) set_top_row(0);
 }
 
 void TextVDU::identify() noexcept
@@ -109,7 +133,7 @@ void TextVDU::show_cursor(bool show) noexcept
 		if (cursorXorColor == 0) cursorXorColor = ~0u;
 	}
 
-	pixmap->xorRect(col * CHAR_WIDTH, row * CHAR_HEIGHT, CHAR_WIDTH, CHAR_HEIGHT, cursorXorColor);
+	pixmap->xorRect(col * CHAR_WIDTH, screen_y(row), CHAR_WIDTH, CHAR_HEIGHT, cursorXorColor);
 	cursorVisible = show;
 }
 
@@ -308,8 +332,16 @@ void TextVDU::clearRect(int row, int col, int rows, int cols) noexcept
 	if (rows > 0 && cols > 0)
 	{
 		int x = col * CHAR_WIDTH;
-		int y = row * CHAR_HEIGHT;
-		pixmap->fillRect(Rect(x, y, cols * CHAR_WIDTH, rows * CHAR_HEIGHT), bgcolor, bg_ink);
+		int w = cols * CHAR_WIDTH;
+
+		if (top_row() == 0) { pixmap->fillRect(Rect(x, row * CHAR_HEIGHT, w, rows * CHAR_HEIGHT), bgcolor, bg_ink); }
+		else // the area may wrap around the bottom of the pixmap:
+		{
+			int y = screen_y(row);
+			int n = min(rows, this->rows - y / CHAR_HEIGHT);
+			pixmap->fillRect(Rect(x, y, w, n * CHAR_HEIGHT), bgcolor, bg_ink);
+			if (rows > n) pixmap->fillRect(Rect(x, 0, w, (rows - n) * CHAR_HEIGHT), bgcolor, bg_ink);
+		}
 	}
 }
 
@@ -409,9 +441,24 @@ void TextVDU::copyRect(int dest_row, int dest_col, int src_row, int src_col, int
 
 	if (rows > 0 && cols > 0)
 	{
-		pixmap->copyRect(
-			dest_col * CHAR_WIDTH, dest_row * CHAR_HEIGHT, src_col * CHAR_WIDTH, src_row * CHAR_HEIGHT,
-			cols * CHAR_WIDTH, rows * CHAR_HEIGHT);
+		int zx = dest_col * CHAR_WIDTH;
+		int qx = src_col * CHAR_WIDTH;
+		int w  = cols * CHAR_WIDTH;
+
+		if (top_row() == 0)
+		{
+			pixmap->copyRect(zx, dest_row * CHAR_HEIGHT, qx, src_row * CHAR_HEIGHT, w, rows * CHAR_HEIGHT);
+		}
+		else if (dest_row <= src_row) // source and dest may wrap around: copy row by row
+		{
+			for (int i = 0; i < rows; i++)
+				pixmap->copyRect(zx, screen_y(dest_row + i), qx, screen_y(src_row + i), w, CHAR_HEIGHT);
+		}
+		else
+		{
+			for (int i = rows; --i >= 0;)
+				pixmap->copyRect(zx, screen_y(dest_row + i), qx, screen_y(src_row + i), w, CHAR_HEIGHT);
+		}
 	}
 }
 
@@ -422,6 +469,17 @@ void TextVDU::scrollScreen(int dy /*chars*/, int dx /*chars*/) noexcept
 
 	if (w <= 0 || h <= 0) return clearRect(0, 0, rows, cols);
 
+	if (fast_scroll && dx == 0) // vertical scrolling of the whole screen: move the display origin
+	{
+		hideCursor();
+		int top = top_row() - dy;
+		set_top_row(top < 0 ? top + rows : top >= rows ? top - rows : top);
+
+		if (dy > 0) clearRect(0, 0, +dy, cols);
+		if (dy < 0) clearRect(h, 0, -dy, cols);
+		return;
+	}
+
 	coord qx = dx >= 0 ? 0 : -dx;
 	coord zx = dx >= 0 ? +dx : 0;
 	coord qy = dy >= 0 ? 0 : -dy;
@@ -435,6 +493,13 @@ void TextVDU::scrollScreen(int dy /*chars*/, int dx /*chars*/) noexcept
 	if (dy < 0) clearRect(h, 0, -dy, cols);
 }
 
+void TextVDU::set_top_row(int row) noexcept
+{
+	// set the text row which is displayed at the top of the screen
+
+	pixmap->first_row = row * CHAR_HEIGHT;
+}
+
 void TextVDU::setAttributes(uint add, uint remove) noexcept
 {
 	attributes = Attributes((attributes & ~remove) | add);
@@ -485,7 +550,7 @@ void TextVDU::readBmp(CharMatrix bmp, bool use_fgcolor) noexcept
 	assert(row >= 0 && row < rows);
 
 	int x = col++ * CHAR_WIDTH;
-	int y = row * CHAR_HEIGHT;
+	int y = screen_y(row);
 	pixmap->readBmp(x, y, bmp, 1 /*row_offset*/, CHAR_WIDTH, CHAR_HEIGHT, use_fgcolor ? fgcolor : bgcolor, use_fgcolor);
 }
 
@@ -547,7 +612,7 @@ void TextVDU::writeBmp(CharMatrix bmp, uint8 attr) noexcept
 	assert_lt(row, rows);
 
 	int x = col++ * CHAR_WIDTH;
-	int y = row * CHAR_HEIGHT;
+	int y = screen_y(row);
 
 	if (!(attr & TRANSPARENT)) pixmap->fillRect(x, y, CHAR_WIDTH, CHAR_HEIGHT, bgcolor, bg_ink);
 	static_assert(CHAR_WIDTH == 8);
@@ -676,11 +741,106 @@ void TextVDU::printCharMatrix(CharMatrix charmatrix, int count) noexcept
 	while (count--) { writeBmp(charmatrix, attributes); }
 }
 
+const uint8* TextVDU::get_glyph(char c, CharMatrix buffer) noexcept
+{
+	// get the glyph for char c with the current attributes applied.
+	// the returned glyph is in the font, in the cache or in the caller's `buffer` if there is no cache.
+	// glyphs with attributes are cached. glyph_cache_slot[c] is the slot where char c was last found,
+	// the cache is only searched if this is c with other attributes. on a miss the least recently used glyph is replaced.
+
+	constexpr uint mask = BOLD | UNDERLINE | INVERTED | ITALIC | GRAPHICS;
+	if ((attributes & mask) == 0) return systemfont256x12 + uchar(c) * CHAR_HEIGHT;
+
+	uint16 key = uint16(uchar(c) + ((attributes & mask) << 8));
+	if unlikely (glyph_cache_size == 0)
+	{
+		getCharMatrix(buffer, c);
+		applyAttributes(buffer);
+		return buffer;
+	}
+
+	CachedGlyph* cache = glyph_cache.get();
+	uint8&		 slot  = glyph_cache_slot[uchar(c)];
+	if likely (slot < glyph_cache_count && cache[slot].key == key)
+	{
+		glyph_cache_hits++;
+		cache[slot].last_used = ++glyph_cache_clock;
+		return cache[slot].glyph;
+	}
+
+	uint lru = 0;
+	for (uint i = 0; i < glyph_cache_count; i++)
+	{
+		if (cache[i].key == key)
+		{
+			glyph_cache_hits++;
+			cache[i].last_used = ++glyph_cache_clock;
+			slot			   = uint8(i);
+			return cache[i].glyph;
+		}
+		if (cache[i].last_used < cache[lru].last_used) lru = i;
+	}
+
+	glyph_cache_misses++;
+	if (glyph_cache_count < glyph_cache_size) lru = glyph_cache_count++;
+	CachedGlyph& e = cache[lru];
+	e.key		   = key;
+	e.last_used	   = ++glyph_cache_clock;
+	slot		   = uint8(lru);
+	getCharMatrix(e.glyph, c);
+	applyAttributes(e.glyph);
+	return e.glyph;
+}
+
 void TextVDU::printChar(char c, int count) noexcept
 {
-	CharMatrix charmatrix;
-	getCharMatrix(charmatrix, c);
-	printCharMatrix(charmatrix, count);
+	CharMatrix	 charmatrix;
+	const uint8* glyph = get_glyph(c, charmatrix);
+	if (glyph != charmatrix) memcpy(charmatrix, glyph, CHAR_HEIGHT);
+	while (count--) { writeBmp(charmatrix, attributes); }
+}
+
+void TextVDU::printRun(cptr s, int count) noexcept
+{
+	// print a run of printable characters with the current attributes.
+	// the glyphs are combined into one bitmap per row, max. `max_run` glyphs,
+	// which is painted with one fillRect() and one drawBmp().
+	// double width and double height are handled by printChar().
+
+	if unlikely (attributes & (DOUBLE_WIDTH | DOUBLE_HEIGHT))
+	{
+		while (count-- > 0) printChar(*s++);
+		return;
+	}
+
+	hideCursor();
+
+	while (count > 0)
+	{
+		if unlikely (col >= cols) validate_hpos(false);
+		if unlikely (uint(row) >= uint(rows)) validate_vpos();
+
+		int		   n = min(count, cols - col, max_run);
+		uint8	   bmp[CHAR_HEIGHT * max_run]; // n glyphs side by side: row_offset = n
+		CharMatrix buffer;
+
+		for (int i = 0; i < n; i++)
+		{
+			const uint8* glyph = get_glyph(s[i], buffer);
+			for (int y = 0; y < CHAR_HEIGHT; y++) bmp[y * n + i] = glyph[y];
+		}
+
+		int x = col * CHAR_WIDTH;
+		int y = screen_y(row);
+		int w = n * CHAR_WIDTH;
+
+		if (!(attributes & TRANSPARENT)) pixmap->fillRect(x, y, w, CHAR_HEIGHT, bgcolor, bg_ink);
+		pixmap->drawBmp(x, y, bmp, n, w, CHAR_HEIGHT, fgcolor, fg_ink);
+
+		col += n;
+		s += n;
+		count -= n;
+	}
 }
 
 void TextVDU::print(cstr s) noexcept
@@ -688,25 +848,31 @@ void TextVDU::print(cstr s) noexcept
 	// print printable text string.
 	// control characters: only \t and \n.
 
-	while (char c = *s++)
+	while (char c = *s)
 	{
-		if unlikely (uchar(c) < 32)
+		if likely (uchar(c) >= 32)
 		{
-			if (c == '\n')
-			{
-				newLine();
-				continue;
-			}
-			if (c == '\t')
-			{
-				cursorTab();
-				continue;
-			}
-			if (c == '\r')
-			{
-				cursorReturn();
-				continue;
-			}
+			cptr a = s;
+			while (uchar(*++s) >= 32) {}
+			printRun(a, int(s - a));
+			continue;
+		}
+
+		s++;
+		if (c == '\n')
+		{
+			newLine();
+			continue;
+		}
+		if (c == '\t')
+		{
+			cursorTab();
+			continue;
+		}
+		if (c == '\r')
+		{
+			cursorReturn();
+			continue;
 		}
 
 		CharMatrix charmatrix;
@@ -7,6 +7,7 @@
 #include "RCPtr.h"
 #include <cstdarg>
 #include <functional>
+#include <memory>
 #undef CHAR_WIDTH
 
 namespace kio::Graphics
@@ -72,8 +73,27 @@ public:
 	bool   cursorVisible;  // currently visible?
 	uint32 cursorXorColor; // value used to xor the colors
 
+	// wrap-around scrolling:
+	// if the pixmap is exactly rows*CHAR_HEIGHT high and not a window into another pixmap
+	// then scrollScreenUp() and scrollScreenDown() only set pixmap->first_row and clear the new rows.
+	// then text row `row` is at pixmap row ((row + top_row()) % rows) * CHAR_HEIGHT.
+	// the top row is not cached because multiple TextVDUs may share the pixmap, e.g. in the AnsiTerm.
+	const bool fast_scroll;
+	int		   top_row() const noexcept; // text row in pixmap[] displayed at the top of the screen
+
+	// LRU cache for glyphs with BOLD, UNDERLINE, INVERTED, ITALIC or GRAPHICS applied.
+	// glyphs without these attributes are taken directly from the font.
+	// the hit and miss counters can be used to tune the cache size.
+	// the cache is off by default: enable it with setGlyphCacheSize() if bold etc. is used a lot.
+	static constexpr uint default_glyph_cache_size = 0;
+	uint32				  glyph_cache_hits		   = 0;
+	uint32				  glyph_cache_misses	   = 0;
+
 	TextVDU(CanvasPtr) noexcept;
 
+	void setGlyphCacheSize(uint num_glyphs) noexcept; // 0 = no cache, max. 256
+	uint glyphCacheSize() const noexcept { return glyph_cache_size; }
+
 	str inputLine(std::function<int()> getchar, str oldtext = nullptr, int epos = 0);
 
 	void reset() noexcept;
@@ -87,6 +107,7 @@ public:
 	void removeAttributes(uint a = 0xff) noexcept { setAttributes(0, a); }
 	void printCharMatrix(CharMatrix, int count = 1) noexcept;
 	void printChar(char c, int count = 1) noexcept;				// no ctl
+	void printRun(cptr text, int count) noexcept;				// no ctl, fast
 	void print(cstr text) noexcept;								// supports \n and \t
 	void printf(cstr fmt, ...) noexcept __printflike(2, 3);		// supports \n and \t
 	void printf(cstr fmt, va_list) noexcept __printflike(2, 0); // supports \n and \t
@@ -135,6 +156,24 @@ public:
 	void deleteColumns(int count = 1) noexcept;
 
 private:
+	static constexpr int max_run = 32; // max. glyphs per blit in printRun()
+
+	struct CachedGlyph
+	{
+		uint16	   key;		  // char + attributes << 8
+		uint32	   last_used; // for LRU replacement
+		CharMatrix glyph;
+	};
+	std::unique_ptr<CachedGlyph[]> glyph_cache;
+	std::unique_ptr<uint8[]>	   glyph_cache_slot; // [256] where char c was last found
+	uint						   glyph_cache_size	 = 0;
+	uint						   glyph_cache_count = 0;
+	uint32						   glyph_cache_clock = 0;
+
+	const uint8* get_glyph(char c, CharMatrix buffer) noexcept; // with attributes applied
+
+	int	 screen_y(int row) const noexcept; // pixmap y of text row
+	void set_top_row(int row) noexcept;
 	void show_cursor(bool f) noexcept;
 	void validate_hpos(bool col80ok) noexcept;
 	void validate_vpos() noexcept;
@@ -145,6 +184,18 @@ private:
 // ####################### Implementations #############################
 //
 
+inline int TextVDU::top_row() const noexcept
+{
+	return fast_scroll ? pixmap->first_row / CHAR_HEIGHT : 0; //
+}
+
+inline int TextVDU::screen_y(int row) const noexcept
+{
+	row += top_row();
+	if (row >= rows) row -= rows;
+	return row * CHAR_HEIGHT;
+}
+
 inline void TextVDU::scrollScreenUp(int rows) noexcept
 {
 	if (rows > 0) scrollScreen(-rows, 0);
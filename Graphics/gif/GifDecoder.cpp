@@ -250,7 +250,10 @@ static uchar* stbi__process_gif_raster(_Context* s, _Gif* g)
 void GifDecoder::finish()
 {
 	//	Read to end of image, including the zero block.
+	//	skip the unread remainder of the current data block first.
 
+	if (position < bufsize) file->setFpos(file->getFpos() + bufsize - position);
+	position = 0;
 	while ((bufsize = file->read<uchar>())) { file->read(buf, bufsize); }
 }
 
@@ -283,9 +286,11 @@ void GifDecoder::lz_initialize()
 inline uchar GifDecoder::read_gif_byte()
 {
 	// Read the next byte from a Gif file.
+	// the data is read directly from the BufferedFile.
+	// `bufsize` is the size of the current data block and `position` the number of bytes read from it.
 
-	if unlikely (position == bufsize) // internal buffer now empty?
-	{								  // => read the next block
+	if unlikely (position == bufsize) // current block exhausted?
+	{								  // => start the next block
 		bufsize = file->read<uchar>();
 		if (bufsize == 0)
 		{
@@ -293,11 +298,11 @@ inline uchar GifDecoder::read_gif_byte()
 			file->setFpos(file->getFpos() - 1);
 			return 0;
 		}
-		file->read(buf, bufsize);
 		position = 0;
 	}
 
-	return buf[position++];
+	position++;
+	return file->read<uchar>();
 }
 
 uint GifDecoder::read_gif_code()
@@ -514,10 +519,11 @@ static void merge_cmaps(Color* z, uint16& zcnt, uint zmax, const Color* q, uint
 	}
 }
 
-GifDecoder::GifDecoder(FilePtr file) : file(file)
+GifDecoder::GifDecoder(FilePtr _file)
 {
 	debugstr("GifDecode:ctor\n");
-	if (!file) return; // isa_gif_file=false
+	if (!_file) return; // isa_gif_file=false
+	file = new Devices::BufferedFile(_file);
 
 	char bu[7] = "      ";
 	file->read(bu, 6);
@@ -561,7 +567,133 @@ GifDecoder::~GifDecoder()
 	delete[] prefix;
 }
 
-int GifDecoder::decode_frame(store_scanline& fu)
+/*	Stores for decode_frame_with():
+
+	start_image(index_map, transp): called before the rows of each image are decoded.
+		index_map:	maps the local color indexes to global_cmap[], or nullptr if there is no local cmap.
+		transp:		the local index of the transparent color, or -1.
+	row(x, y, w):	return address in the destination where the LZW decoder can write the color indexes directly,
+					or nullptr: then the row is decoded into a buffer and store() is called.
+	store(x, y, w, pixels):	store a row of local color indexes. pixels[] may be modified.
+	clear(x, y, w, h, color): clear area to global color index `color` for the disposal method.
+*/
+
+struct GifFunctionStore
+{
+	// store the scanlines with a std::function.
+	// the pixels are mapped to global_cmap[] before they are passed to the function.
+
+	store_scanline& fu;
+	Color*			cmap;
+	const uint8*	index_map = nullptr;
+	int				transp	  = -1;
+
+	GifFunctionStore(store_scanline& fu, Color* cmap) noexcept : fu(fu), cmap(cmap) {}
+
+	void start_image(const uint8* map, int transp_index) noexcept
+	{
+		index_map = map;
+		transp	  = transp_index >= 0 && map ? map[transp_index] : transp_index;
+	}
+
+	uint8* row(int, int, int) noexcept { return nullptr; }
+
+	void store(int x, int y, int w, uint8* pixels)
+	{
+		if (index_map)
+			for (int i = 0; i < w; i++) pixels[i] = index_map[pixels[i]];
+		fu(x, y, w, pixels, cmap, transp);
+	}
+
+	void clear(int x, int y, int w, int h, uint8 color)
+	{
+		uint8 bu[256];
+		memset(bu, color, sizeof(bu));
+		for (; w > 0; x += 256, w -= 256)
+		{
+			for (int i = 0; i < h; i++) fu(x, y + i, min(w, 256), bu, cmap, -1);
+		}
+	}
+};
+
+template<ColorMode CM>
+struct GifPixmapStore
+{
+	// store the scanlines in a direct color Pixmap.
+	// the color indexes are converted to pixel values once per image in colors[].
+	// true color:  colors[] = global_cmap[] colors.
+	// index color: colors[] = global color indexes.
+
+	static constexpr ColorDepth CD = get_colordepth(CM);
+
+	Pixmap<CM>&	 pm;
+	int			 x0, y0;
+	const Color* cmap;				// true color: global_cmap[], else nullptr
+	uint		 cmap_size;			// true color: size of global_cmap[]
+	bool		 draw_transparent;	// draw the transparent pixels
+	int*		 transp_out;		// if draw_transparent: store global index of the transparent color
+	int			 transp = -1;		// local index of the transparent color if not drawn
+	bool		 direct = false;	// the LZW decoder can write into the pixmap
+	uint		 colors[256];		// local color index -> pixel value
+
+	GifPixmapStore(Pixmap<CM>& pm, int x0, int y0, const Color* cmap, uint cmap_size, int* transp_out) noexcept :
+		pm(pm),
+		x0(x0),
+		y0(y0),
+		cmap(cmap),
+		cmap_size(cmap_size),
+		draw_transparent(transp_out != nullptr),
+		transp_out(transp_out)
+	{}
+
+	void start_image(const uint8* index_map, int transp_index) noexcept
+	{
+		for (uint i = 0; i < 256; i++)
+		{
+			uint idx  = index_map ? index_map[i] : i;
+			colors[i] = !cmap ? idx : idx < cmap_size ? cmap[idx].raw : 0;
+		}
+
+		transp = draw_transparent ? -1 : transp_index;
+		direct = CD == colordepth_8bpp && !cmap && !index_map && transp < 0;
+		if (transp_out) *transp_out = transp_index >= 0 && index_map ? index_map[transp_index] : transp_index;
+	}
+
+	uint8* row(int x, int y, int w) noexcept
+	{
+		if (!direct) return nullptr;
+		x += x0;
+		y += y0;
+		if (uint(y) >= uint(pm.height) || x < 0 || x + w > pm.width) return nullptr;
+		return pm.pixmap + y * pm.row_offset + x;
+	}
+
+	void store(int x, int y, int w, const uint8* pixels) noexcept
+	{
+		y += y0;
+		if (uint(y) >= uint(pm.height)) return;
+		x += x0;
+		if (x < 0) { pixels -= x, w += x, x = 0; }
+		if (x + w > pm.width) w = pm.width - x;
+
+		uint8* z = pm.pixmap + y * pm.row_offset;
+		for (int i = 0; i < w; i++)
+		{
+			uint8 pixel = pixels[i];
+			if (pixel != transp) bitblit::set_pixel<CD>(z, x + i, colors[pixel]);
+		}
+	}
+
+	void clear(int x, int y, int w, int h, uint8 color) noexcept
+	{
+		uint c = !cmap ? color : color < cmap_size ? cmap[color].raw : 0;
+		pm.fillRect(x + x0, y + y0, w, h, c);
+	}
+};
+
+
+template<typename Store>
+int GifDecoder::decode_frame_with(Store& store)
 {
 	// gif_signature
 	// opt. global cmap
@@ -585,14 +717,7 @@ int GifDecoder::decode_frame(store_scanline& fu)
 			if (disposal_method >= 2) // if caller didn't clear the disposal_method
 			{
 				disposal_method = 0;
-				memset(buf, background_color, sizeof(buf));
-				while (width)
-				{
-					int w = std::min(int(width), 256);
-					for (int y = 0; y < height; y++) fu(xpos, ypos + y, w, pixels, global_cmap, -1);
-					width -= w;
-					xpos += w;
-				}
+				store.clear(xpos, ypos, width, height, background_color);
 			}
 
 			xpos				 = file->read_LE<uint16>();
@@ -607,7 +732,7 @@ int GifDecoder::decode_frame(store_scanline& fu)
 			if (xpos + width > image_width) throw "Image corrupt";
 			if (ypos + height > image_height) throw "Image corrupt";
 
-			uint8 local_to_global[256]; // map local to global color index
+			uint8 local_to_global[256] = {0}; // map local to global color index
 			if (has_local_cmap)
 			{
 				Color* cmap = read_cmap(cmap_bits);
@@ -624,18 +749,19 @@ int GifDecoder::decode_frame(store_scanline& fu)
 			static constexpr uint8 y0[4] = {0, 4, 2, 1};
 			static constexpr uint8 dy[4] = {8, 8, 4, 2};
 
-			int transp = transparent_color;
-			if (transp >= 0 && has_local_cmap) transp = local_to_global[transp];
+			store.start_image(has_local_cmap ? local_to_global : nullptr, transparent_color);
 			transparent_color = -1;
 
 			for (uint i = interleaved ? 0 : 3; i < 4; i++)
 			{
 				for (int y = interleaved ? y0[i] : 0, d = interleaved ? dy[i] : 1; y < height; y += d)
 				{
-					lz_read_scanline(pixels, width);
-					if (has_local_cmap)
-						for (uint i = 0; i < width; i++) pixels[i] = local_to_global[pixels[i]]; //
-					fu(xpos, ypos + y, width, pixels, global_cmap, transp);
+					if (uint8* row = store.row(xpos, ypos + y, width)) lz_read_scanline(row, width);
+					else
+					{
+						lz_read_scanline(pixels, width);
+						store.store(xpos, ypos + y, width, pixels);
+					}
 				}
 			}
 
@@ -719,6 +845,12 @@ int GifDecoder::decode_frame(store_scanline& fu)
 	}
 }
 
+int GifDecoder::decode_frame(store_scanline& fu)
+{
+	GifFunctionStore store(fu, global_cmap);
+	return decode_frame_with(store);
+}
+
 int GifDecoder::decode_frame(Canvas& pm, int x0, int y0)
 {
 	// decode image up to the next animation control block or loop end
@@ -800,6 +932,44 @@ int GifDecoder::decode_frame(Canvas& pm, Color* colormap, int* transp_color, int
 	return rval;
 }
 
+template<ColorMode CM, typename>
+int GifDecoder::decode_frame(Pixmap<CM>& pm, int x0, int y0)
+{
+	// decode image up to the next animation control block or loop end
+	// does not draw the transparent pixels => dest pixmap must be cleared ahead
+	// this version is for true color dest pixmap
+
+	GifPixmapStore<CM> store(pm, x0, y0, global_cmap, 1u << total_color_bits, nullptr);
+	return decode_frame_with(store);
+}
+
+template<ColorMode CM, typename>
+int GifDecoder::decode_frame(Pixmap<CM>& pm, Color* cmap_out, int x0, int y0)
+{
+	// decode image up to the next animation control block or loop end
+	// does not draw the transparent pixels => dest pixmap must be cleared ahead
+	// pixmap must be an indexed color pixmap of the same depth as the gif image
+
+	GifPixmapStore<CM> store(pm, x0, y0, nullptr, 0, nullptr);
+	int				   rval = decode_frame_with(store);
+	if (cmap_out) memcpy(cmap_out, global_cmap, sizeof(Color) << min(pm.bits_per_color, int(total_color_bits)));
+	return rval;
+}
+
+template<ColorMode CM, typename>
+int GifDecoder::decode_frame(Pixmap<CM>& pm, Color* cmap_out, int* transp_color, int x0, int y0)
+{
+	// decode image up to the next animation control block or loop end
+	// draws the transparent pixels & returns the transparent color index
+	// pixmap must be an indexed color pixmap of the same depth as the gif image
+
+	int				   dummy;
+	GifPixmapStore<CM> store(pm, x0, y0, nullptr, 0, transp_color ? transp_color : &dummy);
+	int				   rval = decode_frame_with(store);
+	if (cmap_out) memcpy(cmap_out, global_cmap, sizeof(Color) << min(pm.bits_per_color, int(total_color_bits)));
+	return rval;
+}
+
 void GifDecoder::decode_image(Canvas& dest, int x0, int y0)
 {
 	// decode image up to the last frame
@@ -829,6 +999,25 @@ void GifDecoder::decode_image(Canvas& dest, Color* cmap, int* transp_color, int
 }
 
 
+template int GifDecoder::decode_frame<colormode_i1>(Pixmap<colormode_i1>&, int, int);
+template int GifDecoder::decode_frame<colormode_i2>(Pixmap<colormode_i2>&, int, int);
+template int GifDecoder::decode_frame<colormode_i4>(Pixmap<colormode_i4>&, int, int);
+template int GifDecoder::decode_frame<colormode_i8>(Pixmap<colormode_i8>&, int, int);
+template int GifDecoder::decode_frame<colormode_rgb>(Pixmap<colormode_rgb>&, int, int);
+
+template int GifDecoder::decode_frame<colormode_i1>(Pixmap<colormode_i1>&, Color*, int, int);
+template int GifDecoder::decode_frame<colormode_i2>(Pixmap<colormode_i2>&, Color*, int, int);
+template int GifDecoder::decode_frame<colormode_i4>(Pixmap<colormode_i4>&, Color*, int, int);
+template int GifDecoder::decode_frame<colormode_i8>(Pixmap<colormode_i8>&, Color*, int, int);
+template int GifDecoder::decode_frame<colormode_rgb>(Pixmap<colormode_rgb>&, Color*, int, int);
+
+template int GifDecoder::decode_frame<colormode_i1>(Pixmap<colormode_i1>&, Color*, int*, int, int);
+template int GifDecoder::decode_frame<colormode_i2>(Pixmap<colormode_i2>&, Color*, int*, int, int);
+template int GifDecoder::decode_frame<colormode_i4>(Pixmap<colormode_i4>&, Color*, int*, int, int);
+template int GifDecoder::decode_frame<colormode_i8>(Pixmap<colormode_i8>&, Color*, int*, int, int);
+template int GifDecoder::decode_frame<colormode_rgb>(Pixmap<colormode_rgb>&, Color*, int*, int, int);
+
+
 } // namespace kio::Graphics
 
 /*
@@ -11,9 +11,10 @@
 	To my best knowing the copyright never extended on the decoder.
 */
 
-#include "../Devices/File.h"
+#include "../Devices/BufferedFile.h"
 #include "Graphics/Canvas.h"
 #include "Graphics/Color.h"
+#include "Graphics/Pixmap.h"
 #include "standard_types.h"
 #include <functional>
 
@@ -62,6 +63,35 @@ public:
 	int	 decode_frame(Canvas&, Color* cmap_out, int* transp_color_out, int x0 = 0, int y0 = 0); // index color pixmap
 	void decode_image(Canvas&, Color* cmap_out, int* transp_color_out, int x0 = 0, int y0 = 0); // index color pixmap
 
+	/* decode directly into a Pixmap with a direct color mode.
+	   same as the Canvas versions above, but without a std::function and a virtual set_pixel() per pixel:
+	   the LZW decoder writes into the pixmap rows if possible (i8 pixmap without local cmap or transparency)
+	   and the colormap conversion is done once per image into a lookup table.
+	   Pixmaps with attributes use the Canvas versions.
+	*/
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	int decode_frame(Pixmap<CM>&, int x0 = 0, int y0 = 0); // true color pixmap
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	int decode_frame(Pixmap<CM>&, Color* cmap_out, int x0 = 0, int y0 = 0); // index color pixmap
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	int decode_frame(Pixmap<CM>&, Color* cmap_out, int* transp_color_out, int x0 = 0, int y0 = 0); // index color
+
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	void decode_image(Pixmap<CM>& pm, int x0 = 0, int y0 = 0)
+	{
+		while (decode_frame(pm, x0, y0)) { loop_count = 0; }
+	}
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	void decode_image(Pixmap<CM>& pm, Color* cmap_out, int x0 = 0, int y0 = 0)
+	{
+		while (decode_frame(pm, cmap_out, x0, y0)) { loop_count = 0; }
+	}
+	template<ColorMode CM, typename = std::enable_if_t<is_direct_color(CM)>>
+	void decode_image(Pixmap<CM>& pm, Color* cmap_out, int* transp_color_out, int x0 = 0, int y0 = 0)
+	{
+		while (decode_frame(pm, cmap_out, transp_color_out, x0, y0)) { loop_count = 0; }
+	}
+
 	uint16 image_width		 = 0;
 	uint16 image_height		 = 0;
 	bool   isa_gif_file		 = false;
@@ -80,11 +110,13 @@ public:
 	uint16 xpos, ypos, width, height;
 
 private:
+	template<typename Store>
+	int	 decode_frame_with(Store&);
 	void lz_initialize();
 	void lz_read_scanline(uchar* scanline, int length);
 	void finish();
 
-	FilePtr file;
+	Devices::BufferedFilePtr file;
 	uint	clear_code, eof_code, running_code, prev_code, max_code_plus_one;
 	int		depth, stack_ptr, shift_state, running_bits;
 	uint	position, bufsize;
@@ -4,156 +4,120 @@
 
 #include "FrameBuffer.h"
 #include "Pixmap_wAttr.h"
-#include <hardware/gpio.h>
 
-#define XRAM __attribute__((section(".scratch_x.FB" __XSTRING(__LINE__))))	   // the 4k page with the core1 stack
-#define RAM	 __attribute__((section(".time_critical.FB" __XSTRING(__LINE__)))) // general ram
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #define XRAM
+  #define RAM
+#else
+  #include <hardware/gpio.h>
+  #define XRAM __attribute__((section(".scratch_x.FB" __XSTRING(__LINE__))))	 // the 4k page with the core1 stack
+  #define RAM  __attribute__((section(".time_critical.FB" __XSTRING(__LINE__)))) // general ram
+#endif
 
 
 namespace kio::Video
 {
 using namespace Graphics;
 
-void RAM FrameBuffer<ColorMode::colormode_rgb>::vblank(VideoPlane* vp) noexcept
-{
-	auto* fb   = reinterpret_cast<FrameBuffer*>(vp);
-	fb->pixels = fb->pixmap->pixmap;
-}
+void RAM FrameBuffer<ColorMode::colormode_rgb>::vblank(VideoPlane*) noexcept {}
 
-void XRAM FrameBuffer<colormode_rgb>::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
+void XRAM FrameBuffer<colormode_rgb>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
-
-	auto*  fb  = reinterpret_cast<FrameBuffer*>(vp);
-	uint8* px  = fb->pixels;
-	fb->pixels = px + fb->row_offset;
-	ScanlineRenderer_rgb(scanline, uint(width), px);
+	// we use the row and don't rely on vblank() to reset a pointer:
+	// so render() can be called for different rows on both cores,
+	// and if we miss a scanline then only this scanline is missing.
+
+	auto* fb = reinterpret_cast<FrameBuffer*>(vp);
+	row		 = wrapped_row(fb->pixmap, row);
+	ScanlineRenderer_rgb(scanline, uint(width), fb->pixmap->pixmap + row * fb->row_offset);
 }
 
 
 //	_____________________________________________________________________________________
 
-void RAM FrameBuffer<colormode_i1>::vblank(VideoPlane* vp) noexcept
-{
-	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
-
-	fb->pixels = fb->pixmap->pixmap;
-	//fb->scanline_renderer.vblank();	nop
-}
+void RAM FrameBuffer<colormode_i1>::vblank(VideoPlane*) noexcept {}
 
-void XRAM FrameBuffer<colormode_i1>::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
+void XRAM FrameBuffer<colormode_i1>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
 	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
 
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
+	// we use the row and don't rely on vblank() to reset a pointer.
+	// see FrameBuffer<colormode_rgb>::render()
 
-	//gpio_set_mask(1 << PICO_DEFAULT_LED_PIN);
-	fb->scanline_renderer.render(scanline, uint(width), fb->pixels);
-	fb->pixels += fb->row_offset;
-	//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
+	row = wrapped_row(fb->pixmap, row);
+	fb->scanline_renderer.render(scanline, uint(width), fb->pixmap->pixmap + row * fb->row_offset);
 }
 
 
 //	_____________________________________________________________________________________
 
-void RAM FrameBuffer<colormode_i2>::vblank(VideoPlane* vp) noexcept
-{
-	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
+void RAM FrameBuffer<colormode_i2>::vblank(VideoPlane*) noexcept {}
 
-	fb->pixels = fb->pixmap->pixmap;
-}
-
-void XRAM FrameBuffer<colormode_i2>::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
+void XRAM FrameBuffer<colormode_i2>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
 	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
 
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
+	// we use the row and don't rely on vblank() to reset a pointer.
+	// see FrameBuffer<colormode_rgb>::render()
 
-	fb->scanline_renderer.render(scanline, uint(width), fb->pixels);
-	fb->pixels += fb->row_offset;
+	row = wrapped_row(fb->pixmap, row);
+	fb->scanline_renderer.render(scanline, uint(width), fb->pixmap->pixmap + row * fb->row_offset);
 }
 
 
 //	_____________________________________________________________________________________
 
-void RAM FrameBuffer<colormode_i4>::vblank(VideoPlane* vp) noexcept
-{
-	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
-
-	fb->pixels = fb->pixmap->pixmap;
-}
+void RAM FrameBuffer<colormode_i4>::vblank(VideoPlane*) noexcept {}
 
-void XRAM FrameBuffer<colormode_i4>::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
+void XRAM FrameBuffer<colormode_i4>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
 	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
 
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
+	// we use the row and don't rely on vblank() to reset a pointer.
+	// see FrameBuffer<colormode_rgb>::render()
 
-	fb->scanline_renderer.render(scanline, uint(width), fb->pixels);
-	fb->pixels += fb->row_offset;
+	row = wrapped_row(fb->pixmap, row);
+	fb->scanline_renderer.render(scanline, uint(width), fb->pixmap->pixmap + row * fb->row_offset);
 }
 
 
 //	_____________________________________________________________________________________
 
-void RAM FrameBuffer<colormode_i8>::vblank(VideoPlane* vp) noexcept
-{
-	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
-
-	fb->pixels = fb->pixmap->pixmap;
-}
+void RAM FrameBuffer<colormode_i8>::vblank(VideoPlane*) noexcept {}
 
-void XRAM FrameBuffer<colormode_i8>::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
+void XRAM FrameBuffer<colormode_i8>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
 	FrameBuffer* fb = reinterpret_cast<FrameBuffer*>(vp);
 
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
+	// we use the row and don't rely on vblank() to reset a pointer.
+	// see FrameBuffer<colormode_rgb>::render()
 
-	fb->scanline_renderer.render(scanline, uint(width), fb->pixels); // *** NOT HERE
-	fb->pixels += fb->row_offset;
+	row = wrapped_row(fb->pixmap, row);
+	fb->scanline_renderer.render(scanline, uint(width), fb->pixmap->pixmap + row * fb->row_offset);
 }
 
 
 //	_____________________________________________________________________________________
 
-void RAM FrameBufferBase_wAttr::vblank(VideoPlane* vp) noexcept
+void RAM FrameBufferBase_wAttr::vblank(VideoPlane*) noexcept {}
+
+void XRAM FrameBufferBase_wAttr::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
 {
 	FrameBufferBase_wAttr* fb = reinterpret_cast<FrameBufferBase_wAttr*>(vp);
 
-	fb->pixels	   = fb->pixmap;
-	fb->attributes = fb->attrmap;
-	fb->arow	   = fb->attrheight;
-}
+	// we use the row and don't rely on vblank() to reset a pointer.
+	// see FrameBuffer<colormode_rgb>::render()
+	// the attribute row is calculated with a reciprocal because division is in rom.
+	// the attribute row is calculated from the wrapped row, so first_row needs not be a multiple of attrheight.
 
-void XRAM FrameBufferBase_wAttr::render(VideoPlane* vp, int __unused row, int width, uint32* scanline) noexcept
-{
-	FrameBufferBase_wAttr* fb = reinterpret_cast<FrameBufferBase_wAttr*>(vp);
+	row = wrapped_row(fb->canvas, row);
 
-	// we don't check the row
-	// we rely on do_vblank() to reset the pointer
-	// and if we miss a scanline then the remainder of the screen is shifted
+	const uint8* pixels		= fb->pixmap + uint(row) * fb->row_offset;
+	const uint8* attributes = fb->attrmap + (uint(row) * fb->attrheight_recip >> 20) * fb->arow_offset;
 
 	//gpio_set_mask(1 << PICO_DEFAULT_LED_PIN);
-	fb->render_fu(scanline, uint(width), fb->pixels, fb->attributes); // *** NOT HERE
+	fb->render_fu(scanline, uint(width), pixels, attributes); // *** NOT HERE
 	//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
-
-	fb->pixels += fb->row_offset;
-
-	if unlikely (--fb->arow == 0)
-	{
-		fb->arow = fb->attrheight;
-		fb->attributes += fb->arow_offset;
-	}
 }
 
 
@@ -14,10 +14,18 @@ namespace kio::Video
 
 /*	_____________________________________________________________________________________
 	Template class FrameBuffer renders whole Pixmaps.
+	The Pixmap is displayed starting at row Canvas::first_row, wrapping around at the bottom.
 */
 template<ColorMode CM, typename = void>
 class FrameBuffer;
 
+// the row in pixmap[] which is displayed in screen row `row`:
+inline int wrapped_row(const Graphics::Canvas* pixmap, int row) noexcept
+{
+	row += pixmap->first_row;
+	return row < pixmap->height ? row : row - pixmap->height;
+}
+
 
 /*	_____________________________________________________________________________________
 	Explicit specialization for true color mode without attributes:
@@ -34,14 +42,14 @@ public:
 	Id("FrameBuffer");
 	RCPtr<const Pixmap> pixmap;
 	int					row_offset;
-	uint8*				pixels; // next position
 
 	FrameBuffer(const Pixmap* px, const ColorMap* = nullptr) noexcept : //
 		VideoPlane(&vblank, &render),
 		pixmap(px),
-		row_offset(pixmap->row_offset),
-		pixels(pixmap->pixmap)
-	{}
+		row_offset(pixmap->row_offset)
+	{
+		reentrant = true;
+	}
 	FrameBuffer(const Canvas* px, const ColorMap* = nullptr) noexcept : FrameBuffer(static_cast<const Pixmap*>(px))
 	{
 		assert(px->colormode == CM);
@@ -69,16 +77,16 @@ public:
 	RCPtr<const ColorMap> colormap;
 	ScanlineRenderer_i1	  scanline_renderer;
 	int					  row_offset;
-	uint8*				  pixels;
 
 	FrameBuffer(const Pixmap* px, const ColorMap* cm = nullptr) noexcept :
 		VideoPlane(&vblank, &render),
 		pixmap(px),
 		colormap(cm ? cm : &Graphics::system_colormap),
 		scanline_renderer(colormap->colors),
-		row_offset(pixmap->row_offset),
-		pixels(pixmap->pixmap)
-	{}
+		row_offset(pixmap->row_offset)
+	{
+		reentrant = true;
+	}
 	FrameBuffer(const Canvas* px, const ColorMap* cmap = nullptr) noexcept :
 		FrameBuffer(static_cast<const Pixmap*>(px), cmap)
 	{
@@ -107,16 +115,16 @@ public:
 	RCPtr<const ColorMap> colormap;
 	ScanlineRenderer_i2	  scanline_renderer;
 	int					  row_offset;
-	uint8*				  pixels;
 
 	FrameBuffer(const Pixmap* px, const ColorMap* cm = nullptr) noexcept :
 		VideoPlane(&vblank, &render),
 		pixmap(px),
 		colormap(cm ? cm : &Graphics::system_colormap),
 		scanline_renderer(colormap->colors),
-		row_offset(pixmap->row_offset),
-		pixels(pixmap->pixmap)
-	{}
+		row_offset(pixmap->row_offset)
+	{
+		reentrant = true;
+	}
 	FrameBuffer(const Canvas* px, const ColorMap* cmap = nullptr) noexcept :
 		FrameBuffer(static_cast<const Pixmap*>(px), cmap)
 	{
@@ -145,16 +153,16 @@ public:
 	RCPtr<const ColorMap> colormap;
 	ScanlineRenderer_i4	  scanline_renderer;
 	int					  row_offset;
-	uint8*				  pixels;
 
 	FrameBuffer(const Pixmap* px, const ColorMap* cm = nullptr) noexcept :
 		VideoPlane(&vblank, &render),
 		pixmap(px),
 		colormap(cm ? cm : &Graphics::system_colormap),
 		scanline_renderer(colormap->colors),
-		row_offset(pixmap->row_offset),
-		pixels(pixmap->pixmap)
-	{}
+		row_offset(pixmap->row_offset)
+	{
+		reentrant = true;
+	}
 	FrameBuffer(const Canvas* px, const ColorMap* cmap = nullptr) noexcept :
 		FrameBuffer(static_cast<const Pixmap*>(px), cmap)
 	{
@@ -183,16 +191,16 @@ public:
 	RCPtr<const ColorMap> colormap;
 	ScanlineRenderer_i8	  scanline_renderer;
 	int					  row_offset;
-	uint8*				  pixels;
 
 	FrameBuffer(const Pixmap* px, const ColorMap* cm = nullptr) noexcept :
 		VideoPlane(&vblank, &render),
 		pixmap(px),
 		colormap(cm ? cm : &Graphics::system_colormap),
 		scanline_renderer(colormap->colors),
-		row_offset(pixmap->row_offset),
-		pixels(pixmap->pixmap)
-	{}
+		row_offset(pixmap->row_offset)
+	{
+		reentrant = true;
+	}
 	FrameBuffer(const Canvas* px, const ColorMap* cmap = nullptr) noexcept :
 		FrameBuffer(static_cast<const Pixmap*>(px), cmap)
 	{
@@ -213,34 +221,37 @@ protected:
 	using ScanlineRenderFu = void(uint32* dest, uint width, const uint8* pixels, const uint8* attributes) noexcept;
 
 	FrameBufferBase_wAttr(
+		const Graphics::Canvas* canvas,					  //
 		const uint8* pixmap, uint row_offset,			  //
 		const uint8* attr, uint arow_offset, int aheight, //
 		ScanlineRenderFu* fu) noexcept					  //
 		:
 		VideoPlane(&vblank, &render),
+		canvas(canvas),
 		pixmap(pixmap),
-		pixels(pixmap),
 		row_offset(row_offset),
 		render_fu(fu),
 		attrmap(attr),
-		attributes(attr),
 		arow_offset(arow_offset),
-		arow(aheight),
-		attrheight(aheight)
-	{}
+		attrheight_recip((0x100000u + uint(aheight) - 1) / uint(aheight))
+	{
+		assert(canvas->height <= 0x100000 / aheight); // else attrheight_recip is not exact for the last rows
+		reentrant = true;
+	}
 
 private:
 	Id("FrameBuffer");
-	const uint8*	  pixmap;
-	const uint8*	  pixels;
-	uint			  row_offset;
-	ScanlineRenderFu* render_fu;
+	const Graphics::Canvas* canvas; // for first_row and height
+	const uint8*			pixmap;
+	uint					row_offset;
+	ScanlineRenderFu*		render_fu;
 
 	const uint8* attrmap;
-	const uint8* attributes;
 	uint		 arow_offset;
-	int			 arow;
-	int			 attrheight;
+	uint		 attrheight_recip; // 2^20 / attrheight, rounded up
+
+	// row * attrheight_recip >> 20 == row / attrheight is exact only for row < 2^20 / attrheight.
+	// e.g. attrheight = 12: exact for rows 0 .. 87380, which is far more than any screen height.
 
 	static void render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
 	static void vblank(VideoPlane*) noexcept;
@@ -262,7 +273,7 @@ public:
 
 	FrameBuffer(const Pixmap* px, const ColorMap* = nullptr) noexcept :
 		FrameBufferBase_wAttr(
-			px->pixmap, px->row_offset, px->attributes.pixmap, px->attributes.row_offset, px->attrheight,
+			px, px->pixmap, px->row_offset, px->attributes.pixmap, px->attributes.row_offset, px->attrheight,
 			&ScanlineRenderer<CM>),
 		pixmap(px)
 	{}
@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "HorizontalLayout.h"
+#include "PlaneProfiler.h"
 #include "Graphics/Color.h"
 #include "basic_math.h"
 #include <hardware/gpio.h>
@@ -71,7 +72,7 @@ void RAM HorizontalLayout<2>::do_render(VideoPlane* vp, int row, int width, uint
 		if (w > width) w = width;
 
 		vp = pp->vp;
-		vp->render_fu(vp, row, w, fbu);
+		render_plane(vp, row, w, fbu);
 
 		width -= w;
 		fbu += w >> zz;
@@ -6,11 +6,88 @@
 #include "Color.h"
 #include "basic_math.h"
 #include "standard_types.h"
-#include <hardware/interp.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <hardware/interp.h>
+#endif
 
 namespace kio::Video
 {
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+
+/*	Software emulation of the RP2040 interpolator for the desktop_tools.
+	This allows to run the ScanlineRenderers on the host for benchmarks and unit tests.
+	Only the features used by the ScanlineRenderers are emulated.
+	Each thread gets it's own set of interpolators, just like each core on the RP2040.
+*/
+struct Interp
+{
+	static constexpr uint ss_color = msbit(sizeof(Graphics::Color));
+	static constexpr uint lane0	   = 0;
+	static constexpr uint lane1	   = 1;
+
+	uint32	  accum[2];
+	uintptr_t base[3];
+	uint8	  shift[2];
+	uint8	  mask_lsb[2];
+	uint8	  mask_msb[2];
+	bool	  cross_input[2];
+
+	__force_inline uintptr_t lane_result(uint lane) const noexcept
+	{
+		uint32 value = accum[cross_input[lane] ? lane ^ 1 : lane] >> shift[lane];
+		uint32 mask	 = uint32(0xffffffffu << mask_lsb[lane]) & (0xffffffffu >> (31 - mask_msb[lane]));
+		return base[lane] + (value & mask);
+	}
+
+	__force_inline uintptr_t pop(uint lane) noexcept
+	{
+		uintptr_t result0 = lane_result(lane0);
+		uintptr_t result1 = lane_result(lane1);
+		accum[lane0]	  = uint32(result0);
+		accum[lane1]	  = uint32(result1);
+		return lane ? result1 : result0;
+	}
+
+	__force_inline uint32 pop_lane_result(uint lane) noexcept { return uint32(pop(lane)); }
+	__force_inline void	  set_accumulator(uint lane, uint32 value) noexcept { accum[lane] = value; }
+
+	__force_inline void setup(uint bpi, uint ss = ss_color) noexcept
+	{
+		// bpi = bits per index: 1, 2, 4 or 8
+		// ss  = size shift for field elements
+
+		shift[lane0]	   = uint8(bpi); // shift right by 1 .. 8 bit
+		mask_lsb[lane0]	   = 0;
+		mask_msb[lane0]	   = 31;
+		cross_input[lane0] = false;
+		shift[lane1]	   = 0;
+		mask_lsb[lane1]	   = uint8(ss); // mask to select index bits
+		mask_msb[lane1]	   = uint8(ss + bpi - 1);
+		cross_input[lane1] = true; // read from accu lane0
+	}
+
+	__force_inline void set_color_base(const void* colors) noexcept { base[lane1] = uintptr_t(colors); }
+	__force_inline void set_pixels(uint32 value, uint ss = ss_color) noexcept { accum[lane0] = value << ss; }
+
+	template<typename T = Graphics::Color>
+	const __force_inline T* next_color() noexcept
+	{
+		return reinterpret_cast<const T*>(pop(lane1));
+	}
+};
+
+inline thread_local Interp interp_hw_array[2];
+
+  #undef interp0
+  #undef interp1
+  #define interp0 (&kio::Video::interp_hw_array[0])
+  #define interp1 (&kio::Video::interp_hw_array[1])
+
+#else
+
 struct InterpConfig
 {
 	uint32 c;
@@ -77,5 +154,7 @@ struct Interp : public interp_hw_t
 	}
 };
 
+#endif
+
 
 } // namespace kio::Video
@@ -5,9 +5,11 @@
 #include "MultiSpritesPlane.h"
 #include "Trace.h"
 #include "cdefs.h"
-#include <pico/platform.h>
-#include <pico/stdlib.h>
-#include <pico/sync.h>
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
+  #include <pico/platform.h>
+  #include <pico/stdlib.h>
+  #include <pico/sync.h>
+#endif
 
 
 namespace kio::Video
@@ -19,8 +21,13 @@ using namespace Graphics;
 // also, there should be no const data accessed in hot video code for the same reason.
 // the most timecritical things should go into core1 stack page because it is not contended.
 
-#define XRAM __attribute__((section(".scratch_x.MSP" __XSTRING(__LINE__))))		// the 4k page with the core1 stack
-#define RAM	 __attribute__((section(".time_critical.MSP" __XSTRING(__LINE__)))) // general ram
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #define XRAM
+  #define RAM
+#else
+  #define XRAM __attribute__((section(".scratch_x.MSP" __XSTRING(__LINE__))))	  // the 4k page with the core1 stack
+  #define RAM  __attribute__((section(".time_critical.MSP" __XSTRING(__LINE__)))) // general ram
+#endif
 
 
 bool hotlist_overflow = false; // set by add_to_hotlist()
@@ -50,6 +57,7 @@ void MultiSpritesPlane<Sprite, WZ>::clear_displaylist(bool delete_sprites) noexc
 			Lock _;
 			s = displaylist;
 			if (s) _unlink(s);
+			if (s) _add_to_bands(s, -1);
 		}
 		if (delete_sprites) delete s;
 	}
@@ -66,6 +74,7 @@ Sprite* MultiSpritesPlane<Sprite, WZ>::add(Sprite* sprite) throws
 
 	Lock _;
 	_link(sprite);
+	_add_to_bands(sprite, +1);
 	return sprite;
 }
 
@@ -77,6 +86,7 @@ Sprite* MultiSpritesPlane<Sprite, WZ>::remove(Sprite* sprite) noexcept
 
 	Lock _;
 	_unlink(sprite);
+	_add_to_bands(sprite, -1);
 	return sprite;
 }
 
@@ -88,14 +98,22 @@ void MultiSpritesPlane<Sprite, WZ>::moveTo(Sprite* s, const Point& p) noexcept
 
 	Lock _;
 	bool f = p.y != s->get_ypos();
+	if (f) _add_to_bands(s, -1);
 	s->set_position(p);
+	if (f) _add_to_bands(s, +1);
 	if (f) _move(s);
 }
 
 template<typename Sprite, ZPlane WZ>
 void MultiSpritesPlane<Sprite, WZ>::replace(Sprite* s, const Shape& new_shape) noexcept
 {
-	if (s->replace(new_shape)) _move(s);
+	assert(is_in_displaylist(s));
+
+	Lock _;
+	_add_to_bands(s, -1);
+	bool f = s->replace(new_shape);
+	_add_to_bands(s, +1);
+	if (f) _move(s);
 }
 
 
@@ -114,9 +132,9 @@ void RAM MultiSpritesPlane<Sprite, WZ>::_unlink(Sprite* s) noexcept
 
 	if (s->prev) s->prev->next = s->next;
 	else displaylist = static_cast<Sprite*>(s->next);
-	s->prev = nullptr;
 
 	if (s->next) s->next->prev = s->prev;
+	s->prev = nullptr;
 	// s->next = nullptr;	  don't clear s->next: vblank() may need it!
 }
 
@@ -190,21 +208,35 @@ void RAM MultiSpritesPlane<Sprite, WZ>::_move(Sprite* s) noexcept
 	if ((other = static_cast<Sprite*>(s->prev)) && y < other->pos.y)
 	{
 		_unlink(s);
-		Sprite* prev = static_cast<Sprite*>(other->prev);
-		do other = prev;
-		while ((prev = static_cast<Sprite*>(other->prev)) && y < prev->pos.y);
+		Sprite* prev;
+		while ((prev = static_cast<Sprite*>(other->prev)) && y < prev->pos.y) other = prev;
 		_link_before(s, other);
 	}
 	else if ((other = static_cast<Sprite*>(s->next)) && y > other->pos.y)
 	{
 		_unlink(s);
-		Sprite* next = static_cast<Sprite*>(other->next);
-		do other = next;
-		while ((next = static_cast<Sprite*>(other->next)) && y > next->pos.y);
+		Sprite* next;
+		while ((next = static_cast<Sprite*>(other->next)) && y > next->pos.y) other = next;
 		_link_after(s, other);
 	}
 }
 
+template<typename Sprite, ZPlane WZ>
+void RAM MultiSpritesPlane<Sprite, WZ>::_add_to_bands(const Sprite* s, int delta) noexcept
+{
+	// update the sprite bucket index for the rows covered by this sprite:
+	// used in vblank()
+
+	assert(is_spin_locked(sprites_spinlock));
+
+	int y0 = max(s->pos.y, 0);
+	int y1 = min(s->pos.y + s->height(), int(num_bands << ss_band_height));
+	if (y0 >= y1) return;
+
+	uint b1 = uint(y1 - 1) >> ss_band_height;
+	for (uint b = uint(y0) >> ss_band_height; b <= b1; b++) band_count[b] = uint16(band_count[b] + delta);
+}
+
 template<typename Sprite, ZPlane WZ>
 void RAM MultiSpritesPlane<Sprite, WZ>::add_to_hotlist(const Sprite* sprite) noexcept
 {
@@ -244,19 +276,26 @@ template<typename Sprite, ZPlane WZ>
 void RAM MultiSpritesPlane<Sprite, WZ>::renderScanline(int hot_row, int width, uint32* scanline) noexcept
 {
 	trace(__func__);
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
 	assert(get_core_num() == 1);
+#endif
 
 	Video::hot_row = hot_row;
 
+	// nothing to do if no sprite intersects the current band:
+	// then no sprite starts in this row and no sprite is in the hotlist.
+	if (num_hot == 0 && num_sprites_in_band(hot_row) == 0) return;
+
 	// add sprites coming into range of scanline:
 	// adds sprites which start in the current row
 	// adds sprites which started in a previous row and advances shape properly,
 	//   e.g. after a missed scanline or for sprites starting above screen
+	// skips sprites which already ended above the current row.
 
 	Sprite* s = next_sprite;
 	while (s && s->pos.y <= hot_row)
 	{
-		if (s->pos.x < width && s->pos.x + s->width() > 0) { add_to_hotlist(s); }
+		if (s->pos.x < width && s->pos.x + s->width() > 0 && s->pos.y + s->height() > hot_row) add_to_hotlist(s);
 		next_sprite = s = static_cast<Sprite*>(s->next);
 	}
 
@@ -289,7 +328,9 @@ void RAM MultiSpritesPlane<Sprite, WZ>::vblank() noexcept
 	// variants: with and without animation.
 
 	trace(__func__);
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
 	assert(get_core_num() == 1);
+#endif
 
 	num_hot		= 0;
 	hot_row		= -9999;
@@ -311,7 +352,10 @@ void RAM MultiSpritesPlane<Sprite, WZ>::vblank() noexcept
 
 			if (is_in_displaylist(s))
 			{
-				if (s->next_frame()) _move(s);
+				_add_to_bands(s, -1);
+				bool f = s->next_frame();
+				_add_to_bands(s, +1);
+				if (f) _move(s);
 			}
 		}
 	}
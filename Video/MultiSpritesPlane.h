@@ -6,7 +6,9 @@
 #include "AnimatedSprite.h"
 #include "Shape.h"
 #include "VideoPlane.h"
-#include <pico/sync.h>
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
+  #include <pico/sync.h>
+#endif
 
 
 namespace kio::Video
@@ -55,12 +57,26 @@ public:
 	bool __always_inline is_in_displaylist(Sprite* s) const noexcept { return s->prev || displaylist == s; }
 	void				 clear_displaylist(bool delete_sprites = false) noexcept;
 
+	/*	Sprite bucket index:
+		The screen is divided into bands of 16 rows. For each band we count the sprites which intersect it.
+		The counts are updated incrementally in add(), remove(), moveTo(), replace() and for animations.
+		renderScanline() returns immediately in rows of empty bands.
+	*/
+	static constexpr uint ss_band_height = 4;
+	static constexpr uint num_bands		 = 1024 >> ss_band_height;
+
+	uint num_sprites_in_band(int row) const noexcept
+	{
+		return uint(row) < num_bands << ss_band_height ? band_count[uint(row) >> ss_band_height] : 0;
+	}
+
 private:
 	void _unlink(Sprite*) noexcept;
 	void _link_after(Sprite*, Sprite* other) noexcept;
 	void _link_before(Sprite*, Sprite* other) noexcept;
 	void _link(Sprite*) noexcept;
 	void _move(Sprite*) noexcept;
+	void _add_to_bands(const Sprite*, int delta) noexcept;
 
 	struct Lock
 	{
@@ -76,6 +92,8 @@ private:
 	HotShape			  hotlist[max_hot];
 	uint				  num_hot = 0;
 
+	uint16 band_count[num_bands] = {0};
+
 	void add_to_hotlist(const Sprite*) noexcept;
 };
 
@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "Passepartout.h"
+#include "PlaneProfiler.h"
 #include "Graphics/Color.h"
 #include "Video.h"
 
@@ -53,7 +54,7 @@ void RAM Passepartout::do_render(VideoPlane* vp, int row, int width, uint32* fbu
 		clear_row(fbu, left);
 		clear_row(fbu + left + inner_width, right);
 		VideoPlane* vp = me->vp;
-		vp->render_fu(vp, row, inner_width << ss, fbu + left);
+		render_plane(vp, row - me->top, inner_width << ss, fbu + left);
 	}
 	else
 	{
@@ -0,0 +1,195 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "PlaneProfiler.h"
+#include "Video.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #define RAM
+#else
+  #define RAM __attribute__((section(".time_critical.PP" __XSTRING(__LINE__)))) // general ram
+#endif
+
+
+namespace kio::Video
+{
+
+static PlaneProfile profiles[max_profiled_planes]; // [0] = vblank
+static uint			num_profiles = 1;
+static uint32		band_factor	 = 0; // row * band_factor >> 16 = band
+
+// the plane which took longest since the last scanline was started:
+static const PlaneProfile* slowest	  = nullptr;
+static uint32			   slowest_cc = 0;
+
+// per core: sum of the time of the child planes of the plane currently rendered:
+static uint32 child_cc[2] = {0, 0};
+
+
+static void RAM record(PlaneProfile& p, int row, uint32 cc) noexcept
+{
+	// note: no division here: this may be called during flash lockout.
+
+	p.count++;
+	p.cc_sum += cc;
+	if (cc < p.cc_min) p.cc_min = cc;
+	if (cc > p.cc_max) p.cc_max = cc;
+
+	uint band = min(uint(row) * band_factor >> 16, PlaneProfile::num_bands - 1);
+	auto& b	  = p.bands[band];
+	b.count++;
+	b.cc_sum += cc;
+	if (cc > b.cc_max) b.cc_max = cc;
+
+	if (cc >= slowest_cc)
+	{
+		slowest_cc = cc;
+		slowest	   = &p;
+	}
+}
+
+uint32 RAM profile_render_start() noexcept
+{
+	// start rendering a plane:
+	// save the child time of the parent plane and start a new sum for this plane.
+
+	uint32& sum				= child_cc[get_core_num()];
+	uint32	parent_child_cc = sum;
+	sum						= 0;
+	return parent_child_cc;
+}
+
+void RAM profile_render(const VideoPlane* vp, int row, uint32 cc, uint32 parent_child_cc) noexcept
+{
+	// record the time of this plane without the time of it's child planes
+	// and add the total time of this plane to the child time of the parent plane:
+
+	uint32& sum = child_cc[get_core_num()];
+	uint32	own = cc - sum;
+	sum			= parent_child_cc + cc;
+
+	uint i = 1;
+	while (i < num_profiles && profiles[i].plane != vp) { i++; }
+	if unlikely (i == num_profiles)
+	{
+		if (i == max_profiled_planes) return;
+		profiles[i].plane = vp;
+		num_profiles	  = i + 1;
+	}
+	record(profiles[i], row, own);
+}
+
+void RAM profile_vblank(uint32 cc) noexcept
+{
+	record(profiles[0], 0, cc); //
+}
+
+void RAM profile_next_scanline() noexcept
+{
+	slowest	   = nullptr;
+	slowest_cc = 0;
+}
+
+void RAM profile_scanlines_missed(uint count) noexcept
+{
+	PlaneProfile* p = const_cast<PlaneProfile*>(slowest);
+	if (p == nullptr) p = &profiles[0];
+	p->scanlines_missed += count;
+}
+
+uint numPlaneProfiles() noexcept
+{
+	return num_profiles; //
+}
+
+const PlaneProfile& getPlaneProfile(uint idx) noexcept
+{
+	assert(idx < num_profiles);
+	return profiles[idx];
+}
+
+const PlaneProfile* findPlaneProfile(const VideoPlane* vp) noexcept
+{
+	for (uint i = 0; i < num_profiles; i++)
+	{
+		if (profiles[i].plane == vp) return &profiles[i];
+	}
+	return nullptr;
+}
+
+void resetPlaneProfiles() noexcept
+{
+	num_profiles = 1;
+	memset(profiles, 0, sizeof(profiles));
+	for (uint i = 0; i < max_profiled_planes; i++) { profiles[i].cc_min = ~0u; }
+	band_factor = vga_mode.height ? (PlaneProfile::num_bands << 16) / uint(vga_mode.height) : 0;
+	profile_next_scanline();
+}
+
+void printPlaneProfiles() noexcept
+{
+	uint32 budget = max(cc_per_scanline, 1u);
+	uint   rows	  = max(vga_mode.height / PlaneProfile::num_bands, 1u);
+
+	printf("plane profiles: cc per scanline = %u\n", budget);
+	for (uint i = 0; i < num_profiles; i++)
+	{
+		const PlaneProfile& p = profiles[i];
+		if (p.count == 0) continue;
+
+		if (p.plane) printf("plane %p:\n", static_cast<const void*>(p.plane));
+		else printf("vblank:\n");
+		printf(
+			"  count=%u, min=%u, avg=%u, max=%u cc, max=%u%%, missed=%u\n", p.count, p.cc_min, p.cc_avg(), p.cc_max,
+			p.cc_max * 100 / budget, p.scanlines_missed);
+
+		for (uint b = 0; b < PlaneProfile::num_bands; b++)
+		{
+			const PlaneProfile::Band& band = p.bands[b];
+			if (band.count == 0) continue;
+			printf(
+				"  rows %4u++: count=%u, avg=%u, max=%u cc, max=%u%%\n", b * rows, band.count, band.cc_avg(),
+				band.cc_max, band.cc_max * 100 / budget);
+		}
+	}
+}
+
+} // namespace kio::Video
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
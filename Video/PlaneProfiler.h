@@ -0,0 +1,131 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "VideoBackend.h"
+#include "VideoPlane.h"
+
+#ifndef VIDEO_PROFILE_PLANES
+  #define VIDEO_PROFILE_PLANES 0
+#endif
+
+
+namespace kio::Video
+{
+
+/*
+	Opt-in profiler for the render time of the VideoPlanes.
+	Enable it with option VIDEO_PROFILE_PLANES=ON in CMakeLists.txt.
+
+	Each call to render_fu() by the video controller or by a HorizontalLayout, VerticalLayout or
+	Passepartout is timed with time_cc_32() and recorded for this plane:
+	min, avg and max cpu cycles per scanline and the number of rows, avg and max cycles per row band.
+	The time of a layout plane is the time spent in the layout itself: the time of its child planes is subtracted.
+	The vblank actions and the vblank_fu() of all planes are recorded as a pseudo plane with plane = nullptr.
+
+	Missed scanlines are attributed to the plane (or the vblank) which took longest
+	since the previous scanline was started, which is normally the plane which blew the budget.
+	Because layouts are recorded without their child planes this is the child plane, not the layout.
+
+	Notes:
+	- time_cc_32() is calculated from time_us_32(): the resolution is 1 us.
+	- with dual-core rendering both cores update the profiles and some updates may be lost.
+	- the profiles refer to the planes by address. They are reset by startVideo().
+	  Call resetPlaneProfiles() after adding or removing planes.
+*/
+
+static constexpr bool profile_planes = VIDEO_PROFILE_PLANES;
+
+struct PlaneProfile
+{
+	static constexpr uint num_bands = 8; // row bands of vga_mode.height / num_bands rows
+
+	struct Band
+	{
+		uint32 count;
+		uint32 cc_max;
+		uint64 cc_sum;
+
+		uint32 cc_avg() const noexcept { return count ? uint32(cc_sum / count) : 0; }
+	};
+
+	const VideoPlane* plane; // nullptr = vblank
+	uint32			  count; // number of calls
+	uint32			  cc_min;
+	uint32			  cc_max;
+	uint64			  cc_sum;
+	uint32			  scanlines_missed; // attributed to this plane
+	Band			  bands[num_bands];
+
+	uint32 cc_avg() const noexcept { return count ? uint32(cc_sum / count) : 0; }
+};
+
+static constexpr uint max_profiled_planes = 16; // incl. vblank
+
+// query api:
+extern uint				   numPlaneProfiles() noexcept;					  // incl. vblank
+extern const PlaneProfile& getPlaneProfile(uint idx) noexcept;			  // idx < numPlaneProfiles()
+extern const PlaneProfile* findPlaneProfile(const VideoPlane*) noexcept; // nullptr = vblank
+extern void				   resetPlaneProfiles() noexcept;
+extern void				   printPlaneProfiles() noexcept;
+
+// used by the video controller:
+extern uint32 profile_render_start() noexcept;
+extern void	  profile_render(const VideoPlane*, int row, uint32 cc, uint32 parent_child_cc) noexcept;
+extern void profile_vblank(uint32 cc) noexcept;
+extern void profile_next_scanline() noexcept;
+extern void profile_scanlines_missed(uint count) noexcept;
+
+/*
+	call the render function of a VideoPlane.
+	used by the video controller and by layout planes for their child planes.
+*/
+inline void render_plane(VideoPlane* vp, int row, int width, uint32* buffer) noexcept
+{
+	if constexpr (profile_planes)
+	{
+		uint32 parent_child_cc = profile_render_start();
+		uint32 cc			   = time_cc_32();
+		vp->render_fu(vp, row, width, buffer);
+		profile_render(vp, row, time_cc_32() - cc, parent_child_cc);
+	}
+	else vp->render_fu(vp, row, width, buffer);
+}
+
+} // namespace kio::Video
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
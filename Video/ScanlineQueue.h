@@ -0,0 +1,139 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "standard_types.h"
+#include <atomic>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <pico/platform.h>
+#endif
+
+
+namespace kio::Video
+{
+
+/*
+	Lock-free queue of scanlines which are rendered by the other core.
+
+	This is used for dual-core rendering: core1 runs the video_runner() which renders the even rows
+	itself and passes the odd rows through the ScanlineQueue to core0. Core0 renders them in an
+	interrupt handler. Thereby each core has the time of 2 scanlines to render one scanline.
+	All functions are forced inline because the video_runner() must not call code in flash.
+
+	There is one producer (core1) and one consumer (core0):
+	put() and wait_idle() must only be called by the producer, render_all() only by the consumer.
+
+	The producer must not put a scanline into the queue before it may be overwritten,
+	exactly as if it rendered it itself. It passes the time when the scanline will be displayed
+	so that the consumer can detect scanlines which it rendered too late. Before the producer calls the vblank functions
+	of the VideoPlanes it must wait until the consumer has finished all queued scanlines.
+*/
+template<uint SIZE = 8>
+class ScanlineQueue
+{
+	static constexpr uint MASK = SIZE - 1;
+	static_assert(SIZE > 0 && (SIZE & MASK) == 0, "size must be a power of 2");
+
+public:
+	struct Job
+	{
+		int		row;
+		uint32* scanline;
+		uint32	deadline; // time_cc_32() when the scanline is displayed
+	};
+
+	Job			  jobs[SIZE];
+	volatile uint wp = 0; // only modified by producer
+	volatile uint rp = 0; // only modified by consumer
+
+	__force_inline bool is_idle() const noexcept { return rp == wp; }
+	__force_inline uint avail() const noexcept { return wp - rp; }
+	__force_inline uint free() const noexcept { return SIZE - avail(); }
+
+	__force_inline void wait_idle() const noexcept
+	{
+		while (rp != wp) {}
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+
+	/*	called by the producer:
+		put a scanline into the queue.
+		@return false if the queue is full
+	*/
+	__force_inline bool put(int row, uint32* scanline, uint32 deadline = 0) noexcept
+	{
+		uint i = wp;
+		if (i - rp >= SIZE) return false;
+		jobs[i & MASK] = Job {row, scanline, deadline};
+		std::atomic_thread_fence(std::memory_order_release);
+		wp = i + 1;
+		return true;
+	}
+
+	/*	called by the consumer:
+		render all scanlines in the queue: render_fu(row, scanline, deadline)
+		rp is incremented after the scanline was rendered, so that is_idle() means 'all done'.
+		@return number of rendered scanlines
+	*/
+	template<typename RenderFu>
+	__force_inline uint render_all(RenderFu&& render_fu) noexcept
+	{
+		uint n = 0;
+		for (uint i = rp; i != wp; i++, n++)
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const Job& job = jobs[i & MASK];
+			render_fu(job.row, job.scanline, job.deadline);
+			std::atomic_thread_fence(std::memory_order_release);
+			rp = i + 1;
+		}
+		return n;
+	}
+};
+
+} // namespace kio::Video
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -13,9 +13,13 @@
 #include "ScanlineRenderer.h"
 #include "Interp.h"
 #include "basic_math.h"
-#include <hardware/gpio.h>
-#include <hardware/interp.h>
-#include <pico/stdio.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <hardware/gpio.h>
+  #include <hardware/interp.h>
+  #include <pico/stdio.h>
+#endif
 
 
 #ifndef VIDEO_INTERP0_MODE
@@ -39,19 +43,29 @@
 #endif
 
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+
+// desktop_tools: the interpolators are emulated in Interp.h
+  #define XRAM
+  #define RAM
+
+#else
+
 // silence warnings:
 // clang-format off
 #define interp_hw_array ((interp_hw_t *)(SIO_BASE + SIO_INTERP0_ACCUM0_OFFSET))
 // clang-format on
-#undef interp_hw_array
-#define interp_hw_array reinterpret_cast<Interp*>(SIO_BASE + SIO_INTERP0_ACCUM0_OFFSET)
+  #undef interp_hw_array
+  #define interp_hw_array reinterpret_cast<Interp*>(SIO_BASE + SIO_INTERP0_ACCUM0_OFFSET)
 
 // all hot video code should go into ram to allow video while flash lockout.
 // also, there should be no const data accessed in hot video code for the same reason.
 // the most timecritical things should go into core1 stack page because it is not contended.
 
-#define XRAM __attribute__((section(".scratch_x.SRFu" __XSTRING(__LINE__))))	 // the 4k page with the core1 stack
-#define RAM	 __attribute__((section(".time_critical.SRFu" __XSTRING(__LINE__)))) // general ram
+  #define XRAM __attribute__((section(".scratch_x.SRFu" __XSTRING(__LINE__))))	  // the 4k page with the core1 stack
+  #define RAM  __attribute__((section(".time_critical.SRFu" __XSTRING(__LINE__)))) // general ram
+
+#endif
 
 
 // ============================================================================================
@@ -89,7 +103,9 @@ using onecolor	 = uint_with_size<sizeof(Color) * 1>::type;
 using twocolors	 = uint_with_size<sizeof(Color) * 2>::type;
 using fourcolors = uint_with_size<sizeof(Color) * 4>::type;
 
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
 static_assert(SIO_INTERP1_ACCUM0_OFFSET - SIO_INTERP0_ACCUM0_OFFSET == sizeof(Interp));
+#endif
 
 
 // ============================================================================================
@@ -121,9 +137,8 @@ static __force_inline void cleanup_if_needed() noexcept
 	if constexpr (need_cleanup<mode>) setup<ip_modes[ipi<mode>]>(&interp0[ipi<mode>]);
 }
 
-void initializeInterpolators() noexcept
+static __force_inline void setup_interpolators() noexcept
 {
-	assert(get_core_num() == 1);
 	constexpr uint lane0 = 0;
 
 	interp0->base[lane0] = 0; // interp0.lane0: add nothing
@@ -133,6 +148,19 @@ void initializeInterpolators() noexcept
 	if constexpr (ip1_mode != ip_any) setup<ip1_mode>(interp1);
 }
 
+void initializeInterpolators() noexcept
+{
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
+	assert(get_core_num() == 1);
+#endif
+	setup_interpolators();
+}
+
+void RAM setupInterpolatorsOnCore0() noexcept
+{
+	setup_interpolators(); //
+}
+
 
 // ============================================================================================
 // 1-bit indexed color mode:
@@ -410,13 +438,13 @@ void XRAM ScanlineRenderer<colormode_a1w4>(uint32* _dest, uint width, const uint
 	{
 		interp->set_pixels(*pixels++);
 
-		interp->set_color_base(uint32(attributes++));
+		interp->set_color_base(attributes++);
 		*dest++ = *interp->next_color();
 		*dest++ = *interp->next_color();
 		*dest++ = *interp->next_color();
 		*dest++ = *interp->next_color();
 
-		interp->set_color_base(uint32(attributes++));
+		interp->set_color_base(attributes++);
 		*dest++ = *interp->next_color();
 		*dest++ = *interp->next_color();
 		*dest++ = *interp->next_color();
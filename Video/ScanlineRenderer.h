@@ -51,6 +51,10 @@ using Color		= Graphics::Color;
 // called by VideoController
 extern void initializeInterpolators() noexcept;
 
+// setup the interpolators of core0 for dual-core rendering:
+// called by VideoController in the interrupt handler which saves and restores them
+extern void setupInterpolatorsOnCore0() noexcept;
+
 
 // _________________________________________________________________
 struct ScanlineRenderer_i1
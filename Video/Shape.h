@@ -9,6 +9,7 @@
 #include "Video.h"
 #include "cdefs.h"
 #include "geometry.h"
+#include "string.h"
 
 
 /* —————————————————————————————————————————————————————————
@@ -154,21 +155,33 @@ struct Shape
 
 	__always_inline void start(HotShape& hs, int x, bool ghostly) const noexcept
 	{
-		hs.init(pixels->pixels, x, ghostly);
+		hs.init(data, x, ghostly);
 	}
 
 	template<typename Pixmap>
 	Shape(const Pixmap& pm, int transp, const Dist& hotspot, const Color* clut) throws;
 	Shape() noexcept {}
 
+	// wrap encoded shape data, e.g. memory-mapped from a resource file in flash.
+	// the data must remain valid as long as the Shape is in use.
+	// the data is not copied unless it is not aligned to sizeof(Color), which is possible in a resource file.
+	Shape(const Color* data, uint8 width, uint8 height, const Dist& hotspot = Dist(0, 0)) throws;
+
+	// the encoded shape data, e.g. to store it in a resource file:
+	const Color* getData() const noexcept { return data; }
+
 	template<typename Pixmap>
 	static int calc_count(const Pixmap& pm, int transp, uint8* _height) noexcept;
 
+	// calculate the number of Colors in encoded shape data. the data may be misaligned.
+	static uint calc_count(const Color* data) noexcept;
+
 	template<typename Pixmap>
 	void create_shape(const Pixmap& pm, int transp, const Color* clut) noexcept;
 
 private:
-	RCPtr<Pixels> pixels;
+	RCPtr<Pixels> pixels;		  // if allocated
+	const Color*  data = nullptr; // -> pixels->pixels or wrapped data
 
 	uint8 _width  = 0;
 	uint8 _height = 0;
@@ -477,9 +490,49 @@ Shape::Shape(const Pixmap& pm, int transparent_pixel, const Dist& hotspot, const
 	int count = calc_count(pm, transparent_pixel, &_height);
 	pixels	  = Pixels::newPixels(uint(count));
 	assert(pixels->rc == 1);
+	data = pixels->pixels;
 	create_shape(pm, transparent_pixel, clut);
 }
 
+inline uint Shape::calc_count(const Color* data) noexcept
+{
+	// walk the rows like HotShape::skip_row() but read the data bytewise:
+	// PFX and CMD are 2 bytes, CMD starts with byte 0x80, CMD::END = 0x0080, CMD::GAP = 0x0180.
+
+	static_assert(sizeof(HotShape::PFX) == 2 && sizeof(HotShape::CMD) == 2);
+	static_assert(sizeof(HotShape::PFX) % sizeof(Color) == 0);
+
+	const uint8* p = reinterpret_cast<const uint8*>(data);
+	for (;;)
+	{
+		p += sizeof(HotShape::PFX) + p[1] * sizeof(Color); // PFX + pixels
+		if (p[0] != 0x80) continue;						   // PFX of next row
+		bool end = p[1] == 0;
+		p += sizeof(HotShape::CMD);
+		if (end) break;
+	}
+	return uint(p - reinterpret_cast<const uint8*>(data)) / sizeof(Color);
+}
+
+inline Shape::Shape(const Color* data, uint8 width, uint8 height, const Dist& hotspot) throws :
+	data(data),
+	_width(width),
+	_height(height),
+	_hot_x(int8(hotspot.dx)),
+	_hot_y(int8(hotspot.dy))
+{
+	assert(data);
+
+	if unlikely (size_t(data) & (alignof(Color) - 1))
+	{
+		// misaligned: make a copy
+		uint count = calc_count(data);
+		pixels	   = Pixels::newPixels(count);
+		memcpy(pixels->pixels, data, count * sizeof(Color));
+		this->data = pixels->pixels;
+	}
+}
+
 
 } // namespace kio::Video
 
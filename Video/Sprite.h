@@ -6,7 +6,11 @@
 #include "Frames.h"
 #include "geometry.h"
 #include "no_copy_move.h"
-#include <pico/sync.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <pico/sync.h>
+#endif
 
 namespace kio::Video
 {
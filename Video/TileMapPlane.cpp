@@ -0,0 +1,244 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "TileMapPlane.h"
+#include "basic_math.h"
+
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #define XRAM
+  #define RAM
+#else
+  #define XRAM __attribute__((section(".scratch_x.TM" __XSTRING(__LINE__))))	 // the 4k page with the core1 stack
+  #define RAM  __attribute__((section(".time_critical.TM" __XSTRING(__LINE__)))) // general ram
+#endif
+
+
+namespace kio::Video
+{
+using namespace Graphics;
+
+using uRGB = Color::uRGB;
+
+
+TileMapPlaneBase::TileMapPlaneBase(
+	RenderFu* render, const uint8* tile_pixels, int tile_row_offset, int tile_width, int atlas_height,
+	int bits_per_pixel, int map_width, int map_height, int tile_height, int max_width) throws :
+	VideoPlane(&vblank, render),
+	map_width(map_width),
+	map_height(map_height),
+	num_tiles(atlas_height / tile_height),
+	tile_width(tile_width),
+	tile_height(tile_height),
+	tile_pixels(tile_pixels),
+	tile_row_offset(tile_row_offset),
+	tile_row_bytes(tile_width * bits_per_pixel >> 3),
+	ss_tile_width(msbit(uint(tile_width))),
+	ss_tile_height(msbit(uint(tile_height))),
+	max_width(max_width)
+{
+	assert(map_width > 0 && map_height > 0);
+	assert(max_width > 0);
+
+	// max. number of tiles in a scanline, incl. partially visible tiles at both sides:
+	uint max_tiles		 = uint(max_width + 2 * tile_width - 2) >> ss_tile_width;
+	uint num_pixel_words = ((max_tiles << ss_tile_width) * uint(bits_per_pixel) >> 3) / sizeof(uint32) + 1;
+	uint num_color_words = (max_tiles << ss_tile_width) * sizeof(Color) / sizeof(uint32) + 1;
+
+	tilemap = new uint8[uint(map_width * map_height)];
+	pixels	= reinterpret_cast<uint8*>(new uint32[num_pixel_words]);
+	colors	= new uint32[num_color_words];
+	fill(0);
+}
+
+TileMapPlaneBase::~TileMapPlaneBase() noexcept
+{
+	delete[] tilemap;
+	delete[] reinterpret_cast<uint32*>(pixels);
+	delete[] colors;
+}
+
+void TileMapPlaneBase::fill(uint8 tile_idx) noexcept
+{
+	for (int i = 0; i < map_width * map_height; i++) tilemap[i] = tile_idx;
+}
+
+void RAM TileMapPlaneBase::vblank(VideoPlane* vp) noexcept
+{
+	TileMapPlaneBase* me = reinterpret_cast<TileMapPlaneBase*>(vp);
+
+	// latch and normalize the scroll position.
+	// no division here: this may be called during flash lockout.
+	// we apply the change since the last frame, which normally is small.
+
+	int w = me->map_width << me->ss_tile_width;
+	int h = me->map_height << me->ss_tile_height;
+
+	int scroll_x = me->scroll_x;
+	int scroll_y = me->scroll_y;
+	int x		 = me->latched_scroll_x + (scroll_x - me->last_scroll_x);
+	int y		 = me->latched_scroll_y + (scroll_y - me->last_scroll_y);
+	me->last_scroll_x = scroll_x;
+	me->last_scroll_y = scroll_y;
+
+	while (x < 0) x += w;
+	while (x >= w) x -= w;
+	while (y < 0) y += h;
+	while (y >= h) y -= h;
+
+	me->latched_scroll_x = x;
+	me->latched_scroll_y = y;
+	me->fine_x			 = x & (me->tile_width - 1);
+}
+
+template<typename T>
+static __force_inline void copy(uint8* z, const uint8* q, int count) noexcept
+{
+	// copy tile row. volatile, else the compiler may use memcpy() which is in rom!
+	volatile T* zz = reinterpret_cast<T*>(z);
+	const T*	qq = reinterpret_cast<const T*>(q);
+	for (int i = 0; i < count; i++) zz[i] = qq[i];
+}
+
+__force_inline const uint8* TileMapPlaneBase::assemble_scanline(int row, int width, int& num_tiles) noexcept
+{
+	// assemble the scanline from the tile rows into `pixels`.
+	// returns `pixels` and the number of tiles assembled.
+
+	// we don't rely on vblank() to reset a pointer: we use the row.
+	// so if we miss a scanline then only this scanline is missing.
+
+	int y  = row + latched_scroll_y;
+	int my = y >> ss_tile_height;
+	while (my >= map_height) my -= map_height;
+
+	int mx = latched_scroll_x >> ss_tile_width;
+
+	const uint8* map_row	 = tilemap + my * map_width;
+	int			 tile_offset = tile_row_offset << ss_tile_height;
+	const uint8* tile_rows	 = tile_pixels + (y & (tile_height - 1)) * tile_row_offset;
+	int			 nbytes		 = tile_row_bytes;
+	num_tiles				 = (width + fine_x + tile_width - 1) >> ss_tile_width;
+
+	uint8* z = pixels;
+	for (int i = 0; i < num_tiles; i++)
+	{
+		uint tile_idx = map_row[mx];
+		if (++mx == map_width) mx = 0;
+		if unlikely (tile_idx >= uint(this->num_tiles)) tile_idx = 0;
+
+		const uint8* q = tile_rows + int(tile_idx) * tile_offset;
+		if (nbytes >= 4) copy<uint32>(z, q, nbytes >> 2);
+		else if (nbytes == 2) copy<uint16>(z, q, 1);
+		else *z = *q;
+		z += nbytes;
+	}
+	return pixels;
+}
+
+__force_inline void TileMapPlaneBase::copy_scrolled(uint32* scanline, int width) noexcept
+{
+	// copy the visible part of the scanline rendered into `colors`:
+
+	const uRGB*	   q  = reinterpret_cast<const uRGB*>(colors) + fine_x;
+	volatile uRGB* zz = reinterpret_cast<uRGB*>(scanline);
+	for (int i = 0; i < width; i++) zz[i] = q[i];
+}
+
+
+// =========================================================================
+
+template<ColorMode CM>
+TileMapPlane<CM>::TileMapPlane(
+	const Pixmap* tiles, const ColorMap* cmap, int map_width, int map_height, int tile_height, int max_width) throws :
+	TileMapPlaneBase(
+		&render, tiles->pixmap, tiles->row_offset, tiles->width, tiles->height, 1 << CD, map_width, map_height,
+		tile_height, max_width),
+	tiles(tiles),
+	colormap(cmap ? cmap : &Graphics::system_colormap),
+	scanline_renderer(colormap->colors)
+{
+	if (tile_width != 8 && tile_width != 16) throw "TileMap: tile width must be 8 or 16";
+	if (tile_height < 1 || tile_height > 128 || tile_height != 1 << ss_tile_height)
+		throw "TileMap: tile height must be a power of 2";
+	if (num_tiles == 0) throw "TileMap: no tiles";
+	if (tile_row_offset % min(tile_row_bytes, 4)) throw "TileMap: tiles row offset misaligned";
+}
+
+template<>
+void XRAM TileMapPlane<colormode_i1>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
+{
+	TileMapPlane* me = reinterpret_cast<TileMapPlane*>(vp);
+
+	int			 num_tiles;
+	const uint8* pixels = me->assemble_scanline(row, width, num_tiles);
+	if (me->fine_x == 0) return me->scanline_renderer.render(scanline, uint(width), pixels);
+
+	// not aligned: render one more tile and copy the visible part:
+	me->scanline_renderer.render(me->colors, uint(num_tiles << me->ss_tile_width), pixels);
+	me->copy_scrolled(scanline, width);
+}
+
+template<>
+void XRAM TileMapPlane<colormode_i2>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
+{
+	TileMapPlane* me = reinterpret_cast<TileMapPlane*>(vp);
+
+	int			 num_tiles;
+	const uint8* pixels = me->assemble_scanline(row, width, num_tiles);
+	if (me->fine_x == 0) return me->scanline_renderer.render(scanline, uint(width), pixels);
+
+	me->scanline_renderer.render(me->colors, uint(num_tiles << me->ss_tile_width), pixels);
+	me->copy_scrolled(scanline, width);
+}
+
+template<>
+void XRAM TileMapPlane<colormode_i4>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
+{
+	TileMapPlane* me = reinterpret_cast<TileMapPlane*>(vp);
+
+	int			 num_tiles;
+	const uint8* pixels = me->assemble_scanline(row, width, num_tiles);
+	if (me->fine_x == 0) return me->scanline_renderer.render(scanline, uint(width), pixels);
+
+	me->scanline_renderer.render(me->colors, uint(num_tiles << me->ss_tile_width), pixels);
+	me->copy_scrolled(scanline, width);
+}
+
+template<>
+void XRAM TileMapPlane<colormode_i8>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
+{
+	TileMapPlane* me = reinterpret_cast<TileMapPlane*>(vp);
+
+	int			 num_tiles;
+	const uint8* pixels = me->assemble_scanline(row, width, num_tiles);
+	if (me->fine_x == 0) return me->scanline_renderer.render(scanline, uint(width), pixels);
+
+	me->scanline_renderer.render(me->colors, uint(num_tiles << me->ss_tile_width), pixels);
+	me->copy_scrolled(scanline, width);
+}
+
+template<>
+void XRAM TileMapPlane<colormode_rgb>::render(VideoPlane* vp, int row, int width, uint32* scanline) noexcept
+{
+	TileMapPlane* me = reinterpret_cast<TileMapPlane*>(vp);
+
+	int			 num_tiles;
+	const uint8* pixels = me->assemble_scanline(row, width, num_tiles);
+	if (me->fine_x == 0) return ScanlineRenderer_rgb(scanline, uint(width), pixels);
+
+	ScanlineRenderer_rgb(me->colors, uint(num_tiles << me->ss_tile_width), pixels);
+	me->copy_scrolled(scanline, width);
+}
+
+
+// =========================================================================
+// define them all, the linker will know what we need:
+
+template class TileMapPlane<colormode_i1>;
+template class TileMapPlane<colormode_i2>;
+template class TileMapPlane<colormode_i4>;
+template class TileMapPlane<colormode_i8>;
+template class TileMapPlane<colormode_rgb>;
+
+} // namespace kio::Video
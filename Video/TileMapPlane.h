@@ -0,0 +1,207 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "ColorMap.h"
+#include "Pixmap.h"
+#include "ScanlineRenderer.h"
+#include "VideoPlane.h"
+
+
+namespace kio::Video
+{
+
+/*	_____________________________________________________________________________________
+	Template class TileMapPlane displays a tiled background.
+
+	The screen is composed from tiles which are stored in a tile atlas.
+	The tile atlas is a Pixmap with the width of one tile and all tiles stacked vertically:
+		tile[n] starts at row n * tile_height.
+	The tile map is an array of tile indexes, map_width * map_height, one byte per tile.
+	The tile map may be larger or smaller than the screen and wraps around at the edges.
+
+	Scrolling is done by setting scroll_x and scroll_y. They are latched at the start of each frame.
+	At 640*480 with 8*8 tiles in colormode_i8 this needs 80*60 = 4.8 kB for the tile map,
+	tile_height * 8 bytes per tile in the atlas and ~2 kB for the scanline buffers
+	instead of 300 kB for a full-screen Pixmap.
+
+	Each scanline is assembled from the tile rows into a buffer in the Pixmap's format
+	and then rendered with the ScanlineRenderer for the ColorMode.
+
+	There is no tile cache and no dirty tracking: nothing rendered is kept between scanlines or frames,
+	so changes to the tile map or the atlas show up in the next scanline without invalidating anything.
+	A cache of tiles pre-rendered to Colors would need 2 bytes per pixel of every tile
+	and would use up most of the RAM saved by the tile map.
+
+	Supported are the direct color modes i1, i2, i4, i8 and rgb.
+	The tile width must be 8 or 16 pixels and the tile height must be a power of 2.
+*/
+template<ColorMode CM>
+class TileMapPlane;
+
+
+/*	_____________________________________________________________________________________
+	Base class with the color mode independent part of the TileMapPlanes.
+*/
+class TileMapPlaneBase : public VideoPlane
+{
+public:
+	Id("TileMap");
+
+	int	   map_width;  // in tiles
+	int	   map_height; // in tiles
+	int	   num_tiles;  // in the atlas
+	uint8* tilemap;	   // [map_height][map_width]
+
+	int tile_width;
+	int tile_height;
+
+	// hardware-style scrolling: offset of the top left pixel on screen in the tile map.
+	// these may be set at any time and are latched at the start of each frame.
+	int scroll_x = 0;
+	int scroll_y = 0;
+
+	uint8& tile(int x, int y) noexcept { return tilemap[y * map_width + x]; }
+	uint8  tile(int x, int y) const noexcept { return tilemap[y * map_width + x]; }
+	void   setTile(int x, int y, uint8 tile_idx) noexcept { tile(x, y) = tile_idx; }
+	void   fill(uint8 tile_idx) noexcept;
+	void   setScrollPosition(int x, int y) noexcept { scroll_x = x, scroll_y = y; }
+
+	// the vblank function for the video backend. public for unit tests.
+	static void vblank(VideoPlane*) noexcept;
+
+protected:
+	TileMapPlaneBase(
+		RenderFu*, const uint8* tile_pixels, int tile_row_offset, int tile_width, int atlas_height, int bits_per_pixel,
+		int map_width, int map_height, int tile_height, int max_width) throws;
+	~TileMapPlaneBase() noexcept override;
+
+	const uint8* assemble_scanline(int row, int width, int& num_tiles) noexcept;
+	void		 copy_scrolled(uint32* scanline, int width) noexcept;
+
+	const uint8* tile_pixels; // the tile atlas
+	int			 tile_row_offset;
+	int			 tile_row_bytes; // bytes per tile row in the atlas
+	int			 ss_tile_width;
+	int			 ss_tile_height;
+	int			 max_width;
+	int			 latched_scroll_x = 0; // 0 .. map_width*tile_width-1
+	int			 latched_scroll_y = 0; // 0 .. map_height*tile_height-1
+	int			 last_scroll_x	  = 0; // scroll_x at the last vblank
+	int			 last_scroll_y	  = 0; // scroll_y at the last vblank
+	int			 fine_x			  = 0; // latched_scroll_x within the tile
+	uint8*		 pixels;			   // scanline assembled from tile rows: max_width + 1 tile
+	uint32*		 colors;			   // rendered scanline for fine x scrolling: max_width + 1 tile
+};
+
+
+// the ScanlineRenderer for the ColorMode:
+// clang-format off
+template<ColorMode CM> struct TileMapRenderer;
+template<> struct TileMapRenderer<Graphics::colormode_i1> { using type = ScanlineRenderer_i1; };
+template<> struct TileMapRenderer<Graphics::colormode_i2> { using type = ScanlineRenderer_i2; };
+template<> struct TileMapRenderer<Graphics::colormode_i4> { using type = ScanlineRenderer_i4; };
+template<> struct TileMapRenderer<Graphics::colormode_i8> { using type = ScanlineRenderer_i8; };
+template<> struct TileMapRenderer<Graphics::colormode_rgb> { struct type { type(const Color*) noexcept {} }; };
+// clang-format on
+
+
+template<ColorMode CM>
+class TileMapPlane final : public TileMapPlaneBase
+{
+public:
+	static_assert(Graphics::is_direct_color(CM));
+
+	static constexpr Graphics::ColorDepth CD = Graphics::get_colordepth(CM);
+	using Pixmap							 = Graphics::Pixmap<CM>;
+	using ColorMap							 = Graphics::ColorMap<CD>;
+	using Renderer							 = typename TileMapRenderer<CM>::type;
+
+	/*
+		@param tiles       tile atlas: Pixmap with width = tile_width and all tiles stacked vertically.
+		@param colormap    colormap for indexed color modes, or nullptr for the system colormap.
+		@param map_width   width of the tile map, measured in tiles.
+		@param map_height  height of the tile map, measured in tiles.
+		@param tile_height height of the tiles: 1 .. 2^N .. 128
+		@param max_width   max. width of the screen (or the plane) in pixels.
+	*/
+	TileMapPlane(
+		const Pixmap* tiles, const ColorMap* colormap, int map_width, int map_height, int tile_height,
+		int max_width) throws;
+
+	RCPtr<const Pixmap>	  tiles;
+	RCPtr<const ColorMap> colormap;
+
+	// the render function for the video backend. public for unit tests.
+	static void render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+
+private:
+	Renderer scanline_renderer;
+};
+
+
+// the render functions are explicit specializations:
+// templates may put code in rom and the render functions must be in ram.
+
+template<>
+void TileMapPlane<Graphics::colormode_i1>::render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+template<>
+void TileMapPlane<Graphics::colormode_i2>::render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+template<>
+void TileMapPlane<Graphics::colormode_i4>::render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+template<>
+void TileMapPlane<Graphics::colormode_i8>::render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+template<>
+void TileMapPlane<Graphics::colormode_rgb>::render(VideoPlane*, int row, int width, uint32* scanline) noexcept;
+
+
+//	_____________________________________________________________________________________
+//  declare implementation in another file:
+
+extern template class TileMapPlane<Graphics::colormode_i1>;
+extern template class TileMapPlane<Graphics::colormode_i2>;
+extern template class TileMapPlane<Graphics::colormode_i4>;
+extern template class TileMapPlane<Graphics::colormode_i8>;
+extern template class TileMapPlane<Graphics::colormode_rgb>;
+
+} // namespace kio::Video
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
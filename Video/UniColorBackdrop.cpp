@@ -17,7 +17,9 @@ using namespace Graphics;
 UniColorBackdrop::UniColorBackdrop(Color color) noexcept :
 	VideoPlane(do_vblank, &render),
 	color(Graphics::flood_filled_color<Graphics::colordepth_rgb>(color))
-{}
+{
+	reentrant = true;
+}
 
 void RAM UniColorBackdrop::render(VideoPlane* vp, int __unused row, int width, uint32* fbu) noexcept
 {
@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "VerticalLayout.h"
+#include "PlaneProfiler.h"
 #include <cstdio>
 #include <hardware/gpio.h>
 
@@ -77,7 +78,7 @@ void RAM VerticalLayout<2>::do_render(VideoPlane* vp, int row, int width, uint32
 	}
 
 	vp = pp->vp;
-	vp->render_fu(vp, row - top, width, fbu);
+	render_plane(vp, row - top, width, fbu);
 }
 
 
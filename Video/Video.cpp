@@ -3,7 +3,9 @@
 // https://spdx.org/licenses/BSD-2-Clause.html
 
 #include "Video.h"
+#include "PlaneProfiler.h"
 #include "ScanlineBuffer.h"
+#include "ScanlineQueue.h"
 #include "ScanlineRenderer.h"
 #include "VideoBackend.h"
 #include "VideoPlane.h"
@@ -16,6 +18,9 @@
 #include "common/timing.h"
 #include <cstdio>
 #include <hardware/exception.h>
+#include <hardware/interp.h>
+#include <hardware/irq.h>
+#include <hardware/timer.h>
 #include <pico/multicore.h>
 
 
@@ -106,6 +111,14 @@ static uint32		  requested_system_clock;
 
 static spin_lock_t* spinlock = nullptr;
 
+// dual-core rendering:
+static ScanlineQueue<>	scanline_queue;
+static volatile bool	dual_core_requested = false;
+static bool				dual_core			= false; // latched by core1 in vblank
+static int				doorbell_alarm		= -1;	 // hardware alarm whose irq is forced to wake core0
+static volatile uint	late_scanlines		= 0;	 // rendered too late by core0
+static uint32			cc_max_ahead		= 0;	 // max. time from start of rendering to display of a scanline
+
 struct Locker
 {
 	uint32 state; // status register
@@ -116,6 +129,24 @@ struct Locker
 static void core1_runner() noexcept;
 static void video_runner(int row0, uint32 cc_at_line_start);
 
+static __force_inline void render_planes(int row, uint32* scanline) noexcept
+{
+	for (uint i = 0; i < num_planes; i++)
+	{
+		VideoPlane* vp = planes[i];
+		//gpio_set_mask(1 << PICO_DEFAULT_LED_PIN);
+		render_plane(vp, row, vga_mode.width, scanline);
+		//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
+	}
+}
+
+static __force_inline bool planes_are_reentrant() noexcept
+{
+	for (uint i = 0; i < num_planes; i++)
+		if (!planes[i]->reentrant) return false;
+	return true;
+}
+
 
 // =========================================================
 
@@ -150,6 +181,7 @@ void startVideo(const VgaMode& mode, uint32 system_clock, uint scanline_buffer_c
 
 	vga_mode = mode;
 	USB::setMouseLimits(mode.width, mode.height);
+	if constexpr (profile_planes) resetPlaneProfiles();
 	scanline_buffer.setup(vga_mode, scanline_buffer_count); // throws
 	requested_system_clock = system_clock;
 	requested_state		   = RUNNING;
@@ -206,8 +238,8 @@ static void __noreturn core1_runner() noexcept
 				__sev();
 
 				{ // setup calculations for video_runner() done here in flash to save ram:
-					uint32 cc_max_ahead = (scanline_buffer.count - 1) * cc_per_scanline +
-										  ((vga_mode.h_total() - vga_mode.h_active()) + 18) * cc_per_px + 50 + 50;
+					cc_max_ahead = (scanline_buffer.count - 1) * cc_per_scanline +
+								   ((vga_mode.h_total() - vga_mode.h_active()) + 18) * cc_per_px + 50 + 50;
 				a:
 					int	   row0 = line_at_frame_start; // rolling number
 					uint32 cc_at_line_start =
@@ -309,10 +341,19 @@ static void RAM video_runner(int row0, uint32 cc_at_line_start)
 			scanlines_missed += uint(missed);
 			cc_at_line_start += uint(missed) * cc_per_scanline;
 			row += missed;
+			if constexpr (profile_planes) profile_scanlines_missed(uint(missed));
 		}
+		if constexpr (profile_planes) profile_next_scanline();
 
 		if unlikely (row >= vga_mode.height) // next frame
 		{
+			scanline_queue.wait_idle(); // core0 must finish it's scanlines before vblank
+			if (uint late = late_scanlines)
+			{
+				late_scanlines = 0;
+				scanlines_missed += late;
+			}
+			uint32 cc_at_vblank = profile_planes ? time_cc_32() : 0;
 			if (!locked_out) call_vblank_actions(); // in rom: only if !lockout
 
 			for (uint i = 0; i < num_planes; i++)
@@ -322,6 +363,9 @@ static void RAM video_runner(int row0, uint32 cc_at_line_start)
 				vp->vblank_fu(vp);
 				//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
 			}
+			if constexpr (profile_planes) profile_vblank(time_cc_32() - cc_at_vblank);
+
+			dual_core = dual_core_requested && planes_are_reentrant();
 
 			// the pixel dma starts reading the first pixels of a scanline
 			// (8+1)*2 = 18 pixels before the end of the previous line
@@ -335,13 +379,7 @@ static void RAM video_runner(int row0, uint32 cc_at_line_start)
 			row0 += vga_mode.height;
 
 			while (int(time_cc_32() - cc_at_line_start) < 0) {}
-			for (uint i = 0; i < num_planes; i++)
-			{
-				VideoPlane* vp = planes[i];
-				//gpio_set_mask(1 << PICO_DEFAULT_LED_PIN);
-				vp->render_fu(vp, 0 /*row*/, vga_mode.width, scanline_buffer[row0]);
-				//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
-			}
+			render_planes(0 /*row*/, scanline_buffer[row0]);
 
 			cc_at_line_start -= uint(row) * cc_per_scanline;
 			cc_at_line_start += cc_per_frame + cc_per_scanline;
@@ -354,6 +392,7 @@ static void RAM video_runner(int row0, uint32 cc_at_line_start)
 
 			if (lockout_requested != locked_out)
 			{
+				scanline_queue.wait_idle(); // core0 must not render during lockout
 				locked_out = lockout_requested;
 				__sev();
 			}
@@ -361,14 +400,55 @@ static void RAM video_runner(int row0, uint32 cc_at_line_start)
 		idle_end();
 
 		uint32* scanline = scanline_buffer[row0 + row];
-		for (uint i = 0; i < num_planes; i++)
+		if (dual_core && (row & 1) && !locked_out && scanline_queue.put(row, scanline, cc_at_line_start + cc_max_ahead))
 		{
-			VideoPlane* vp = planes[i];
-			//gpio_set_mask(1 << PICO_DEFAULT_LED_PIN);
-			vp->render_fu(vp, row, vga_mode.width, scanline);
-			//gpio_clr_mask(1 << PICO_DEFAULT_LED_PIN);
+			// odd rows are rendered by core0:
+			hw_set_bits(&timer_hw->intf, 1u << doorbell_alarm); // doorbell
 		}
+		else render_planes(row, scanline);
 	}
+
+	scanline_queue.wait_idle();
+}
+
+static void RAM core0_render_isr() noexcept
+{
+	// render the scanlines queued by core1.
+	// we may have interrupted a program which uses the interpolators:
+
+	hw_clear_bits(&timer_hw->intf, 1u << doorbell_alarm);
+
+	interp_hw_save_t save0, save1;
+	interp_save(interp0, &save0);
+	interp_save(interp1, &save1);
+	setupInterpolatorsOnCore0();
+
+	scanline_queue.render_all([](int row, uint32* scanline, uint32 deadline) {
+		render_planes(row, scanline);
+		if (int(time_cc_32() - deadline) > 0) late_scanlines = late_scanlines + 1;
+	});
+
+	interp_restore(interp0, &save0);
+	interp_restore(interp1, &save1);
+}
+
+void setDualCoreRendering(bool f) noexcept
+{
+	assert(get_core_num() == 0);
+
+	if (f && doorbell_alarm < 0)
+	{
+		// core1 wakes core0 by forcing the irq of an otherwise unused hardware alarm.
+		// the irq is only enabled on core0. the SIO FIFO is left to other users.
+		// the isr stays installed: late scanlines are rendered after dual-core rendering was switched off.
+		int alarm = hardware_alarm_claim_unused(false);
+		if (alarm < 0) return; // no alarm available: no dual-core rendering
+		irq_set_exclusive_handler(TIMER_IRQ_0 + uint(alarm), core0_render_isr);
+		doorbell_alarm = alarm;
+		irq_set_enabled(TIMER_IRQ_0 + uint(alarm), true);
+	}
+
+	dual_core_requested = f; // latched by core1 in next vblank
 }
 
 void addVideoPlane(VideoPlanePtr plane, bool wait)
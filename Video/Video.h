@@ -7,8 +7,12 @@
 #include "VideoPlane.h"
 #include "timing.h"
 #include <functional>
-#include <pico/sem.h>
-#include <pico/types.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "LoadSensor.h"
+#else
+  #include <pico/sem.h>
+  #include <pico/types.h>
+#endif
 
 
 namespace kio::Video
@@ -117,8 +121,24 @@ extern void addOneTimeAction(const OneTimeAction& fu) noexcept;
 */
 extern bool isVideoRunning() noexcept;
 
+/*	enable or disable dual-core rendering.
+	then core1 renders the even rows and passes the odd rows through a ScanlineQueue to core0,
+	which renders them in an interrupt. So each core has the time of 2 scanlines per row
+	which allows about twice the pixel clock for cpu-heavy color modes.
+	- only used if all VideoPlanes are `reentrant`, else core1 renders all rows as usual.
+	- takes effect in the next vblank. not used during flash lockout.
+	- core1 triggers the interrupt on core0 with the irq of an unused hardware alarm which is claimed
+	  on first use. If no hardware alarm is available then dual-core rendering is not enabled.
+	- rows which core0 renders too late are counted in scanlines_missed in the next vblank.
+	- use scanline_buffer_count >= 4 in startVideo().
+	- the interrupt handler saves and restores the interpolators of core0.
+	- suspend_core1() must be called with interrupts enabled.
+	- must be called on core0.
+*/
+extern void setDualCoreRendering(bool) noexcept;
+
 
-extern uint			 scanlines_missed;
+extern uint			 scanlines_missed; // see also PlaneProfiler.h
 extern volatile bool locked_out;
 
 } // namespace kio::Video
@@ -4,8 +4,13 @@
 
 #include "VideoPlane.h"
 
-#define XRAM __attribute__((section(".scratch_x.VP" __XSTRING(__LINE__))))	   // the 4k page with the core1 stack
-#define RAM	 __attribute__((section(".time_critical.VP" __XSTRING(__LINE__)))) // general ram
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #define XRAM
+  #define RAM
+#else
+  #define XRAM __attribute__((section(".scratch_x.VP" __XSTRING(__LINE__))))	 // the 4k page with the core1 stack
+  #define RAM  __attribute__((section(".time_critical.VP" __XSTRING(__LINE__)))) // general ram
+#endif
 
 namespace kio::Video
 {
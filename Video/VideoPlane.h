@@ -61,6 +61,13 @@ public:
 	VblankFu* vblank_fu = nullptr;
 	RenderFu* render_fu = nullptr;
 
+	/*
+		set by subclasses whose render_fu() only depends on `row` and not on state advanced by the
+		previous scanline, so that it can be called for different rows on both cores at the same time.
+		see setDualCoreRendering().
+	*/
+	bool reentrant = false;
+
 protected:
 	// default vblank and render functions:
 	// these call the virtual vblank() and render() functions unless the flash is locked out.
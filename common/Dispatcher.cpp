@@ -6,15 +6,23 @@
 #include "LoadSensor.h"
 #include "Trace.h"
 #include "cdefs.h"
+#include <cstdarg>
 #include <cstdio>
-#include <pico/sync.h>
+#include <cstdlib>
+#include <cstring>
 
-#ifndef PICO_DEFAULT_LED_PIN
-  #include <pico/cyw43_arch.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <pico/sync.h>
+  #ifndef PICO_DEFAULT_LED_PIN
+	#include <pico/cyw43_arch.h>
+  #endif
 #endif
 
+// number of tasks which can be scheduled before the task list must grow:
 #ifndef DISPATCHER_MAX_TASKS
-  #define DISPATCHER_MAX_TASKS 10
+  #define DISPATCHER_MAX_TASKS 16
 #endif
 
 
@@ -23,9 +31,14 @@ namespace kio
 namespace Dispatcher
 {
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+static uint32 lock() noexcept { return 0; }
+static void	  unlock(uint32) noexcept {}
+#else
 static spin_lock_t* spinlock = spin_lock_instance(next_striped_spin_lock_num());
 static uint32		lock() noexcept { return spin_lock_blocking(spinlock); }
 static void			unlock(uint32 sr) noexcept { spin_unlock(spinlock, sr); }
+#endif
 
 struct Lock
 {
@@ -39,10 +52,24 @@ struct Task
 	Handler* handler;
 	void*	 data;
 	CC		 when;
+	uint32	 seq; // tasks with the same time are called in the order they were added
+
+	bool operator<(const Task& o) const noexcept { return when < o.when || (when == o.when && int(seq - o.seq) < 0); }
 };
 
-static Task	 tasks[DISPATCHER_MAX_TASKS];
-static uint8 num_tasks = 0;
+/*	The tasks are stored in a binary min-heap:
+	tasks[0] is the next task to run and tasks[i] runs before tasks[2i+1] and tasks[2i+2].
+	Adding and running a task is O(log n), removing a task needs a linear search.
+	The list starts in a static array and grows on the heap if needed.
+	`next_when` is a copy of tasks[0].when for the quick check in run() without the lock,
+	because grow() may free the array.
+*/
+static Task			   initial_tasks[DISPATCHER_MAX_TASKS];
+static Task*		   tasks	 = initial_tasks;
+static uint			   max_tasks = DISPATCHER_MAX_TASKS;
+static uint			   num_tasks = 0;
+static uint32		   next_seq	 = 0;
+static volatile uint32 next_when = 0; // valid if num_tasks != 0
 
 
 static inline CC now() noexcept
@@ -56,32 +83,134 @@ static void wfe_or_timeout(int timeout_usec) noexcept
 	//instead of #include "utilities.h":
 	if (timeout_usec > 0)
 	{
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
 		idle_start();
 		::best_effort_wfe_or_timeout(from_us_since_boot(time_us_64() + uint(timeout_usec)));
 		idle_end();
+#endif
+	}
+}
+
+#if DISPATCHER_STATISTICS
+static Statistics statistics[DISPATCHER_STATISTICS];
+static uint		  num_statistics = 0;
+
+static void record(const Task& task, CC start, CC end, int delay) noexcept
+{
+	// record the call of a task. must be called with lock held.
+
+	uint i = 0;
+	while (i < num_statistics && (statistics[i].handler != task.handler || statistics[i].data != task.data)) i++;
+	if (i == num_statistics)
+	{
+		if (i == DISPATCHER_STATISTICS) return; // table full
+		num_statistics++;
+		statistics[i] = Statistics {task.handler, task.data, 0, 0, ~0u, 0, 0, 0, 0};
+	}
+
+	Statistics& s		 = statistics[i];
+	uint32		latency	 = uint32(start - task.when);
+	uint32		duration = uint32(end - start);
+
+	s.num_calls += 1;
+	s.num_overruns += delay < 0 && end > task.when - delay;
+	s.min_latency = min(s.min_latency, latency);
+	s.max_latency = max(s.max_latency, latency);
+	s.total_latency += latency;
+	s.max_duration = max(s.max_duration, duration);
+	s.total_duration += duration;
+}
+
+bool getStatistics(uint i, Statistics& s) noexcept
+{
+	Lock _;
+	if (i >= num_statistics) return false;
+	s = statistics[i];
+	return true;
+}
+
+void resetStatistics() noexcept
+{
+	Lock _;
+	num_statistics = 0;
+}
+
+void printStatistics() noexcept
+{
+	struct Stdout
+	{
+		void printf(cstr fmt, ...) __printflike(2, 3)
+		{
+			va_list va;
+			va_start(va, fmt);
+			vprintf(fmt, va);
+			va_end(va);
+		}
+	} out;
+	printStatistics(&out);
+}
+#endif
+
+static void grow(uint new_max) noexcept
+{
+	// grow the task list. must be called with lock held.
+
+	Task* new_tasks = reinterpret_cast<Task*>(malloc(new_max * sizeof(Task)));
+	if (!new_tasks) panic("Dispatcher: out of memory");
+	memcpy(new_tasks, tasks, num_tasks * sizeof(Task));
+	if (tasks != initial_tasks) free(tasks);
+	tasks	  = new_tasks;
+	max_tasks = new_max;
+}
+
+static void sift_up(uint i, Task task) noexcept
+{
+	while (i > 0)
+	{
+		uint parent = (i - 1) / 2;
+		if (!(task < tasks[parent])) break;
+		tasks[i] = tasks[parent];
+		i		 = parent;
 	}
+	tasks[i] = task;
 }
 
-static inline void remove(int i)
+static void sift_down(uint i, Task task) noexcept
 {
-	for (num_tasks--; i < num_tasks; i++) { tasks[i] = tasks[i + 1]; }
+	for (;;)
+	{
+		uint child = 2 * i + 1;
+		if (child >= num_tasks) break;
+		if (child + 1 < num_tasks && tasks[child + 1] < tasks[child]) child += 1;
+		if (!(tasks[child] < task)) break;
+		tasks[i] = tasks[child];
+		i		 = child;
+	}
+	tasks[i] = task;
 }
 
-static void add(Handler* handler, const void* data, CC when)
+static void remove(uint i) noexcept
 {
-	assert(num_tasks < NELEM(tasks));
-	int i = num_tasks++;
-	for (; i - 1 >= 0 && tasks[i - 1].when < when; i--) { tasks[i] = tasks[i - 1]; }
-	Task& task	 = tasks[i];
-	task.handler = handler;
-	task.data	 = const_cast<void*>(data);
-	task.when	 = when;
+	Task last = tasks[--num_tasks];
+	if (i < num_tasks)
+	{
+		if (i > 0 && last < tasks[(i - 1) / 2]) sift_up(i, last);
+		else sift_down(i, last);
+	}
+	if (num_tasks) next_when = uint(tasks[0].when);
+}
+
+static void add(Handler* handler, const void* data, CC when) noexcept
+{
+	if unlikely (num_tasks == max_tasks) grow(max_tasks * 2);
+	sift_up(num_tasks++, Task {handler, const_cast<void*>(data), when, next_seq++});
+	next_when = uint(tasks[0].when);
 	//__sev();  may be triggered by caller if needed <hardware/sync.h>
 }
 
-static int index_of(Handler* handler, const void* data)
+static int index_of(Handler* handler, const void* data) noexcept
 {
-	int i = num_tasks;
+	int i = int(num_tasks);
 	while (--i >= 0)
 	{
 		if (tasks[i].handler == handler && tasks[i].data == data) break;
@@ -89,6 +218,12 @@ static int index_of(Handler* handler, const void* data)
 	return i;
 }
 
+void reserve(uint n)
+{
+	Lock _;
+	if (n > max_tasks) grow(n);
+}
+
 void addWithDelay(Handler* handler, const void* data, int32 delay)
 {
 	Lock _;
@@ -117,45 +252,47 @@ void removeHandler(Handler* handler, const void* data)
 {
 	Lock _;
 	int	 i = index_of(handler, data);
-	if (i >= 0) remove(i);
+	if (i >= 0) remove(uint(i));
 }
 
 void run(int timeout) noexcept
 {
 	if (timeout)
 	{
-		uint8 n = num_tasks;
-		wfe_or_timeout(n ? min(timeout, tasks[n - 1].when - now()) : timeout);
+		uint n = num_tasks;
+		wfe_or_timeout(n ? min(timeout, CC(next_when) - now()) : timeout);
 	}
 
-	uint8 n = const_cast<volatile uint8&>(num_tasks);
+	uint n = const_cast<volatile uint&>(num_tasks);
 	if (n == 0) return;
-	if (tasks[n - 1].when > now()) return;
+	if (CC(next_when) > now()) return;
 
 	trace("Dispatcher::run");
 
 	uint zz = lock();
 
-	if (uint8 n = const_cast<volatile uint8&>(num_tasks))
+	if (num_tasks && now() >= tasks[0].when)
 	{
-		Task&	 task	 = tasks[--n];
-		Handler* handler = task.handler;
-		void*	 data	 = task.data;
-		CC		 when	 = task.when;
+		Task task = tasks[0];
+		remove(0);
+		unlock(zz);
+		//printf("call %s\n", cstr(task.data));
+#if DISPATCHER_STATISTICS
+		CC start = now();
+#endif
+		int delay = task.handler(task.data);
+#if DISPATCHER_STATISTICS
+		CC end = now();
+#endif
+		zz = lock();
+#if DISPATCHER_STATISTICS
+		record(task, start, end, delay);
+#endif
 
-		if (now() >= when)
+		if (delay) // reschedule
 		{
-			num_tasks = n;
-			unlock(zz);
-			//printf("call %s\n", cstr(data));
-			int delay = handler(data);
-			zz		  = lock();
-
-			if (delay) // reschedule
-			{
-				when = delay >= 0 ? now() + delay : when - delay;
-				add(handler, data, when);
-			}
+			CC when = delay >= 0 ? now() + delay : task.when - delay;
+			add(task.handler, task.data, when);
 		}
 	}
 
@@ -165,6 +302,8 @@ void run(int timeout) noexcept
 } // namespace Dispatcher
 
 
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
+
 int blinkOnboardLed(void*) noexcept
 {
 	trace(__func__);
@@ -198,6 +337,8 @@ int blinkOnboardLed(void*) noexcept
 #endif
 }
 
+#endif
+
 } // namespace kio
 
 
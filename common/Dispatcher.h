@@ -8,8 +8,15 @@
 /*
 	The Dispatcher allows you to run state machines in parallel to the main program
 	and to convert interrupts into synchronous events.
+
+	If DISPATCHER_STATISTICS is set to the max. number of handlers to track then the Dispatcher
+	records for each handler how late it was started and how long it ran. Else this costs nothing.
 */
 
+#ifndef DISPATCHER_STATISTICS
+  #define DISPATCHER_STATISTICS 0
+#endif
+
 namespace kio
 {
 namespace Dispatcher
@@ -36,6 +43,13 @@ extern void addIfNew(Handler*, const void* data = nullptr);
 extern void addWithDelay(Handler*, const void* data, int32 delay);
 extern void addAtTime(Handler*, const void* data, CC when);
 
+/*	Preallocate space for n handlers.
+		The task list starts with room for DISPATCHER_MAX_TASKS handlers and grows on demand.
+		Growing allocates memory on the heap which should not happen in an interrupt handler.
+		If you add handlers from interrupts then reserve enough space in advance.
+	*/
+extern void reserve(uint n);
+
 /*	Remove a handler, either identified by the function or if needed by function and data.
 		Be cautious if you remove a handler from an interrupt or from core 1:
 		In a race condition the handler may be still executed while or after you removed it.
@@ -45,6 +59,7 @@ extern void removeHandler(Handler*, const void* data = nullptr);
 
 /*	Run the next handler if scheduled time is reached.
 		Always calls only one handler at a time.
+		Handlers scheduled for the same time are called in the order they were added.
 		If timeout>0 then wait for timeout or the next scheduled time. ("idle")
 	***	Returns quickly if timeout==0 and no handler needs to run  
 		to allow frequent polling by the main program.
@@ -56,6 +71,58 @@ extern void removeHandler(Handler*, const void* data = nullptr);
 	*/
 extern void run(int timeout = 0) noexcept;
 
+
+#if DISPATCHER_STATISTICS
+
+/*	Statistics for one handler, identified by function and data.
+		latency:  time in µs from the scheduled time to the actual start of the handler.
+		jitter:   max_latency - min_latency.
+		duration: run time of the handler in µs.
+		overruns: number of calls where the handler returned after it's next drift-free call was due.
+	*/
+struct Statistics
+{
+	Handler*	handler;
+	const void* data;
+	uint32		num_calls;
+	uint32		num_overruns;
+	uint32		min_latency;
+	uint32		max_latency;
+	uint64		total_latency;
+	uint32		max_duration;
+	uint64		total_duration;
+
+	uint32 jitter() const noexcept { return max_latency - min_latency; }
+	uint32 avg_latency() const noexcept { return num_calls ? uint32(total_latency / num_calls) : 0; }
+	uint32 avg_duration() const noexcept { return num_calls ? uint32(total_duration / num_calls) : 0; }
+};
+
+/*	Get the statistics for the i-th handler.
+		Returns false if i >= number of handlers seen so far.
+		Statistics are collected for up to DISPATCHER_STATISTICS handlers.
+	*/
+extern bool getStatistics(uint i, Statistics&) noexcept;
+extern void resetStatistics() noexcept;
+
+/*	Print the statistics to a SerialDevice, TextVDU or anything else which has printf().
+		printStatistics() prints to stdout like dump_heap().
+	*/
+template<typename Printer>
+void printStatistics(Printer* out)
+{
+	Statistics s;
+	out->printf("Dispatcher: latency/duration in µs: avg max jitter / avg max\n");
+	for (uint i = 0; getStatistics(i, s); i++)
+	{
+		out->printf(
+			"%p(%p): calls=%u lat=%u %u %u dur=%u %u overruns=%u\n", reinterpret_cast<void*>(s.handler), s.data,
+			s.num_calls, s.avg_latency(), s.max_latency, s.jitter(), s.avg_duration(), s.max_duration, s.num_overruns);
+	}
+}
+extern void printStatistics() noexcept;
+
+#endif
+
 } // namespace Dispatcher
 
 
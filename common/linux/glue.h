@@ -38,6 +38,13 @@ extern void flash_range_program(uint32 flash_offs, const uint8* data, uint32 cou
 } // namespace kio
 
 
+#ifndef __force_inline
+  #define __force_inline inline __attribute__((always_inline))
+#endif
+#ifndef __section
+  #define __section(S)
+#endif
+
 #define kilipili_lock_spinlock()   (void)0
 #define kilipili_unlock_spinlock() (void)0
 
@@ -45,6 +52,75 @@ extern void flash_range_program(uint32 flash_offs, const uint8* data, uint32 cou
 #define restore_interrupts(o)		  (void)(o)
 #define get_core_num()				  0
 
+// spinlocks: the desktop_tools are single-threaded where they use them:
+using spin_lock_t = volatile uint32;
+inline spin_lock_t* spin_lock_init(uint) noexcept
+{
+	static spin_lock_t lock = 0;
+	return &lock;
+}
+inline int	  spin_lock_claim_unused(bool) noexcept { return 0; }
+inline uint32 spin_lock_blocking(spin_lock_t* lock) noexcept { return *lock = 1, 0; }
+inline void	  spin_unlock(spin_lock_t* lock, uint32) noexcept { *lock = 0; }
+inline bool	  is_spin_locked(spin_lock_t* lock) noexcept { return *lock; }
+
+
+// #######################################################################
+// GPIO, SPI and DMA as used by the SDCard:
+// setup functions are no-ops, the data transfer functions are defined in the unit test.
+
+enum gpio_function { GPIO_FUNC_SPI = 1 };
+#define GPIO_OUT 1
+inline void gpio_init(uint) noexcept {}
+inline void gpio_set_dir(uint, bool) noexcept {}
+inline void gpio_set_function(uint, gpio_function) noexcept {}
+inline void gpio_pull_up(uint) noexcept {}
+extern void gpio_put(uint gpio, bool value);
+
+struct spi_inst
+{
+	volatile uint32 dr;
+};
+using spi_inst_t = spi_inst;
+using spi_hw_t	 = spi_inst;
+enum spi_cpol_t { SPI_CPOL_0, SPI_CPOL_1 };
+enum spi_cpha_t { SPI_CPHA_0, SPI_CPHA_1 };
+enum spi_order_t { SPI_LSB_FIRST, SPI_MSB_FIRST };
+extern spi_inst* const spi0;
+extern spi_inst* const spi1;
+inline uint			   spi_init(spi_inst*, uint baudrate) noexcept { return baudrate; }
+inline void			   spi_set_format(spi_inst*, uint, spi_cpol_t, spi_cpha_t, spi_order_t) noexcept {}
+inline spi_hw_t*	   spi_get_hw(spi_inst* spi) noexcept { return spi; }
+inline uint			   spi_get_dreq(spi_inst* spi, bool is_tx) noexcept { return (spi == spi1) * 2 + !is_tx; }
+extern int			   spi_read_blocking(spi_inst*, uint8 repeated_tx_data, uint8* dst, size_t len);
+extern int			   spi_write_blocking(spi_inst*, const uint8* src, size_t len);
+extern int			   spi_write_read_blocking(spi_inst*, const uint8* src, uint8* dst, size_t len);
+
+enum dma_channel_transfer_size { DMA_SIZE_8, DMA_SIZE_16, DMA_SIZE_32 };
+struct dma_channel_config
+{
+	bool					  read_increment  = true;
+	bool					  write_increment = false;
+	uint					  dreq			  = 0x3f;
+	dma_channel_transfer_size size			  = DMA_SIZE_32;
+};
+inline dma_channel_config dma_channel_get_default_config(uint) noexcept { return dma_channel_config {}; }
+inline void channel_config_set_read_increment(dma_channel_config* c, bool f) noexcept { c->read_increment = f; }
+inline void channel_config_set_write_increment(dma_channel_config* c, bool f) noexcept { c->write_increment = f; }
+inline void channel_config_set_dreq(dma_channel_config* c, uint dreq) noexcept { c->dreq = dreq; }
+inline void channel_config_set_transfer_data_size(dma_channel_config* c, dma_channel_transfer_size size) noexcept
+{
+	c->size = size;
+}
+extern int	dma_claim_unused_channel(bool required);
+extern void dma_channel_unclaim(uint channel);
+extern void dma_channel_configure(
+	uint channel, const dma_channel_config*, volatile void* write_addr, const volatile void* read_addr, uint count,
+	bool trigger);
+extern void dma_start_channel_mask(uint32 mask);
+extern bool dma_channel_is_busy(uint channel);
+extern void dma_channel_abort(uint channel);
+
 /*
 
 
@@ -7,14 +7,21 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <hardware/sync.h>
 #include <new>
-#include <pico.h>
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #include "glue.h"
+#else
+  #include <hardware/sync.h>
+  #include <pico.h>
+#endif
 
 
 /*
 	ATTN: This file must be linked into the exectutable directly, not in a library,
 	else parts of the application may use this version and others use the stdlib version of malloc.
+
+	In desktop_tools this file is compiled for benchmarks and tests: then it works in a static array
+	and all functions are put in namespace MALLOC_HOST_NAMESPACE to not replace the host's malloc.
 */
 
 
@@ -38,6 +45,14 @@
   #define MALLOC_SPINLOCK_NUMBER PICO_SPINLOCK_ID_OS2
 #endif
 
+#ifndef MALLOC_SIZE_CLASSES
+  #define MALLOC_SIZE_CLASSES 16 // number of free lists for small chunks, 0 = disabled
+#endif
+
+#ifndef MALLOC_CACHE_LIMIT
+  #define MALLOC_CACHE_LIMIT 8 // max. number of chunks in each free list
+#endif
+
 
 #if MALLOC_EXTENDED_VALIDATION || defined DEBUG
 static constexpr bool extended_validation = true;
@@ -89,6 +104,12 @@ void operator delete[](void* p, __unused size_t n) noexcept { free(p); }
 #endif
 
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+namespace MALLOC_HOST_NAMESPACE
+{
+#endif
+
+
 /*	_________________________________________________________________________________________________
 	The heap occupies the space between `end` and `__StackLimit`, which are calculated by the linker.
 
@@ -97,8 +118,25 @@ void operator delete[](void* p, __unused size_t n) noexcept { free(p); }
 	Therefore the next chunk after uint32* p can be reached by p += *p.
 
 	The upper bits of the `size` word are used to indicate used or free and to provide minimal validation.
+
+	Small chunks are not released into the heap by free() but put into a free list for their size
+	from where malloc() can reuse them without searching the heap. These chunks are marked as 'cached'.
+	Cached chunks can't be merged with adjacent free chunks, which fragments the heap.
+	Therefore each free list holds at most MALLOC_CACHE_LIMIT chunks, further chunks are freed normally.
+	They are released into the heap if malloc() fails to find a free chunk, and then malloc() tries again.
+	heap_largest_free_block() counts them as free.
+
+	`first_free` remembers the position below which there are no free chunks.
+	Thereby malloc() does not need to skip over the many used chunks at the start of the heap every time.
 */
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+constexpr uint32 sram_size = 256 * 1024;
+static uint32	 host_heap[200 * 1024 / 4];
+
+constexpr uint32* heap_start = host_heap;
+constexpr uint32* heap_end	 = host_heap + sizeof(host_heap) / 4;
+#else
 // defined by linker:
 extern uint32 end;
 extern uint32 __HeapLimit;
@@ -109,15 +147,25 @@ constexpr uint32* heap_start = &end;
 constexpr uint32* heap_end	 = &__StackLimit;
 
 constexpr uint32 sram_size = SRAM_STRIPED_END - SRAM_STRIPED_BASE;
+#endif
 static_assert((sram_size & (sram_size - 1)) == 0);
 
-constexpr uint32 size_mask = sram_size / 4 - 1;		 // 0x0000ffff  - uint32 words
-constexpr uint32 flag_mask = ~size_mask;			 // 0xffff0000  - the other bits
-constexpr uint32 flag_used = 0xA53C0000 & flag_mask; // magic number, msb set
-constexpr uint32 flag_free = 0x00000000;			 // all bits cleared
+constexpr uint32 size_mask	 = sram_size / 4 - 1;		// 0x0000ffff  - uint32 words
+constexpr uint32 flag_mask	 = ~size_mask;				// 0xffff0000  - the other bits
+constexpr uint32 flag_used	 = 0xA53C0000 & flag_mask;	// magic number, msb set
+constexpr uint32 flag_cached = 0xC35A0000 & flag_mask;	// magic number, msb set: in a free list
+constexpr uint32 flag_free	 = 0x00000000;				// all bits cleared
 
 constexpr size_t max_size = (size_mask << 2) - 4; // bytes
 
+// free lists for chunks with size 2 .. num_size_classes+1 words incl. header:
+constexpr uint32 num_size_classes = MALLOC_SIZE_CLASSES;
+constexpr uint32 cache_limit	  = MALLOC_CACHE_LIMIT;
+static uint32*	 free_lists[num_size_classes ? num_size_classes : 1];
+static uint8	 free_list_counts[num_size_classes ? num_size_classes : 1];
+static_assert(cache_limit <= 255);
+static uint32*	 first_free = heap_start;
+
 
 // helper:
 static inline int min(int a, int b) noexcept { return a <= b ? a : b; }
@@ -134,6 +182,10 @@ static inline int max(int a, int b) noexcept { return a >= b ? a : b; }
 {
 	return (*p & flag_mask) == flag_free && *p != flag_free;
 }
+[[maybe_unused]] static inline bool is_valid_cached(uint32* p) noexcept
+{
+	return (*p & flag_mask) == flag_cached && *p != flag_cached;
+}
 
 static inline uint32* skip_free(uint32* p)
 {
@@ -142,7 +194,8 @@ static inline uint32* skip_free(uint32* p)
 		while (p < heap_end && is_valid_free(p)) { p += *p; }
 
 		// note: in a race condition the used block at p could just been released by free().
-		if (p < heap_end && !is_valid_used(p) && !is_valid_free(p)) panic("malloc:skip_free: !valid_used");
+		if (p < heap_end && !is_valid_used(p) && !is_valid_cached(p) && !is_valid_free(p))
+			panic("malloc:skip_free: !valid_used");
 
 		return p;
 	}
@@ -157,7 +210,7 @@ static inline uint32* skip_used(uint32* p)
 {
 	if constexpr (extended_validation)
 	{
-		while (p < heap_end && is_valid_used(p)) { p += *p & size_mask; }
+		while (p < heap_end && (is_valid_used(p) || is_valid_cached(p))) { p += *p & size_mask; }
 		if (p < heap_end && !is_valid_free(p)) panic("malloc:skip_used: !valid_free");
 		return p;
 	}
@@ -177,10 +230,14 @@ static inline uint32* skip_used(uint32* p)
 	pro: safely synchronizes access by this core, it's interrupts and the other core and it's interrupts.
 	con: every time malloc() is executed interrupts are disabled for a somewhat long time.
 
-	only the search-and-acquire part of malloc() must be synchronized,
-	free() and the additional code of realloc() and calloc() can be done unblocked.
+	only the search-and-acquire part of malloc() and the free lists and `first_free` must be synchronized,
+	the additional code of realloc() and calloc() can be done unblocked.
 */
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+static uint32 malloc_lock() noexcept { return 0; }
+static void	  malloc_unlock(uint32) noexcept {}
+#else
 static uint32 malloc_lock() noexcept
 {
 	for (;; __nop())
@@ -195,6 +252,68 @@ static void malloc_unlock(uint32 irqs) noexcept
 {
 	spin_unlock(spin_lock_instance(MALLOC_SPINLOCK_NUMBER), irqs); //
 }
+#endif
+
+
+/*	_________________________________________________________________________________________________
+	Free lists for small chunks:
+	The link to the next chunk is stored in the first data word as offset from heap_start, 0 = end of list.
+	All functions must be called with the lock held.
+*/
+
+static inline uint32 size_class(uint32 size) noexcept
+{
+	// chunk size in words -> index in free_lists[] or >= num_size_classes
+	return size - 2;
+}
+
+static inline bool push_cached(uint32* p, uint32 size) noexcept
+{
+	// returns false if the free list is full
+
+	uint8& count = free_list_counts[size_class(size)];
+	if (count >= cache_limit) return false;
+	count++;
+
+	uint32*& list = free_lists[size_class(size)];
+	p[1]		  = list ? uint32(list + 1 - heap_start) : 0;
+	*p			  = size | flag_cached;
+	list		  = p;
+	return true;
+}
+
+static inline uint32* pop_cached(uint32 size) noexcept
+{
+	uint32*& list = free_lists[size_class(size)];
+	uint32*	 p	  = list;
+	if (p)
+	{
+		if constexpr (extended_validation)
+			if (!is_valid_cached(p)) panic("malloc: corrupted free list");
+		list = p[1] ? heap_start + p[1] - 1 : nullptr;
+		*p	 = size | flag_used;
+		free_list_counts[size_class(size)]--;
+	}
+	return p;
+}
+
+static void release_cached() noexcept
+{
+	// release all cached chunks into the heap
+
+	for (uint32 i = 0; i < num_size_classes; i++)
+	{
+		for (uint32* p = free_lists[i]; p;)
+		{
+			uint32* next = p[1] ? heap_start + p[1] - 1 : nullptr;
+			*p			 = (*p & size_mask) | flag_free;
+			if (p < first_free) first_free = p;
+			p = next;
+		}
+		free_lists[i]		= nullptr;
+		free_list_counts[i] = 0;
+	}
+}
 
 
 void* malloc(size_t size)
@@ -215,8 +334,10 @@ void* malloc(size_t size)
 
 		*heap_start = free_size | flag_free; // define one big free chunk
 
+#if !(defined MAKE_TOOLS && MAKE_TOOLS)
 		spin_lock_claim(MALLOC_SPINLOCK_NUMBER);
 		spin_lock_init(MALLOC_SPINLOCK_NUMBER);
+#endif
 	}
 
 	// calc. required size in words, incl. header:
@@ -230,24 +351,42 @@ void* malloc(size_t size)
 
 	uint32 _ = malloc_lock();
 
-	uint32* p = skip_used(heap_start); // find 1st free chunk
-
-	while (p < heap_end)
+	if (size_class(size) < num_size_classes)
 	{
-		size_t gap = uint32(skip_free(p) - p);
-
-		if (gap >= size)
+		if (uint32* p = pop_cached(size))
 		{
-			if (gap > size) { *(p + size) = (gap - size) | flag_free; } // split
-			*p = size | flag_used;
 			malloc_unlock(_);
 			xlogline("%u:malloc %u -> 0x%8x\n", get_core_num(), (size - 1) << 2, size_t(p + 1));
 			return p + 1;
 		}
+	}
+
+	for (bool retry = num_size_classes != 0;; retry = false)
+	{
+		uint32* p  = skip_used(first_free); // find 1st free chunk
+		first_free = p;
+
+		while (p < heap_end)
+		{
+			size_t gap = uint32(skip_free(p) - p);
+
+			if (gap >= size)
+			{
+				if (gap > size) { *(p + size) = (gap - size) | flag_free; } // split
+				*p = size | flag_used;
+				if (p == first_free) first_free = p + size;
+				malloc_unlock(_);
+				xlogline("%u:malloc %u -> 0x%8x\n", get_core_num(), (size - 1) << 2, size_t(p + 1));
+				return p + 1;
+			}
+
+			// gap too small:
+			*p = gap | flag_free;
+			p  = skip_used(p + gap); // find next free chunk
+		}
 
-		// gap too small:
-		*p = gap | flag_free;
-		p  = skip_used(p + gap); // find next free chunk
+		if (!retry) break;
+		release_cached(); // and try again
 	}
 
 	malloc_unlock(_);
@@ -306,6 +445,7 @@ void* realloc(void* mem, size_t size)
 		*p = size | flag_used;
 		p += size;
 		*p = (old_size - size) | flag_free;
+		if (p < first_free) first_free = p;
 
 		malloc_unlock(_);
 		xlogline("%u:realloc 0x%8x: %u -> %u\n", get_core_num(), size_t(mem), (old_size - 1) << 2, (size - 1) << 2);
@@ -319,6 +459,7 @@ void* realloc(void* mem, size_t size)
 		{
 			uint32 _ = malloc_lock();
 
+			if (first_free > p && first_free < p + size) first_free = p; // must not point inside a chunk
 			*p = size | flag_used;
 			p += size;
 			if (avail > size) *p = (avail - size) | flag_free;
@@ -361,7 +502,18 @@ void free(void* mem)
 		xlogline("%u:free 0x%8x: %u \n", get_core_num(), size_t(mem), ((*p & size_mask) - 1) << 2);
 		assert(is_valid_used(p));
 		if constexpr (extended_validation) memset(p + 1, 0xA5, ((*p & size_mask) - 1) << 2);
-		*p = (*p & size_mask) | flag_free;
+
+		uint32 size = *p & size_mask;
+		uint32 _	= malloc_lock();
+
+		if (size_class(size) < num_size_classes && push_cached(p, size)) {}
+		else
+		{
+			*p = size | flag_free;
+			if (p < first_free) first_free = p;
+		}
+
+		malloc_unlock(_);
 	}
 }
 
@@ -370,11 +522,24 @@ Error check_heap()
 	uint32* p = heap_start;
 
 	uint32 _ = malloc_lock();
-	for (; p < heap_end && (is_valid_used(p) || is_valid_free(p)); p += *p & size_mask) {}
+	for (; p < heap_end && (is_valid_used(p) || is_valid_cached(p) || is_valid_free(p)); p += *p & size_mask) {}
+
+	Error error = nullptr;
+	for (uint32 i = 0; i < num_size_classes && !error; i++)
+	{
+		uint32 count = 0;
+		for (uint32* c = free_lists[i]; c && !error; c = c[1] ? heap_start + c[1] - 1 : nullptr)
+		{
+			if (c < heap_start || c >= heap_end || !is_valid_cached(c) || (*c & size_mask) != i + 2)
+				error = "invalid block in free list";
+			count++;
+		}
+		if (!error && count != free_list_counts[i]) error = "wrong free list count";
+	}
 	malloc_unlock(_);
 
-	if (p == heap_end) return nullptr;
-	return p < heap_end ? "invalid block found" : "last block extends beyond heap end";
+	if (p != heap_end) return p < heap_end ? "invalid block found" : "last block extends beyond heap end";
+	return error;
 }
 
 static void dump_memory(cptr p, int sz)
@@ -399,19 +564,25 @@ void dump_heap()
 		if (is_valid_free(p))
 		{
 			uint sz = *p & size_mask;
-			printf("0x%08x: free, sz=%u\n", uint32(p + 1), sz * 4 - 4);
+			printf("0x%08x: free, sz=%u\n", uint32(size_t(p + 1)), sz * 4 - 4);
+			p += sz;
+		}
+		else if (is_valid_cached(p))
+		{
+			uint sz = *p & size_mask;
+			printf("0x%08x: cached, sz=%u\n", uint32(size_t(p + 1)), sz * 4 - 4);
 			p += sz;
 		}
 		else if (is_valid_used(p))
 		{
 			int sz = *p & size_mask;
-			printf("0x%08x: used, sz=%i\n", uint32(p + 1), sz * 4 - 4);
+			printf("0x%08x: used, sz=%i\n", uint32(size_t(p + 1)), sz * 4 - 4);
 			dump_memory(cptr(p) + 4, sz * 4 - 4 == 1088 ? 1088 : min(256, sz * 4 - 4));
 			p += sz;
 		}
 		else
 		{
-			printf("0x%08x: invalid data\n", uint32(p));
+			printf("0x%08x: invalid data\n", uint32(size_t(p)));
 			printf("note: dump starts with the void heap link\n");
 			dump_memory(cptr(p), 256);
 			break;
@@ -425,7 +596,7 @@ void dump_heap_to_fu(dump_heap_print_fu* print_fu, void* data)
 {
 	for (uint32* p = heap_start; p < heap_end;)
 	{
-		if (is_valid_free(p))
+		if (is_valid_free(p) || is_valid_cached(p))
 		{
 			uint sz = *p & size_mask;
 			print_fu(data, p + 1, int(sz * 4 - 4), 0);
@@ -452,16 +623,20 @@ size_t heap_total_size()
 
 size_t heap_largest_free_block()
 {
+	// cached chunks are counted as free because malloc() releases them if needed.
+	// they are not released here: a query should not change the heap.
+
 	int maxfree = 0 + 1;
 
 	for (uint32* p = heap_start; p < heap_end;)
 	{
 		if (is_valid_used(p)) { p += *p & size_mask; }
-		else if (is_valid_free(p))
+		else if (is_valid_free(p) || is_valid_cached(p))
 		{
-			int sz	= skip_free(p) - p;
-			maxfree = max(maxfree, sz);
-			p += sz;
+			uint32* e = p;
+			while (e < heap_end && (is_valid_free(e) || is_valid_cached(e))) { e += *e & size_mask; }
+			maxfree = max(maxfree, int(e - p));
+			p		= e;
 		}
 		else { return 0; }
 	}
@@ -498,6 +673,10 @@ bool heap_cut_exception_block()
 	return true;	 // worked
 }
 
+#if defined MAKE_TOOLS && MAKE_TOOLS
+} // namespace MALLOC_HOST_NAMESPACE
+#endif
+
 /*
 
 
@@ -6,7 +6,14 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#ifdef __cplusplus
+#if defined MAKE_TOOLS && MAKE_TOOLS
+  #ifndef MALLOC_HOST_NAMESPACE
+	#define MALLOC_HOST_NAMESPACE kio::HostHeap
+  #endif
+// in desktop_tools: don't replace the host's malloc, see malloc.cpp
+namespace MALLOC_HOST_NAMESPACE
+{
+#elif defined __cplusplus
 extern "C"
 {
 #endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Audio/AudioMixer.h"
+#include "benchmark.h"
+#include <cstdio>
+#if defined __x86_64__ || defined __i386__
+  #include <x86intrin.h>
+#endif
+
+
+/*
+	Benchmark for mixing N mono sources with volume into the stereo int32 buffer of the AudioController.
+
+	adapters: each source is wrapped in a SetVolumeAdapter and a MakeStereoAdapter
+			  and the AudioController adds them to the int32 buffer. (the old way)
+	mixer:    the AudioMixer applies the gain and the channel conversion while accumulating.
+
+	ns/frame:  time per stereo frame for all sources
+	cc/frame:  cpu cycles (TSC) per frame, only on x86
+*/
+
+
+namespace kio::Audio
+{
+static constexpr uint num_frames = 64; // same as ibu_size in Audio.cpp
+
+struct ConstSource : public MonoSource
+{
+	Sample sample;
+	ConstSource(int n) : sample(Sample(n * 100)) {}
+	virtual uint getAudio(MonoSample* buffer, uint num_frames) noexcept override
+	{
+		for (uint i = 0; i < num_frames; i++) buffer[i] = sample;
+		return num_frames;
+	}
+};
+
+static inline uint64 cycles() noexcept
+{
+#if defined __x86_64__ || defined __i386__
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+template<typename FU>
+static void run(cstr name, uint n, FU&& fu)
+{
+	uint64 c0 = cycles();
+	uint   cnt = 0;
+	double ns  = Benchmark::measure([&] { fu(), cnt++; });
+	uint64 c1  = cycles();
+	printf("%-9s %3u %10.2f %10.1f\n", name, n, ns / num_frames, double(c1 - c0) / cnt / num_frames);
+}
+
+static void bench_adapters(uint n)
+{
+	RCPtr<StereoSource> sources[AudioMixer<2>::max_sources];
+	for (uint i = 0; i < n; i++) sources[i] = new MakeStereoAdapter(new SetVolumeAdapter<1>(new ConstSource(i), 0.5f));
+
+	AudioSample<2, int> accu[num_frames];
+	StereoSample		ibu[num_frames];
+	StereoSample		out[num_frames];
+
+	run("adapters", n, [&] {
+		memset(accu, 0, sizeof(accu));
+		for (uint i = 0; i < n; i++)
+		{
+			uint cnt = sources[i]->getAudio(ibu, num_frames);
+			for (uint j = 0; j < cnt; j++) accu[j] += ibu[j];
+		}
+		store_saturated(out, accu, num_frames);
+		Benchmark::do_not_optimize(out);
+	});
+}
+
+static void bench_mixer(uint n)
+{
+	RCPtr<AudioMixer<2>> mixer = new AudioMixer<2>;
+	for (uint i = 0; i < n; i++) mixer->addSource(new ConstSource(i), 0.5f);
+
+	AudioSample<2, int> accu[num_frames];
+	StereoSample		out[num_frames];
+
+	run("mixer", n, [&] {
+		memset(accu, 0, sizeof(accu));
+		mixer->mix(accu, num_frames);
+		store_saturated(out, accu, num_frames);
+		Benchmark::do_not_optimize(out);
+	});
+}
+
+void audio_mixer_benchmark()
+{
+	printf("\nAudioMixer benchmark: mix N mono sources with volume to stereo\n");
+	printf("%-9s %3s %10s %10s\n", "mode", "N", "ns/frame", "cc/frame");
+
+	for (uint n : {1, 4, 16})
+	{
+		bench_adapters(n);
+		bench_mixer(n);
+	}
+}
+
+} // namespace kio::Audio
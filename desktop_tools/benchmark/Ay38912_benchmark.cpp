@@ -0,0 +1,101 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Audio/Ay38912.h"
+#include "YMFile.h"
+#include "benchmark.h"
+#include <cstdio>
+
+
+/*
+	Benchmark for the Ay38912 with and without the batch path for fast channels.
+
+	ym file:  the song YM_FILE at 44.1 kHz
+	fast:     3 tone channels with period 2, as used for sample playback by volume modulation
+
+	events: the plain event loop with one iteration per channel toggle
+	batched: channels with a period shorter than one sample are integrated per sample
+
+	ns/sample: time per output sample
+	realtime:  how many times faster than realtime
+*/
+
+
+namespace kio::Audio
+{
+float hw_sample_frequency = 44100; // normally in AudioController.cpp
+
+template<uint nc>
+struct ReferenceAy : public Ay38912_player<nc>
+{
+	ReferenceAy(float clock, int fps) : Ay38912_player<nc>(clock, Mono, fps) { this->batch_fast_tones = false; }
+};
+
+static void report(cstr what, cstr mode, uint64 ns, uint64 num_samples)
+{
+	double ns_per_sample = double(ns) / double(num_samples);
+	printf("%-8s %-8s %10.1f %10.0f\n", what, mode, ns_per_sample, 1e9 / hw_sample_frequency / ns_per_sample);
+}
+
+static void bench_ym_file(cstr mode, AudioSource<1>* ay, Ay38912_player<1>* player, const Test::YMFile& ym)
+{
+	uint	   samples_per_frame = uint(hw_sample_frequency) / ym.frame_rate;
+	MonoSample bu[1000];
+
+	uint64 start = Benchmark::now_ns();
+	for (uint32 i = 0; i < ym.num_frames; i++)
+	{
+		player->setRegisters(ym.frame(i));
+		ay->getAudio(bu, samples_per_frame);
+		Benchmark::do_not_optimize(bu);
+	}
+	uint64 end = Benchmark::now_ns();
+	report("ym file", mode, end - start, uint64(ym.num_frames) * samples_per_frame);
+}
+
+static void bench_fast_tones(cstr mode, AudioSource<1>* ay, Ay38912_player<1>* player)
+{
+	static constexpr uint num_frames = 500;
+	uint				  samples_per_frame = uint(hw_sample_frequency) / 50;
+	MonoSample			  bu[1000];
+
+	uint8 regs[14] = {2, 0, 2, 0, 2, 0, 0, 0b111000, 15, 14, 13, 0, 0, 0xff};
+
+	uint64 start = Benchmark::now_ns();
+	for (uint32 i = 0; i < num_frames; i++)
+	{
+		regs[8] = uint8(i & 15);
+		player->setRegisters(regs);
+		ay->getAudio(bu, samples_per_frame);
+		Benchmark::do_not_optimize(bu);
+	}
+	uint64 end = Benchmark::now_ns();
+	report("fast", mode, end - start, uint64(num_frames) * samples_per_frame);
+}
+
+void ay38912_benchmark()
+{
+	printf("\nAy38912 benchmark: event loop vs. batched fast channels\n");
+	printf("%-8s %-8s %10s %10s\n", "sound", "mode", "ns/sample", "realtime");
+
+	Test::YMFile ym(YM_FILE);
+	{
+		RCPtr<ReferenceAy<1>> ay = new ReferenceAy<1>(float(ym.ay_clock), int(ym.frame_rate));
+		bench_ym_file("events", ay, ay, ym);
+	}
+	{
+		RCPtr<Ay38912_player<1>> ay = new Ay38912_player<1>(float(ym.ay_clock), Mono, int(ym.frame_rate));
+		bench_ym_file("batched", ay, ay, ym);
+	}
+	{
+		RCPtr<ReferenceAy<1>> ay = new ReferenceAy<1>(2000000, 50);
+		bench_fast_tones("events", ay, ay);
+	}
+	{
+		RCPtr<Ay38912_player<1>> ay = new Ay38912_player<1>(2000000, Mono, 50);
+		bench_fast_tones("batched", ay, ay);
+	}
+}
+
+} // namespace kio::Audio
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include "common/Dispatcher.h"
+#include "glue.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+/*
+	Benchmark for the Dispatcher in common/Dispatcher.cpp.
+
+	The Dispatcher is filled with 10, 100 or 1000 tasks which are scheduled 1 to 2 seconds ahead.
+	Then we measure:
+
+	add:      addWithDelay() with a random delay in the same range
+	remove:   removeHandler() for this task, which needs a linear search
+	dispatch: time from calling run() until the due handler is entered,
+	          incl. removing it from the task list
+*/
+
+
+namespace kio
+{
+
+static constexpr int num_ops = 20000;
+
+static uint64 handler_entered;
+
+static int background_task(void*) noexcept { return 0; }
+
+static int due_task(void*) noexcept
+{
+	handler_entered = Benchmark::now_ns();
+	return 0;
+}
+
+static uint64 percentile(std::vector<uint64>& times, uint p) noexcept
+{
+	std::sort(times.begin(), times.end());
+	return times[times.size() * p / 100];
+}
+
+static void bench_dispatcher(int num_tasks) noexcept
+{
+	Xoshiro128 rng {uint32(num_tasks)};
+
+	for (int i = 0; i < num_tasks - 1; i++)
+	{
+		void* data = reinterpret_cast<void*>(uintptr_t(i));
+		Dispatcher::addWithDelay(background_task, data, 1000000 + int(rng.random(1000000u)));
+	}
+
+	std::vector<uint64> add_times, remove_times, dispatch_times;
+	add_times.reserve(num_ops);
+	remove_times.reserve(num_ops);
+	dispatch_times.reserve(num_ops);
+
+	for (int i = 0; i < num_ops; i++)
+	{
+		uint64 t0 = Benchmark::now_ns();
+		Dispatcher::addWithDelay(due_task, nullptr, 1000000 + int(rng.random(1000000u)));
+		uint64 t1 = Benchmark::now_ns();
+		Dispatcher::removeHandler(due_task, nullptr);
+		uint64 t2 = Benchmark::now_ns();
+		add_times.push_back(t1 - t0);
+		remove_times.push_back(t2 - t1);
+
+		Dispatcher::addAtTime(due_task, nullptr, now() - 1);
+		uint64 t3 = Benchmark::now_ns();
+		Dispatcher::run();
+		dispatch_times.push_back(handler_entered - t3);
+	}
+
+	for (int i = 0; i < num_tasks - 1; i++)
+		Dispatcher::removeHandler(background_task, reinterpret_cast<void*>(uintptr_t(i)));
+
+	printf(
+		"%6i %8llu %8llu %8llu %8llu %8llu %8llu\n", num_tasks,			  //
+		ullong(percentile(add_times, 50)), ullong(percentile(add_times, 99)), //
+		ullong(percentile(remove_times, 50)), ullong(percentile(remove_times, 99)),
+		ullong(percentile(dispatch_times, 50)), ullong(percentile(dispatch_times, 99)));
+}
+
+void dispatcher_benchmark()
+{
+	printf("\nDispatcher benchmark: latency in ns\n");
+	printf("%6s %8s %8s %8s %8s %8s %8s\n", "tasks", "add50", "add99", "rem50", "rem99", "disp50", "disp99");
+
+	for (int num_tasks : {10, 100, 1000}) bench_dispatcher(num_tasks);
+}
+
+} // namespace kio
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/BlockDevice.h"
+#include "Devices/FileSystem.h"
+#include "Devices/internal/FatFile.h"
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+/*
+	Benchmark for FatFile::setFpos() with and without fast seek.
+
+	A FAT volume on a RAM disk image holds 2 files which were written interleaved
+	so that their clusters are fragmented. Then we seek to random positions in one file
+	and read a few bytes, with and without the cluster link map table (CLMT).
+
+	seek:    average time per setFpos() + read() in ns
+	sectors: average number of sectors read per seek, which is the real cost on an SDCard
+*/
+
+
+namespace kio
+{
+using namespace Devices;
+
+static constexpr uint32 disk_size = 64 MB;
+static constexpr uint32 chunk	  = 4 kB;
+static constexpr uint	num_seeks = 2000;
+
+class ImageDisk : public BlockDevice
+{
+public:
+	std::vector<uint8> image;
+	uint32			   sectors_read = 0;
+
+	ImageDisk() : BlockDevice(disk_size >> 9, 9, 9, 0, readwrite | overwritable), image(disk_size) {}
+
+	virtual void readSectors(LBA lba, void* bu, SIZE count) override
+	{
+		memcpy(bu, &image[lba << 9], count << 9);
+		sectors_read += count;
+	}
+	virtual void writeSectors(LBA lba, const void* bu, SIZE count) override
+	{
+		if (bu) memcpy(&image[lba << 9], bu, count << 9);
+		else memset(&image[lba << 9], 0xff, count << 9);
+	}
+};
+
+static void write_fragmented_files(FileSystem* fs, uint32 size)
+{
+	FilePtr a = fs->openFile("/a.bin", WRITE);
+	FilePtr b = fs->openFile("/b.bin", WRITE);
+	uint8	bu[chunk] = {0};
+	for (uint32 fpos = 0; fpos < size; fpos += chunk)
+	{
+		a->write(bu, chunk);
+		b->write(bu, chunk);
+	}
+}
+
+static void bench_seek(ImageDisk* disk, FatFile* file, uint32 fsize, bool fast)
+{
+	uint clmt_size = 0;
+	if (fast) clmt_size = file->enableFastSeek();
+	else file->disableFastSeek();
+
+	Xoshiro128 rng(fsize);
+	uint8	   bu[16];
+
+	disk->sectors_read = 0;
+	uint64 start	   = Benchmark::now_ns();
+	for (uint i = 0; i < num_seeks; i++)
+	{
+		file->setFpos(rng.random(fsize - uint32(sizeof(bu))));
+		file->read(bu, sizeof(bu));
+		Benchmark::do_not_optimize(bu[0]);
+	}
+	uint64 end = Benchmark::now_ns();
+
+	printf(
+		"%8u kB %5s %10llu %10.1f %8u\n", fsize / 1024, fast ? "fast" : "slow", ullong((end - start) / num_seeks),
+		double(disk->sectors_read) / num_seeks, clmt_size);
+}
+
+void fatfile_benchmark()
+{
+	printf("\nFatFile benchmark: random seek in fragmented file\n");
+	printf("%11s %5s %10s %10s %8s\n", "file size", "mode", "seek [ns]", "sectors", "clmt");
+
+	for (uint32 fsize : {256 kB, 2 MB, 16 MB})
+	{
+		RCPtr<ImageDisk> disk = new ImageDisk;
+		makeFS(disk, "FAT");
+		FileSystemPtr fs = mount("bench", disk);
+		write_fragmented_files(fs, fsize);
+
+		RCPtr<FatFile> file = static_cast<FatFile*>(fs->openFile("/a.bin", READ).ptr());
+		bench_seek(disk, file, fsize, false);
+		bench_seek(disk, file, fsize, true);
+
+		file = nullptr;
+		fs	 = nullptr;
+		unmountAll();
+	}
+}
+
+} // namespace kio
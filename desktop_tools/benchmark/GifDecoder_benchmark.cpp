@@ -0,0 +1,198 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/BufferedFile.h"
+#include "Devices/RamFile.h"
+#include "Graphics/Pixmap.h"
+#include "Graphics/gif/GifDecoder.h"
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include <cstdio>
+
+
+/*
+	Benchmark for the byte-oriented decoders which read their data through a BufferedFile.
+
+	gif:   decode a 320x240 gif image with 256 colors from a RamFile.
+		   the LZW data is not compressed: it consists of 9-bit literal codes only.
+		   this is the worst case for the file access because it has the most bytes per pixel.
+	canvas i8, canvas rgb:  decode the gif into a Pixmap with the Canvas version of decode_frame():
+		   std::function per scanline and virtual set_pixel() per pixel.
+	pixmap i8, pixmap rgb:  decode the gif into a Pixmap with the Pixmap version of decode_frame():
+		   i8: the LZW decoder writes into the pixmap rows. rgb: colors from a lookup table.
+	bytes: read a file byte by byte with read<uint8>(), as the YMMusicPlayer's bitstream does,
+		   directly from the RamFile and through a BufferedFile.
+*/
+
+
+namespace kio
+{
+using namespace Devices;
+using namespace Graphics;
+
+static constexpr uint width	 = 320;
+static constexpr uint height = 240;
+
+class GifWriter
+{
+public:
+	FilePtr file;
+	uint8	block[256];
+	uint	blocksize = 0;
+	uint32	accu	  = 0;
+	uint	bits	  = 0;
+
+	GifWriter(FilePtr file) : file(file) {}
+
+	void put_byte(uint8 byte)
+	{
+		block[++blocksize] = byte;
+		if (blocksize < 255) return;
+		block[0] = uint8(blocksize);
+		file->write(block, blocksize + 1);
+		blocksize = 0;
+	}
+	void put_code(uint code)
+	{
+		accu |= code << bits;
+		for (bits += 9; bits >= 8; bits -= 8)
+		{
+			put_byte(uint8(accu));
+			accu >>= 8;
+		}
+	}
+	void flush()
+	{
+		if (bits) put_byte(uint8(accu));
+		if (blocksize)
+		{
+			block[0] = uint8(blocksize);
+			file->write(block, blocksize + 1);
+		}
+		file->putc(0); // end of data
+	}
+};
+
+static FilePtr make_gif()
+{
+	static constexpr uint clear_code = 256;
+	static constexpr uint eoi_code	 = 257;
+
+	FilePtr file = new RamFile<>;
+	file->write("GIF89a", 6);
+	file->write_LE<uint16>(width);
+	file->write_LE<uint16>(height);
+	file->putc(char(0xf7)); // global cmap, 8 bit
+	file->putc(0);			// background color
+	file->putc(0);			// aspect
+	for (uint i = 0; i < 256; i++)
+	{
+		file->putc(char(i));
+		file->putc(char(i * 3));
+		file->putc(char(i * 7));
+	}
+
+	file->putc(',');
+	file->write_LE<uint16>(0);
+	file->write_LE<uint16>(0);
+	file->write_LE<uint16>(width);
+	file->write_LE<uint16>(height);
+	file->putc(0); // no local cmap, not interleaved
+	file->putc(8); // lzw min code size
+
+	// a clear code every 250 codes keeps the code size at 9 bits:
+	GifWriter  writer(file);
+	Xoshiro128 rng(1234);
+	for (uint i = 0; i < width * height; i++)
+	{
+		if (i % 250 == 0) writer.put_code(clear_code);
+		writer.put_code(rng.next() & 0xff);
+	}
+	writer.put_code(eoi_code);
+	writer.flush();
+
+	file->putc(';');
+	file->setFpos(0);
+	return file;
+}
+
+static void bench_gif()
+{
+	FilePtr file = make_gif();
+	uint32	size = file->getSize();
+
+	uint32		   checksum = 0;
+	store_scanline fu		= [&](int, int y, int w, uchar* pixels, Color*, int) {
+		  for (int x = 0; x < w; x++) checksum += pixels[x] * uint(y);
+	};
+
+	double ns = Benchmark::measure([&] {
+		file->setFpos(0);
+		GifDecoder decoder(file);
+		decoder.decode_frame(fu);
+		Benchmark::do_not_optimize(checksum);
+	});
+
+	printf("%-8s %8u %12.0f %10.2f %10.1f\n", "gif", size, ns / 1000, ns / (width * height), size * 1e3 / ns);
+}
+
+template<typename PIXMAP>
+static void bench_pixmap(cstr name, bool use_canvas)
+{
+	FilePtr		  file = make_gif();
+	uint32		  size = file->getSize();
+	RCPtr<PIXMAP> pm   = new PIXMAP(int(width), int(height));
+	Color		  cmap[256];
+
+	double ns = Benchmark::measure([&] {
+		file->setFpos(0);
+		GifDecoder decoder(file);
+		if constexpr (PIXMAP::colormode == colormode_rgb)
+		{
+			if (use_canvas) decoder.decode_frame(static_cast<Canvas&>(*pm));
+			else decoder.decode_frame(*pm);
+		}
+		else
+		{
+			if (use_canvas) decoder.decode_frame(static_cast<Canvas&>(*pm), cmap);
+			else decoder.decode_frame(*pm, cmap);
+		}
+		Benchmark::do_not_optimize(pm->pixmap[0]);
+	});
+
+	printf("%-10s %6u %12.0f %10.2f %10.1f\n", name, size, ns / 1000, ns / (width * height), size * 1e3 / ns);
+}
+
+template<typename FILE>
+static void bench_bytes(cstr name, FILE* file, uint32 size)
+{
+	double ns = Benchmark::measure([&] {
+		file->setFpos(0);
+		uint sum = 0;
+		for (uint32 i = 0; i < size; i++) sum += file->template read<uint8>();
+		Benchmark::do_not_optimize(sum);
+	});
+
+	printf("%-8s %8u %12.0f %10.2f %10.1f\n", name, size, ns / 1000, ns / size, size * 1e3 / ns);
+}
+
+void gif_decoder_benchmark()
+{
+	printf("\nGifDecoder benchmark: decoding from a RamFile through a BufferedFile\n");
+	printf("%-8s %8s %12s %10s %10s\n", "test", "bytes", "time [µs]", "ns/item", "MB/s");
+
+	bench_gif();
+	bench_pixmap<Pixmap_i8>("canvas i8", true);
+	bench_pixmap<Pixmap_i8>("pixmap i8", false);
+	bench_pixmap<Pixmap_rgb>("canvas rgb", true);
+	bench_pixmap<Pixmap_rgb>("pixmap rgb", false);
+
+	FilePtr file = make_gif();
+	uint32	size = file->getSize();
+	bench_bytes("bytes", file.ptr(), size);
+	RCPtr<BufferedFile> bfile = new BufferedFile(file);
+	bench_bytes("buffered", bfile.ptr(), size);
+}
+
+} // namespace kio
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "MultiSpritesPlane.h"
+#include "Pixmap.h"
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include <cstdio>
+#include <memory>
+
+
+/*
+	Benchmark for the MultiSpritesPlane.
+
+	Renders whole frames of 640x480 pixels with 16x16 pixel sprites:
+
+	per line:  N sprites side by side in the same rows.
+			   reports whether the hotlist overflowed and the time per frame and per sprite row.
+			   the maximum N without overflow is the number of sprites per line which can be displayed.
+	scattered: N sprites at random positions, some of them partially off-screen.
+			   rows in empty bands of the sprite bucket index are skipped.
+*/
+
+
+namespace kio::Video
+{
+using namespace Graphics;
+
+VgaMode		  vga_mode	 = vga_mode_640x480_60; // normally in VideoBackend.cpp
+volatile bool locked_out = false;				// normally in Video.cpp
+
+using SpritesPlane = MultiSpritesPlane<Sprite<Shape>, NoZ>;
+
+static constexpr int width	= 640;
+static constexpr int height = 480;
+
+static Shape make_shape()
+{
+	// a filled circle:
+	Pixmap<colormode_rgb> pm(16, 16);
+	for (int y = 0; y < 16; y++)
+		for (int x = 0; x < 16; x++)
+		{
+			int dx = 2 * x - 15, dy = 2 * y - 15;
+			pm.set_pixel(x, y, dx * dx + dy * dy < 256 ? uint(0x1234 + x + y) : 0);
+		}
+	return Shape(pm, 0, Dist(0, 0), nullptr);
+}
+
+static double render_frames(SpritesPlane* plane, uint32* scanline)
+{
+	return Benchmark::measure([=] {
+		plane->vblank();
+		for (int row = 0; row < height; row++) plane->renderScanline(row, width, scanline);
+		Benchmark::do_not_optimize(scanline[0]);
+	});
+}
+
+void multi_sprites_plane_benchmark()
+{
+	Shape shape	   = make_shape();
+	auto  scanline = std::make_unique<uint32[]>(width * sizeof(Color) / sizeof(uint32) + 1);
+
+	printf("\nMultiSpritesPlane benchmark: %ix%i, 16x16 sprites\n", width, height);
+	printf("%8s %8s %10s %12s\n", "per line", "overflow", "ns/frame", "ns/sprite/row");
+
+	int max_sprites = 0;
+	for (int n : {1, 2, 4, 8, 12, 16, 20, 21, 24, 32})
+	{
+		RCPtr<SpritesPlane> plane = new SpritesPlane;
+		for (int i = 0; i < n; i++) plane->add(new Sprite<Shape>(shape, Point(i * 20, 200)));
+
+		hotlist_overflow = false;
+		double ns		 = render_frames(plane, scanline.get());
+		if (!hotlist_overflow) max_sprites = n;
+		printf("%8i %8s %10.0f %12.1f\n", n, hotlist_overflow ? "yes" : "no", ns, ns / (n * 16));
+
+		plane->clear_displaylist(true);
+	}
+	printf("max. sprites per line without overflow: %i\n", max_sprites);
+
+	printf("%8s %8s %10s\n", "scatter", "overflow", "ns/frame");
+	for (int n : {10, 50, 200})
+	{
+		Xoshiro128			rng {uint32(n)};
+		RCPtr<SpritesPlane> plane = new SpritesPlane;
+		for (int i = 0; i < n; i++)
+		{
+			int x = int(rng.random(uint(width + 32))) - 16;
+			int y = int(rng.random(uint(height / 2 + 32))) * 2 - 32;
+			plane->add(new Sprite<Shape>(shape, Point(x, y)));
+		}
+
+		hotlist_overflow = false;
+		double ns		 = render_frames(plane, scanline.get());
+		printf("%8i %8s %10.0f\n", n, hotlist_overflow ? "yes" : "no", ns);
+
+		plane->clear_displaylist(true);
+	}
+}
+
+} // namespace kio::Video
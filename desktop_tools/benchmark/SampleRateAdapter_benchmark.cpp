@@ -0,0 +1,62 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Audio/AudioSource.h"
+#include "benchmark.h"
+#include <cstdio>
+
+
+/*
+	Benchmark for converting a mono source from 22050 Hz or 44100 Hz to 48000 Hz.
+
+	float:   the SampleRateAdapter with float position and linear interpolation
+	linear:  the PolyphaseSampleRateAdapter with linear interpolation
+	cubic:   the PolyphaseSampleRateAdapter with 4 taps
+	sinc:    the PolyphaseSampleRateAdapter with 8 taps
+
+	ns/frame: time per output frame, including the source
+*/
+
+
+namespace kio::Audio
+{
+static constexpr uint num_frames = 64;
+
+struct SawtoothSource : public MonoSource
+{
+	Sample sample = 0;
+	virtual uint getAudio(MonoSample* buffer, uint num_frames) noexcept override
+	{
+		for (uint i = 0; i < num_frames; i++) buffer[i] = sample += 97;
+		return num_frames;
+	}
+};
+
+static void run(cstr name, float qfreq, MonoSource* sra)
+{
+	RCPtr<MonoSource> source = sra;
+	MonoSample		  out[num_frames];
+
+	double ns = Benchmark::measure([&] {
+		source->getAudio(out, num_frames);
+		Benchmark::do_not_optimize(out);
+	});
+	printf("%-7s %7.0f %10.2f\n", name, double(qfreq), ns / num_frames);
+}
+
+void sample_rate_adapter_benchmark()
+{
+	printf("\nSampleRateAdapter benchmark: mono to 48000 Hz\n");
+	printf("%-7s %7s %10s\n", "mode", "source", "ns/frame");
+
+	for (float qfreq : {22050.f, 44100.f})
+	{
+		run("float", qfreq, new SampleRateAdapter<1>(new SawtoothSource, qfreq, 48000));
+		run("linear", qfreq, new PolyphaseSampleRateAdapter<1>(new SawtoothSource, qfreq, 48000, LinearInterpolation));
+		run("cubic", qfreq, new PolyphaseSampleRateAdapter<1>(new SawtoothSource, qfreq, 48000, CubicInterpolation));
+		run("sinc", qfreq, new PolyphaseSampleRateAdapter<1>(new SawtoothSource, qfreq, 48000, SincInterpolation));
+	}
+}
+
+} // namespace kio::Audio
@@ -0,0 +1,178 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Pixmap_wAttr.h"
+#include "ScanlineRenderer.h"
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include <cstdio>
+#include <memory>
+
+
+/*
+	Benchmark for the ScanlineRenderers.
+
+	The ScanlineRenderers are run on the host with the emulated interpolators, see Interp.h.
+	Absolute numbers are therefore meaningless for the RP2040, but relative changes are not:
+	a regression in a render function should show up here as well.
+
+	ns/px:    average time per pixel
+	pixels:   bytes read from the pixmap per scanline
+	attr:     bytes read from the attributes per scanline
+	out:      bytes written to the scanline buffer per scanline
+*/
+
+
+namespace kio::Video
+{
+using namespace Graphics;
+
+static constexpr int  widths[] = {320, 400, 640, 800, 1024, 1280};
+static constexpr int  height   = 48; // multiple of attrheight
+static constexpr auto ah	   = attrheight_12px;
+
+static Xoshiro128 rng(12345);
+
+static void randomize(uint8* p, uint count) noexcept
+{
+	while (count--) *p++ = uint8(rng.next());
+}
+
+static void randomize(Color* p, uint count) noexcept
+{
+	while (count--) *p++ = Color(rng.next());
+}
+
+static void print_header() noexcept
+{
+	printf("\nScanlineRenderer benchmark: %u bit colors\n", uint(sizeof(Color) * 8));
+	printf("%-8s %6s %10s %8s %8s %8s %8s\n", "mode", "width", "ns/px", "pixels", "attr", "out", "total");
+}
+
+static void print_result(cstr name, int width, double ns_per_frame, uint pixel_bytes, uint attr_bytes) noexcept
+{
+	uint out_bytes = uint(width) * sizeof(Color);
+	printf(
+		"%-8s %6i %10.3f %8u %8u %8u %8u\n", name, width, ns_per_frame / (width * height), pixel_bytes, attr_bytes,
+		out_bytes, pixel_bytes + attr_bytes + out_bytes);
+}
+
+
+// _______________________________________________________________________________________
+// direct color modes
+
+template<typename Renderer>
+static void bench_indexed(cstr name, ColorDepth cd, int width) noexcept
+{
+	Color colormap[256];
+	randomize(colormap, 256);
+
+	uint   row_offset = uint(width) << cd >> 3;
+	auto   pixels	  = std::make_unique<uint8[]>(row_offset * height);
+	auto   scanline	  = std::make_unique<uint32[]>(uint(width) * sizeof(Color) / sizeof(uint32) + 1);
+	auto   renderer	  = std::make_unique<Renderer>(colormap);
+	uint8* px		  = pixels.get();
+	randomize(px, row_offset * height);
+
+	double ns = Benchmark::measure([&] {
+		for (int row = 0; row < height; row++) renderer->render(scanline.get(), uint(width), px + row * row_offset);
+		Benchmark::do_not_optimize(scanline[0]);
+	});
+
+	print_result(name, width, ns, row_offset, 0);
+}
+
+static void bench_rgb(int width) noexcept
+{
+	Pixmap<colormode_rgb> pixmap(width, height);
+	randomize(pixmap.pixmap, uint(pixmap.row_offset * height));
+	auto scanline = std::make_unique<uint32[]>(uint(width) * sizeof(Color) / sizeof(uint32) + 1);
+
+	double ns = Benchmark::measure([&] {
+		for (int row = 0; row < height; row++)
+			ScanlineRenderer_rgb(scanline.get(), uint(width), pixmap.pixmap + row * pixmap.row_offset);
+		Benchmark::do_not_optimize(scanline[0]);
+	});
+
+	print_result("rgb", width, ns, uint(width) << colordepth_rgb >> 3, 0);
+}
+
+static void bench_ham(int width) noexcept
+{
+	Color colormap[256];
+	randomize(colormap, 256);
+
+	Pixmap<colormode_i8> pixmap(width, height);
+	randomize(pixmap.pixmap, uint(pixmap.row_offset * height));
+	auto scanline = std::make_unique<uint32[]>(uint(width) * sizeof(Color) / sizeof(uint32) + 1);
+
+	HamImageScanlineRenderer renderer(colormap, 128);
+
+	double ns = Benchmark::measure([&] {
+		renderer.vblank();
+		for (int row = 0; row < height; row++)
+			renderer.render(scanline.get(), uint(width), pixmap.pixmap + row * pixmap.row_offset);
+		Benchmark::do_not_optimize(scanline[0]);
+	});
+
+	print_result("ham", width, ns, uint(width), 0);
+}
+
+
+// _______________________________________________________________________________________
+// attribute modes
+
+template<ColorMode CM>
+static void bench_attr(int width) noexcept
+{
+	using Pixmap = Graphics::Pixmap<CM>;
+
+	Pixmap pixmap(width, height, ah);
+	randomize(pixmap.pixmap, uint(pixmap.row_offset * height));
+	randomize(pixmap.attributes.pixmap, uint(pixmap.attributes.row_offset * pixmap.attributes.height));
+	auto scanline = std::make_unique<uint32[]>(uint(width) * sizeof(Color) / sizeof(uint32) + 1);
+
+	double ns = Benchmark::measure([&] {
+		for (int row = 0; row < height; row++)
+		{
+			const uint8* px	  = pixmap.pixmap + row * pixmap.row_offset;
+			const uint8* attr = pixmap.attributes.pixmap + row / ah * pixmap.attributes.row_offset;
+			ScanlineRenderer<CM>(scanline.get(), uint(width), px, attr);
+		}
+		Benchmark::do_not_optimize(scanline[0]);
+	});
+
+	uint pixel_bytes = uint(width) << Pixmap::bits_per_pixel >> 3;
+	uint attr_bytes	 = uint(Pixmap::calc_attr_row_offset(width));
+	print_result(tostr(CM), width, ns, pixel_bytes, attr_bytes);
+}
+
+
+// _______________________________________________________________________________________
+
+void scanline_renderer_benchmark()
+{
+	initializeInterpolators();
+	print_header();
+
+	for (int width : widths)
+	{
+		bench_indexed<ScanlineRenderer_i1>("i1", colordepth_1bpp, width);
+		bench_indexed<ScanlineRenderer_i2>("i2", colordepth_2bpp, width);
+		bench_indexed<ScanlineRenderer_i4>("i4", colordepth_4bpp, width);
+		bench_indexed<ScanlineRenderer_i8>("i8", colordepth_8bpp, width);
+		bench_rgb(width);
+		bench_attr<colormode_a1w1>(width);
+		bench_attr<colormode_a1w2>(width);
+		bench_attr<colormode_a1w4>(width);
+		bench_attr<colormode_a1w8>(width);
+		bench_attr<colormode_a2w1>(width);
+		bench_attr<colormode_a2w2>(width);
+		bench_attr<colormode_a2w4>(width);
+		bench_attr<colormode_a2w8>(width);
+		bench_ham(width);
+	}
+}
+
+} // namespace kio::Video
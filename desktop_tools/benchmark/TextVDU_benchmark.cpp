@@ -0,0 +1,146 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Graphics/Pixmap_wAttr.h"
+#include "Graphics/TextVDU.h"
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include <cstdio>
+#include <string>
+
+
+/*
+	Benchmark for the text output of the terminal, e.g. when a log file is `cat`ed.
+
+	The text consists of log lines with 30 to 79 printable chars and a newline.
+	It is printed on a 640x480 screen, which scrolls most of the time.
+
+	char: printChar() for each char and newLine() for '\n', as AnsiTerm did before.
+	run:  print(), which prints the runs of printable chars with printRun().
+
+	The bold lines print the text in bold with and without the glyph cache.
+*/
+
+
+namespace kio
+{
+using namespace Graphics;
+
+static constexpr uint text_size = 256 * 1024;
+
+static std::string make_log_text()
+{
+	Xoshiro128	rng(42);
+	std::string text;
+	while (text.size() < text_size)
+	{
+		char bu[120];
+		uint n = uint(snprintf(
+			bu, sizeof(bu), "[%5u.%03u] usb: device %u: vid=0x%04x pid=0x%04x ", rng.random(100000u), rng.random(1000u),
+			rng.random(8u), rng.random(0x10000u), rng.random(0x10000u)));
+		uint len = 30 + rng.random(50u);
+		while (n < len) bu[n++] = char('a' + rng.random(26u));
+		text.append(bu, len);
+		text += '\n';
+	}
+	return text;
+}
+
+static void print_chars(TextVDU& tv, const std::string& text)
+{
+	for (char c : text)
+	{
+		if (c == '\n') tv.newLine();
+		else tv.printChar(c);
+	}
+}
+
+static void bench(cstr name, CanvasPtr pixmap, const std::string& text)
+{
+	TextVDU tv(pixmap);
+	tv.cls();
+
+	double char_ns = Benchmark::measure([&] { print_chars(tv, text); }, 200000000);
+	double run_ns  = Benchmark::measure([&] { tv.print(text.c_str()); }, 200000000);
+
+	printf(
+		"%-6s %10.1f %10.1f %8.2f\n", name, double(text.size()) * 1e3 / char_ns, double(text.size()) * 1e3 / run_ns,
+		char_ns / run_ns);
+}
+
+static void bench_bold(cstr name, CanvasPtr pixmap, const std::string& text)
+{
+	TextVDU tv(pixmap);
+	tv.cls();
+	tv.setAttributes(tv.BOLD);
+	tv.setGlyphCacheSize(32);
+
+	double cache_ns = Benchmark::measure([&] { tv.print(text.c_str()); }, 200000000);
+	double hits		= double(tv.glyph_cache_hits) / double(tv.glyph_cache_hits + tv.glyph_cache_misses);
+	tv.setGlyphCacheSize(0);
+	double none_ns = Benchmark::measure([&] { tv.print(text.c_str()); }, 200000000);
+
+	printf(
+		"%-6s %10.1f %10.1f %8.2f %7.1f%%\n", name, double(text.size()) * 1e3 / cache_ns,
+		double(text.size()) * 1e3 / none_ns, none_ns / cache_ns, hits * 100);
+}
+
+void textvdu_benchmark()
+{
+	std::string text = make_log_text();
+
+	printf("\nTextVDU benchmark: print %u kB of log lines on a 640x480 screen\n", uint(text.size() / 1024));
+	printf("%-6s %10s %10s %8s\n", "mode", "char MB/s", "run MB/s", "speedup");
+
+	bench("i1", new Pixmap<colormode_i1>(640, 480), text);
+	bench("i8", new Pixmap<colormode_i8>(640, 480), text);
+	bench("a1w8", new Pixmap<colormode_a1w8>(640, 480, attrheight_12px), text);
+
+	printf("\n%-6s %10s %10s %8s %8s\n", "bold", "cache MB/s", "none MB/s", "speedup", "hits");
+	bench_bold("i1", new Pixmap<colormode_i1>(640, 480), text);
+	bench_bold("a1w8", new Pixmap<colormode_a1w8>(640, 480, attrheight_12px), text);
+}
+
+} // namespace kio
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,51 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "standard_types.h"
+#include <chrono>
+
+/*
+	Helpers for the host benchmarks.
+	Benchmarks print their results to stdout. They don't check anything: that's what the unit tests are for.
+*/
+
+namespace kio::Benchmark
+{
+
+// monotonic time in nanoseconds
+inline uint64 now_ns() noexcept
+{
+	using namespace std::chrono;
+	return uint64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// prevent the compiler from optimizing away a result
+template<typename T>
+inline void do_not_optimize(const T& value) noexcept
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// run fu() repeatedly until min_ns have elapsed.
+// returns the average time per call in nanoseconds.
+template<typename FU>
+double measure(FU&& fu, uint64 min_ns = 20000000) noexcept
+{
+	fu(); // warm up caches
+
+	uint   count = 0;
+	uint64 start = now_ns();
+	uint64 end;
+	do {
+		fu();
+		count++;
+		end = now_ns();
+	}
+	while (end - start < min_ns);
+
+	return double(end - start) / count;
+}
+
+} // namespace kio::Benchmark
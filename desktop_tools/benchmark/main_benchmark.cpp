@@ -0,0 +1,77 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "cdefs.h"
+#include "cstrings.h"
+#include <cstdarg>
+#include <cstdio>
+
+/*
+	Host benchmarks for the hot code paths of kilipili.
+
+	usage: Benchmark [name…]
+	without arguments all benchmarks are run.
+*/
+
+namespace kio
+{
+void panic(const char* fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	vprintf(fmt, va);
+	exit(2);
+}
+
+namespace Audio
+{
+extern void audio_mixer_benchmark();
+extern void sample_rate_adapter_benchmark();
+extern void ay38912_benchmark();
+}
+namespace Video
+{
+extern void scanline_renderer_benchmark();
+extern void multi_sprites_plane_benchmark();
+}
+extern void malloc_benchmark();
+extern void dispatcher_benchmark();
+extern void fatfile_benchmark();
+extern void gif_decoder_benchmark();
+extern void textvdu_benchmark();
+
+struct BenchmarkInfo
+{
+	cstr name;
+	void (*fu)();
+};
+
+static constexpr BenchmarkInfo benchmarks[] = {
+	{"ScanlineRenderer", Video::scanline_renderer_benchmark},
+	{"malloc", malloc_benchmark},
+	{"Dispatcher", dispatcher_benchmark},
+	{"MultiSpritesPlane", Video::multi_sprites_plane_benchmark},
+	{"FatFile", fatfile_benchmark},
+	{"GifDecoder", gif_decoder_benchmark},
+	{"AudioMixer", Audio::audio_mixer_benchmark},
+	{"SampleRateAdapter", Audio::sample_rate_adapter_benchmark},
+	{"Ay38912", Audio::ay38912_benchmark},
+	{"TextVDU", textvdu_benchmark},
+};
+
+} // namespace kio
+
+
+int main(int argc, char** argv)
+{
+	using namespace kio;
+
+	for (const BenchmarkInfo& b : benchmarks)
+	{
+		bool run = argc <= 1;
+		for (int i = 1; i < argc; i++) run |= eq(argv[i], b.name);
+		if (run) b.fu();
+	}
+	return 0;
+}
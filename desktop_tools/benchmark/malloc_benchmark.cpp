@@ -0,0 +1,110 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Xoshiro128.h"
+#include "benchmark.h"
+#include "common/malloc.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+/*
+	Benchmark for malloc() and free() in common/malloc.cpp.
+
+	The current allocator with the free lists for small chunks (namespace HostHeap) is compared
+	with the previous first-fit allocator (namespace HostHeap0, see malloc_first_fit.cpp).
+	Both work in their own static heap of 200 kB.
+
+	The workload first fills the heap with many small and some larger chunks and then
+	replaces random chunks with new chunks of random size, which fragments the heap.
+	The latency of each malloc() is measured and the percentiles are printed.
+	The host runs the allocator with extended validation if DEBUG is defined.
+*/
+
+
+namespace kio::HostHeap0
+{
+extern void*	   malloc(size_t size);
+extern void		   free(void* mem);
+extern const char* check_heap();
+extern size_t	   heap_largest_free_block();
+} // namespace kio::HostHeap0
+
+
+namespace kio
+{
+
+struct Allocator
+{
+	cstr name;
+	void* (*malloc)(size_t);
+	void (*free)(void*);
+	const char* (*check_heap)();
+	size_t (*heap_largest_free_block)();
+};
+
+static constexpr int num_slots = 800;
+static constexpr int num_ops   = 200000;
+
+static uint random_size(Xoshiro128& rng) noexcept
+{
+	// 75% small objects like RCObjects and short strings, some medium and a few large ones:
+	uint n = rng.next() % 100;
+	if (n < 75) return 4 + rng.next() % 60;
+	if (n < 97) return 64 + rng.next() % 448;
+	return 512 + rng.next() % 3584;
+}
+
+static void run(const Allocator& a) noexcept
+{
+	Xoshiro128			rng(4711);
+	std::vector<void*>	slots(num_slots, nullptr);
+	std::vector<uint32> times;
+	times.reserve(num_ops);
+	uint failed = 0;
+
+	for (void*& p : slots) p = a.malloc(random_size(rng));
+
+	for (int i = 0; i < num_ops; i++)
+	{
+		void*& p = slots[rng.next() % num_slots];
+		a.free(p);
+
+		uint   size	 = random_size(rng);
+		uint64 start = Benchmark::now_ns();
+		p			 = a.malloc(size);
+		uint64 end	 = Benchmark::now_ns();
+
+		times.push_back(uint32(end - start));
+		failed += p == nullptr;
+	}
+
+	cstr error = a.check_heap();
+	for (void*& p : slots) a.free(p);
+
+	std::sort(times.begin(), times.end());
+	auto percentile = [&](double f) { return times[uint(f * (times.size() - 1))]; };
+
+	printf(
+		"%-14s %8u %8u %8u %8u %8u %8u %8u  %s\n", a.name, percentile(0.5), percentile(0.9), percentile(0.99),
+		percentile(0.999), times.back(), failed, uint(a.heap_largest_free_block()), error ? error : "ok");
+}
+
+void malloc_benchmark()
+{
+	static constexpr Allocator allocators[] = {
+		{"first fit", HostHeap0::malloc, HostHeap0::free, HostHeap0::check_heap, HostHeap0::heap_largest_free_block},
+		{"size classes", HostHeap::malloc, HostHeap::free, HostHeap::check_heap, HostHeap::heap_largest_free_block},
+	};
+
+	printf("\nmalloc benchmark: %i chunks, %i x free + malloc, latency in ns\n", num_slots, num_ops);
+	printf(
+		"%-14s %8s %8s %8s %8s %8s %8s %8s  %s\n", "allocator", "p50", "p90", "p99", "p99.9", "max", "failed",
+		"largest", "check_heap");
+
+	for (const Allocator& a : allocators) run(a);
+}
+
+} // namespace kio
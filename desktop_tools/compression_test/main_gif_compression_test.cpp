@@ -317,7 +317,7 @@ static void convert_file(cstr indir, __unused cstr outdir, cstr infile)
 		std::unique_ptr<Color[]> cmap {new Color[256]};
 		if (!gif.isa_gif_file) throw "not a gif file";
 		RCPtr<Pixmap_i8> canvas = new Pixmap_i8(gif.image_width, gif.image_height);
-		gif.decode_image(canvas, cmap.get());
+		gif.decode_image(*canvas, cmap.get());
 		convert_image(canvas, cmap.get(), 1 << gif.global_cmap_bits);
 	}
 	catch (Error e)
@@ -3,6 +3,7 @@
 #include "common/cstrings.h"
 #include "common/standard_types.h"
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <dirent.h>
 #include <exception>
@@ -37,7 +38,12 @@ static void convert_file(cstr indir, __unused cstr outdir, cstr infile)
 	try
 	{
 		RgbImageCompressor encoder;
+		encoder.print_timing = true;
+
+		auto start = std::chrono::steady_clock::now();
 		encoder.encodeImage(indir, outdir, infile, true, DitherMode::Diffusion);
+		auto end = std::chrono::steady_clock::now();
+		printf("total time: %.1f ms\n", std::chrono::duration<double, std::milli>(end - start).count());
 	}
 	catch (Error e)
 	{
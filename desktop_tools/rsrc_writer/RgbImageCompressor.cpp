@@ -7,6 +7,11 @@
 #include "common/Xoshiro128.h"
 #include "common/basic_math.h"
 #include "common/cstrings.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #define STBI_FAILURE_USERMSG 1
 #include "extern/stb/stb_image.h"
@@ -89,6 +94,9 @@ static constexpr int rel_dim = 2 * rel_max + 1;
 // test result: any better result aka `total_deviation` comes at cost of more high deviations! TODO
 constexpr int max_bad_runs = 2;
 
+// number of threads for the time consuming loops:
+static const int num_threads = int(max(1u, std::thread::hardware_concurrency()));
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -138,6 +146,24 @@ constexpr double unweighted_deviation(double weighted_deviation)
 }
 
 
+template<typename FU>
+static void parallel_for(int a, int e, int min_chunk, FU&& fu)
+{
+	// call fu(a1,e1) for consecutive sub ranges of [a,e) in parallel threads.
+	// ranges shorter than 2*min_chunk are handled in the current thread.
+	// fu must only write to data which is not touched by the other sub ranges.
+
+	int n = min(num_threads, (e - a) / max(min_chunk, 1));
+	if (n <= 1) return fu(a, e);
+
+	std::vector<std::thread> threads;
+	threads.reserve(uint(n - 1));
+	for (int i = 1; i < n; i++) threads.emplace_back(fu, a + (e - a) * i / n, a + (e - a) * (i + 1) / n);
+	fu(a, a + (e - a) / n);
+	for (auto& thread : threads) thread.join();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -353,7 +379,10 @@ struct EncodedImage
 	double unweighted_total_deviation() const;
 
 private:
-	void encode();
+	struct Usage;
+	void	encode();
+	AbsCode encode_pixel(AbsCode current, const uint8* q, uint8* z, Usage&);
+	void	add_usage(const Usage&);
 };
 
 
@@ -369,6 +398,13 @@ void RgbCube<rdim, gdim, bdim>::blur(int n)
 	// each pixel affects all pixels in range [-n .. +n]
 	// the border pixels are assumed to be padding and receive bleeding only.
 
+	// the blur map is not separable: there is no 1-dim kernel {y,x,y} with x³=8, x²y=5 and xy²=3.
+	// the slices are blurred in parallel. the sum for each cell is calculated in the same order
+	// as ever, because float addition is not associative and the result must not change.
+	// the innermost loop runs over b with unit stride and can be vectorized by the compiler.
+
+	std::unique_ptr<RgbCube> z {new RgbCube};
+
 	while (--n >= 0)
 	{
 		// 3x3x3 blur map:
@@ -382,56 +418,89 @@ void RgbCube<rdim, gdim, bdim>::blur(int n)
 		constexpr float c = 3;
 		constexpr float d = 2;
 
-		RgbCube z;
-
-		for (int i = 1; i < rdim - 1; i++)
-			for (int j = 1; j < gdim - 1; j++)
-				for (int k = 1; k < bdim - 1; k++)
+		parallel_for(1, rdim - 1, 4, [this, &z](int i0, int i1) {
+			for (int i = i0; i < i1; i++)
+				for (int j = 1; j < gdim - 1; j++)
 				{
-					float v = 0;
-					v += values[i - 1][j - 1][k - 1] * d;
-					v += values[i - 1][j - 1][k + 0] * c;
-					v += values[i - 1][j - 1][k + 1] * d;
-					v += values[i - 1][j + 0][k - 1] * c;
-					v += values[i - 1][j + 0][k + 0] * b;
-					v += values[i - 1][j + 0][k + 1] * c;
-					v += values[i - 1][j + 1][k - 1] * d;
-					v += values[i - 1][j + 1][k + 0] * c;
-					v += values[i - 1][j + 1][k + 1] * d;
-					v += values[i + 0][j - 1][k - 1] * c;
-					v += values[i + 0][j - 1][k + 0] * b;
-					v += values[i + 0][j - 1][k + 1] * c;
-					v += values[i + 0][j + 0][k - 1] * b;
-					v += values[i + 0][j + 0][k + 0] * a;
-					v += values[i + 0][j + 0][k + 1] * b;
-					v += values[i + 0][j + 1][k - 1] * c;
-					v += values[i + 0][j + 1][k + 0] * b;
-					v += values[i + 0][j + 1][k + 1] * c;
-					v += values[i + 1][j - 1][k - 1] * d;
-					v += values[i + 1][j - 1][k + 0] * c;
-					v += values[i + 1][j - 1][k + 1] * d;
-					v += values[i + 1][j + 0][k - 1] * c;
-					v += values[i + 1][j + 0][k + 0] * b;
-					v += values[i + 1][j + 0][k + 1] * c;
-					v += values[i + 1][j + 1][k - 1] * d;
-					v += values[i + 1][j + 1][k + 0] * c;
-					v += values[i + 1][j + 1][k + 1] * d;
-					z.values[i][j][k] = v;
+					const float* q0 = values[i - 1][j - 1];
+					const float* q1 = values[i - 1][j + 0];
+					const float* q2 = values[i - 1][j + 1];
+					const float* q3 = values[i + 0][j - 1];
+					const float* q4 = values[i + 0][j + 0];
+					const float* q5 = values[i + 0][j + 1];
+					const float* q6 = values[i + 1][j - 1];
+					const float* q7 = values[i + 1][j + 0];
+					const float* q8 = values[i + 1][j + 1];
+					float*		 zz = z->values[i][j];
+
+					for (int k = 1; k < bdim - 1; k++)
+					{
+						float v = 0;
+						v += q0[k - 1] * d;
+						v += q0[k + 0] * c;
+						v += q0[k + 1] * d;
+						v += q1[k - 1] * c;
+						v += q1[k + 0] * b;
+						v += q1[k + 1] * c;
+						v += q2[k - 1] * d;
+						v += q2[k + 0] * c;
+						v += q2[k + 1] * d;
+						v += q3[k - 1] * c;
+						v += q3[k + 0] * b;
+						v += q3[k + 1] * c;
+						v += q4[k - 1] * b;
+						v += q4[k + 0] * a;
+						v += q4[k + 1] * b;
+						v += q5[k - 1] * c;
+						v += q5[k + 0] * b;
+						v += q5[k + 1] * c;
+						v += q6[k - 1] * d;
+						v += q6[k + 0] * c;
+						v += q6[k + 1] * d;
+						v += q7[k - 1] * c;
+						v += q7[k + 0] * b;
+						v += q7[k + 1] * c;
+						v += q8[k - 1] * d;
+						v += q8[k + 0] * c;
+						v += q8[k + 1] * d;
+						zz[k] = v;
+					}
 				}
+		});
 
-		*this = z;
+		memcpy(values, z->values, sizeof(values));
 	}
 }
 
 template<int rdim, int gdim, int bdim>
 bool RgbCube<rdim, gdim, bdim>::find_maximum(int& r, int& g, int& b, int padding)
 {
-	r = g = b	  = 0;
-	float maximum = 0;
+	// search slices of the cube in parallel and then take the first maximum in the order of the slices.
+	// this yields the same result as a sequential search.
+
+	struct Result
+	{
+		float maximum = 0;
+		int	  r = 0, g = 0, b = 0;
+	};
+	Result results[rdim];
+
+	parallel_for(padding, rdim - padding, 8, [this, padding, &results](int r0, int r1) {
+		Result& result = results[r0];
+		for (int ri = r0; ri < r1; ri++)
+			for (int gi = padding; gi < gdim - padding; gi++)
+			{
+				const float* q = values[ri][gi];
+				for (int bi = padding; bi < bdim - padding; bi++)
+					if unlikely (q[bi] > result.maximum) result = {q[bi], ri, gi, bi};
+			}
+	});
+
+	Result result;
 	for (int ri = padding; ri < rdim - padding; ri++)
-		for (int gi = padding; gi < gdim - padding; gi++)
-			for (int bi = padding; bi < bdim - padding; bi++)
-				if unlikely (values[ri][gi][bi] > maximum) { maximum = values[r = ri][g = gi][b = bi]; }
+		if (results[ri].maximum > result.maximum) result = results[ri];
+
+	r = result.r, g = result.g, b = result.b;
 	return r != 0; // 0=nothing left => invalid return, 1=valid return
 }
 
@@ -819,21 +888,23 @@ void AbsCodes::fix_colors()
 	if (code_map_changed == false) return;
 	code_map_changed = false;
 
-	for (int r = 0; r < 1 << rbits; r++)
-		for (int g = 0; g < 1 << gbits; g++)
-			for (int b = 0; b < 1 << bbits; b++)
-				if (ColorInfo& info = colors[r][g][b])
-				{
-					int best_code = 0;
-					int deviation = 0xffff;
-					for (int i = 0; i < num_codes; i++)
+	parallel_for(0, 1 << rbits, 2, [this](int r0, int r1) {
+		for (int r = r0; r < r1; r++)
+			for (int g = 0; g < 1 << gbits; g++)
+				for (int b = 0; b < 1 << bbits; b++)
+					if (ColorInfo& info = colors[r][g][b])
 					{
-						int d = codes[i].abs_code.distance(r, g, b);
-						if (d < deviation) deviation = d, best_code = i;
+						int best_code = 0;
+						int deviation = 0xffff;
+						for (int i = 0; i < num_codes; i++)
+						{
+							int d = codes[i].abs_code.distance(r, g, b);
+							if (d < deviation) deviation = d, best_code = i;
+						}
+						info.deviation = uint16(deviation);
+						info.abs_code  = codes[best_code].abs_code;
 					}
-					info.deviation = uint16(deviation);
-					info.abs_code  = codes[best_code].abs_code;
-				}
+	});
 }
 
 inline AbsCodes::ColorInfo& AbsCodes::get(int r, int g, int b)
@@ -1035,6 +1106,70 @@ EncodedImage::EncodedImage(EncodedImage* old, int min_gap) :
 	encode();
 }
 
+// usage counts and deviation collected by one thread in encode():
+struct EncodedImage::Usage
+{
+	uint32 abs_usage[1 << (rbits + gbits + bbits)];
+	uint32 rel_usage[rel_dim * rel_dim * rel_dim];
+	uint32 total_weighted_deviation;
+};
+
+inline AbsCode EncodedImage::encode_pixel(AbsCode current, const uint8* q, uint8* z, Usage& usage)
+{
+	// find best abs or rel code to update current to next pixel.
+	// store the code and return current updated by applying the code.
+	// increment the usage count of the desired code in the used abs_code or rel_code table.
+
+	uint8 new_r = q[0], new_g = q[1], new_b = q[2]; // color of next pixel
+
+	auto&	abs_info = abs_codes.get(new_r, new_g, new_b);
+	uint	rel_deviation;
+	auto&	rel_info  = rel_codes.get(&rel_deviation, new_r - current.r, new_g - current.g, new_b - current.b);
+	uint32& abs_usage = usage.abs_usage[&abs_info - &abs_codes.colors[0][0][0]];
+	uint32& rel_usage = usage.rel_usage[&rel_info - &rel_codes.colors[0][0][0]];
+
+	if (rel_deviation <= abs_info.deviation)
+	{
+		usage.total_weighted_deviation += weighted_deviation(rel_deviation);
+		current += rel_info.rel_code;
+		assert(rel_info.rel_code.code >= rel_codes.first_code);
+		assert(rel_info.rel_code == rel_codes.codes[rel_info.rel_code.code].rel_code);
+		*z = rel_info.rel_code.code;
+		rel_usage++;
+		if constexpr (high_deviation_other_boost)
+			if (rel_deviation > devi_max) abs_usage++;
+	}
+	else
+	{
+		usage.total_weighted_deviation += weighted_deviation(abs_info.deviation);
+		current = abs_info.abs_code;
+		assert(abs_info.abs_code.code < abs_codes.num_codes);
+		assert(abs_info.abs_code == abs_codes.codes[abs_info.abs_code.code].abs_code);
+		*z = abs_info.abs_code.code;
+		abs_usage++;
+		if constexpr (high_deviation_other_boost)
+			if (abs_info.deviation > devi_max) rel_usage++;
+	}
+
+	return current;
+}
+
+void EncodedImage::add_usage(const Usage& usage)
+{
+	// add the usage counts from one thread.
+	// ColorInfo::add_usage() saturates, so the order doesn't matter.
+
+	AbsCodes::ColorInfo* abs_infos = &abs_codes.colors[0][0][0];
+	for (int i = 0; i < 1 << (rbits + gbits + bbits); i++)
+		if (uint32 n = usage.abs_usage[i]) abs_infos[i].add_usage(int(min(n, 0xffffu)));
+
+	RelCodes::ColorInfo* rel_infos = &rel_codes.colors[0][0][0];
+	for (int i = 0; i < rel_dim * rel_dim * rel_dim; i++)
+		if (uint32 n = usage.rel_usage[i]) rel_infos[i].add_usage(int(min(n, 0xffffu)));
+
+	total_weighted_deviation += usage.total_weighted_deviation;
+}
+
 void EncodedImage::encode()
 {
 	// encode image using this->abs_codes and this->rel_codes
@@ -1060,52 +1195,40 @@ void EncodedImage::encode()
 		ctab[i] = i < abs_codes.num_codes ? Color(abs_codes.codes[i].abs_code) : Color(rel_codes.codes[i].rel_code);
 	}
 
-	AbsCode first {.r = 0, .g = 0, .b = 0, .code = 0}; // color of first pixel of previous scanline
-	uint8*	q = rgb_image->data;
-	uint8*	z = data;
+	// the first pixel of each row is encoded relative to the first pixel of the previous row.
+	// so we encode the first column first and then the remaining pixels of all rows in parallel.
+	// usage counts are collected per thread and added with saturation at the end,
+	// which yields the same counts as counting in one pass.
 
-	for (int y = 0; y < height; y++)
-	{
-		AbsCode current = first;
+	const int rowsize = width * rgb_image->num_channels;
 
-		for (int x = 0; x < width; x++, z++, q += rgb_image->num_channels)
-		{
-			// find best abs or rel code to update current to next pixel.
-			// update current by applying the code.
-			// increment the usage count of the desired code in the used abs_code or rel_code table.
-
-			uint8 new_r = q[0], new_g = q[1], new_b = q[2]; // color of next pixel
+	std::unique_ptr<AbsCode[]> firsts {new AbsCode[uint(height)]};
+	std::mutex				   mutex;
 
-			auto& abs_info = abs_codes.get(new_r, new_g, new_b);
-			uint  rel_deviation;
-			auto& rel_info = rel_codes.get(&rel_deviation, new_r - current.r, new_g - current.g, new_b - current.b);
+	{
+		std::unique_ptr<Usage> usage {new Usage()};
+		AbsCode				   current {.r = 0, .g = 0, .b = 0, .code = 0};
+		for (int y = 0; y < height; y++)
+		{
+			current	  = encode_pixel(current, rgb_image->data + y * rowsize, data + y * width, *usage);
+			firsts[y] = current;
+		}
+		add_usage(*usage);
+	}
 
-			if (rel_deviation <= abs_info.deviation)
-			{
-				total_weighted_deviation += weighted_deviation(rel_deviation);
-				current += rel_info.rel_code;
-				assert(rel_info.rel_code.code >= rel_codes.first_code);
-				assert(rel_info.rel_code == rel_codes.codes[rel_info.rel_code.code].rel_code);
-				*z = rel_info.rel_code.code;
-				rel_info.add_usage();
-				if constexpr (high_deviation_other_boost)
-					if (rel_deviation > devi_max) abs_info.add_usage();
-			}
-			else
-			{
-				total_weighted_deviation += weighted_deviation(abs_info.deviation);
-				current = abs_info.abs_code;
-				assert(abs_info.abs_code.code < abs_codes.num_codes);
-				assert(abs_info.abs_code == abs_codes.codes[abs_info.abs_code.code].abs_code);
-				*z = abs_info.abs_code.code;
-				abs_info.add_usage();
-				if constexpr (high_deviation_other_boost)
-					if (abs_info.deviation > devi_max) rel_info.add_usage();
-			}
+	parallel_for(0, height, 16, [&](int y0, int y1) {
+		std::unique_ptr<Usage> usage {new Usage()};
+		for (int y = y0; y < y1; y++)
+		{
+			AbsCode		 current = firsts[y];
+			const uint8* q		 = rgb_image->data + y * rowsize;
+			uint8*		 z		 = data + y * width;
 
-			if unlikely (x == 0) { first = current; }
+			for (int x = 1; x < width; x++) { current = encode_pixel(current, q + x * rgb_image->num_channels, z + x, *usage); }
 		}
-	}
+		const std::lock_guard lock(mutex);
+		add_usage(*usage);
+	});
 }
 
 void EncodedImage::write_to_file(File* file)
@@ -1398,17 +1521,29 @@ RgbImageCompressor::~RgbImageCompressor() {}
 
 int RgbImageCompressor::encode_image()
 {
+	using Clock = std::chrono::steady_clock;
+
+	auto print_pass = [this](int round, Clock::time_point start, EncodedImage* image) {
+		if (!print_timing) return;
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		printf("  pass %2i: %8.1f ms  deviation = %u\n", round, ms, image->total_weighted_deviation);
+	};
+
+	Clock::time_point	start	   = Clock::now();
 	RCPtr<EncodedImage> next_image = new EncodedImage(image);
 	encoded_image				   = next_image;
 	int rounds					   = 1;
 	int min_code_gap			   = 32; // codes to delete and add again
 	int num_bad_runs			   = 0;	 // runs without improvement
+	print_pass(rounds, start, next_image);
 
 	while (num_bad_runs < max_bad_runs && rounds < 99)
 	{
 		rounds += 1;
+		start		 = Clock::now();
 		next_image	 = new EncodedImage(next_image, min_code_gap);
 		min_code_gap = max(min_code_gap * 3 / 4, 2);
+		print_pass(rounds, start, next_image);
 		if (next_image->total_weighted_deviation < encoded_image->total_weighted_deviation)
 		{
 			encoded_image = next_image;
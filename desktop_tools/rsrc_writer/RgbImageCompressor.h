@@ -51,7 +51,7 @@
 	  A usage map for all colors of the hardware Color is created from the actually used colors from the last run.
 	  The usage map is blurred and then blurred holes for all available abs_color code are punched.
 	  In the remaining usage map the high spots are searched and assigned for additional abs_color codes.
-	  *** Blurring is very time consuming.
+	  *** Blurring is very time consuming. It is done in parallel threads, as is the search for the high spots.
 	- Removing absolute colors:
 	  Within each run all used colors are counted.
 	  The codes with the lowest count are removed.
@@ -63,6 +63,10 @@
 	  Within each run all used and could-have-been-used color offsets within a maximum allowed range are counted.
 	  The codes with the lowest count are removed.
 
+	- Encoding a run is done in parallel threads with one band of rows per thread.
+	  The first pixel of each row depends on the first pixel of the previous row only,
+	  so the first column is encoded first. The result does not depend on the number of threads.
+
 	Remaining problems:
 
 	Some images have visual artifacts. These are images with highlight colors with low pixel count or images
@@ -98,6 +102,7 @@ public:
 	bool write_ref_image	= false;
 	bool write_stats_file	= false;
 	bool enriched_filenames = false;
+	bool print_timing		= false; // print time and deviation of each optimize-and-encode pass
 
 	RCPtr<struct RgbImage>	   image;		  // image dithered and reduced to native color depth
 	RCPtr<struct EncodedImage> encoded_image; // current / last / best encoded image
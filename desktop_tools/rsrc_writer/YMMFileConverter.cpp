@@ -10,6 +10,7 @@
 #include "Audio/Ay38912.h"
 #include "Devices/DevNull.h"
 #include "Devices/LzhDecoder.h"
+#include "Devices/RamFile.h"
 #include "Devices/StdFile.h"
 #include "cdefs.h"
 #include "cstrings.h"
@@ -215,6 +216,44 @@ uint8 BackrefBuffer::next_value(BitArray& instream)
 }
 
 
+static void write_snapshot(
+	File* file, uint32 bitpos, const BackrefBuffer* backref_buffers, const RleCode* buffer, uint winbits)
+{
+	// store the decoder state for the loop position:
+
+	file->write_LE(bitpos);
+	for (uint r = 0; r < 16; r++)
+	{
+		const BackrefBuffer& b = backref_buffers[r];
+		file->write_LE(b.index);
+		file->putc(char(b.regvalue));
+		file->putc(char(b.regcount));
+		file->write_LE(b.backrefoffset);
+		file->write_LE(b.backrefcount);
+	}
+	file->write(buffer, sizeof(RleCode) << winbits);
+}
+
+static uint32 read_snapshot(File* file, BackrefBuffer* backref_buffers, RleCode* buffer, uint winbits)
+{
+	// restore the decoder state for the loop position, same as the player.
+	// returns the bit position.
+
+	uint32 bitpos = file->read_LE<uint32>();
+	for (uint r = 0; r < 16; r++)
+	{
+		BackrefBuffer& b = backref_buffers[r];
+		b.index			 = file->read_LE<uint16>();
+		b.regvalue		 = uint8(file->getc());
+		b.regcount		 = uint8(file->getc());
+		b.backrefoffset	 = file->read_LE<uint16>();
+		b.backrefcount	 = file->read_LE<uint16>();
+	}
+	file->read(buffer, sizeof(RleCode) << winbits);
+	return bitpos;
+}
+
+
 // ############### Helper Functions ##########################
 
 
@@ -415,9 +454,10 @@ static BitArray encode_as_bitstream(Array<ValueCount>& indata, uint aybits, uint
 	return outdata;
 }
 
-void YMMFileConverter::decode_ymm(uint32 rbusz, BitArray& instream, uint winbits)
+void YMMFileConverter::decode_ymm(uint32 rbusz, BitArray& instream, uint winbits, File* snapshot)
 {
-	// decode the bitstream and compare register data with original register data:
+	// decode the bitstream and compare register data with original register data.
+	// then restore the snapshot and compare the frames from the loop position to the end:
 
 	assert(winbits >= 8 && winbits <= 14);
 	assert(frame_size == 16);
@@ -451,6 +491,21 @@ void YMMFileConverter::decode_ymm(uint32 rbusz, BitArray& instream, uint winbits
 				assert(value == ((register_data[r * num_frames + frame]) & ayRegisterBitMasks[r]));
 		}
 	}
+
+	if (snapshot->getSize() == 0) return; // loop_frame = 0
+	memset(allocated_buffer.get(), 0xee, sizeof(RleCode) << winbits);
+	snapshot->setFpos(0);
+	instream.set_bitpos(read_snapshot(snapshot, backref_buffers, allocated_buffer.get(), winbits));
+
+	for (uint frame = loop_frame; frame < num_frames; frame++)
+	{
+		for (uint r = 0; r < 16; r++)
+		{
+			uint8 value = backref_buffers[r].next_value(instream);
+			if (value != ((register_data[r * num_frames + frame]) & ayRegisterBitMasks[r]))
+				throw "YMM: snapshot test failed";
+		}
+	}
 }
 
 
@@ -462,7 +517,7 @@ void YMMFileConverter::export_ymm_file(File* file, SerialDevice* log, uint winbi
 	assert(winbits >= 8 && winbits <= 14); // sanity
 
 	file->puts("ymm!");			  // file ID
-	file->putc(2);				  // variant
+	file->putc(3);				  // variant
 	file->putc(char(winbits));	  // flags
 	file->putc(char(frame_rate)); //
 	file->putc(16);				  // registers per frame
@@ -659,9 +714,17 @@ void YMMFileConverter::export_ymm_file(File* file, SerialDevice* log, uint winbi
 	}
 	assert(p == allocated_buffer.get() + (1 << winbits));
 
+	RCPtr<RamFile<>> snapshot = new RamFile<>;
+
 	BitArray combined_stream(total);
 	for (uint frame = 0; frame < num_frames; frame++)
 	{
+		if (frame == loop_frame && frame != 0) // no snapshot needed for loop_frame = 0
+		{
+			uint32 bitpos = combined_stream.count() * 8 + combined_stream.bits;
+			write_snapshot(snapshot, bitpos, backref_buffers, allocated_buffer.get(), winbits);
+		}
+
 		for (uint r = 0; r < 16; r++)
 		{
 			BitArray& source  = streams[r];
@@ -683,14 +746,21 @@ void YMMFileConverter::export_ymm_file(File* file, SerialDevice* log, uint winbi
 	}
 
 	combined_stream.finish();
+	file->write_LE(snapshot->getSize() ? combined_stream.count() : 0u); // snapshot offset
 	file->write(combined_stream.data.getData(), combined_stream.count());
 
+	Array<uint8> snapshot_data {uint(snapshot->getSize())};
+	snapshot->setFpos(0);
+	snapshot->read(snapshot_data.getData(), snapshot_data.count());
+	file->write(snapshot_data.getData(), snapshot_data.count());
+	log->printf("  snapshot: %8u bytes\n", snapshot_data.count());
+
 	// decode & compare:
 
 	if constexpr (1)
 	{
 		combined_stream.rewind();
-		decode_ymm(rbusz, combined_stream, winbits);
+		decode_ymm(rbusz, combined_stream, winbits, snapshot);
 	}
 }
 
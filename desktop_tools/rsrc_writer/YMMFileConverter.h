@@ -51,8 +51,11 @@ namespace kio::Audio
 	Also this decoder is a good reference for the actual .ymm file decoder.
 
 	The .ym and the .ymm file contains a 'loop position'.
-	In order to reach this position the bitstream must be rewound to the start
+	In variant 2 the bitstream must be rewound to the start to reach this position
 	and the frames of the intro must be skipped until the loop frame is reached.
+	Variant 3 appends a snapshot of the decoder state at the loop frame to the bitstream, if loop_frame != 0:
+	the bit position, the state of the 16 BackrefBuffers and the contents of the total buffer.
+	The player restores it in O(buffer size) instead of decoding the intro again.
 */
 class YMMFileConverter
 {
@@ -93,7 +96,7 @@ private:
 	void deinterleave_registers();
 
 	Array<uint8> extract_register_stream(uint reg, uint8 mask = 0xff);
-	void		 decode_ymm(uint32 rbusz, struct BitArray& instream, uint winbits);
+	void		 decode_ymm(uint32 rbusz, struct BitArray& instream, uint winbits, File* snapshot);
 };
 
 
@@ -13,8 +13,10 @@
 #include "common/cdefs.h"
 #include "common/standard_types.h"
 #include "exportStSoundWavFile.h"
+#include <algorithm>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_FAILURE_USERMSG 1
@@ -53,6 +55,7 @@ struct Info
 	cstr	   pattern = nullptr;
 	FType	   format  = UNSET;
 	uint8	   w = 0, l = 0;									   // compression
+	uint16	   c						  = 0;						   // compression: checkpoint interval in kB
 	DitherMode dithermode				  = DitherMode::Diffusion; // ham
 	bool	   noalpha				  : 1 = false;				   // img
 	bool	   hwcolor				  : 1 = false;				   // img
@@ -123,6 +126,13 @@ Info::Info(cstr _s)
 			for (uint i = 1; is_decimal_digit(s[i]); i++) n = n * 10 + dec_digit_value(s[i]);
 			l = uint8(n);
 		}
+		else if (startswith(s, "C"))
+		{
+			uint n = 0;
+			for (uint i = 1; is_decimal_digit(s[i]); i++) n = n * 10 + dec_digit_value(s[i]);
+			if (n == 0 || n > 1024) throw "checkpoint interval C oorange";
+			c = uint16(n);
+		}
 		else throw usingstr("unknown option %s", s);
 	}
 
@@ -290,7 +300,7 @@ static void copy_as_is(cstr indir, cstr outdir, cstr infile, const Info& info)
 		if (info.w && info.l) // compress
 		{
 			file						   = new StdFile(catstr(outdir, infile), WRITE);
-			RCPtr<HeatShrinkEncoder> cfile = new HeatShrinkEncoder(file, info.w, info.l);
+			RCPtr<HeatShrinkEncoder> cfile = new HeatShrinkEncoder(file, info.w, info.l, true, info.c * 1024u);
 			cfile->write(data.get(), fsize);
 			cfile->close();
 			assert(fsize == cfile->usize);
@@ -313,7 +323,7 @@ static void copy_as_is(cstr indir, cstr outdir, cstr infile, const Info& info)
 		{
 			file						   = new StdFile(dest_fpath, WRITE);
 			file						   = new RsrcFileEncoder(file, rsrc_fname, false);
-			RCPtr<HeatShrinkEncoder> cfile = new HeatShrinkEncoder(file, info.w, info.l, false);
+			RCPtr<HeatShrinkEncoder> cfile = new HeatShrinkEncoder(file, info.w, info.l, false, info.c * 1024u);
 			cfile->write(data.get(), fsize);
 			cfile->close();
 			assert(fsize == cfile->usize);
@@ -378,6 +388,97 @@ static void convert_file(cstr indir, cstr outdir, cstr infile)
 	}
 }
 
+static uint32 get_rsrc_size(cstr fpath, cstr* rsrc_fname)
+{
+	// get the size of the data in a .rsrc file and the file name stored in it.
+	// the .rsrc file contains comma separated decimal values and comments.
+
+	FilePtr file  = new StdFile(fpath);
+	uint32	fsize = uint32(file->getSize());
+	str		text  = tempstr(fsize);
+	file->read(text, fsize);
+
+	char   fname[256];
+	uint32 count = 0;
+	for (cptr p = text; *p;)
+	{
+		if (p[0] == '/' && p[1] == '/') // comment
+		{
+			while (*p && *p != '\n') p++;
+		}
+		else if (is_decimal_digit(*p))
+		{
+			uint n = 0;
+			while (is_decimal_digit(*p)) n = n * 10 + dec_digit_value(*p++);
+			if (count < sizeof(fname)) fname[count] = char(n);
+			count++;
+		}
+		else p++;
+	}
+
+	fname[sizeof(fname) - 1] = 0;
+	*rsrc_fname				 = substr(fname, strchr(fname, 0));
+	return count;
+}
+
+static void write_rsrc_index(FilePtr file)
+{
+	/*	write the index for the RsrcFS:
+		the offsets of all files, sorted by filename, case-insensitive.
+		the index is stored like an uncompressed file:
+
+		  char[] "\x01index"  0-terminated string
+		  uint32 size        sizeof data[]
+		  uint32 count       number of files
+		  uint32 offset[]    offsets of the files from the start of resource_file_data[]
+	*/
+
+	static constexpr char index_name[] = "\x01index";
+
+	struct Entry
+	{
+		cstr   fname;
+		uint32 offset;
+	};
+
+	uint   count  = rsrc_files.count();
+	uint32 offset = sizeof(index_name) + 4 + 4 + 4 * count;
+
+	std::vector<Entry> entries;
+	for (uint i = 0; i < count; i++)
+	{
+		cstr   fname;
+		uint32 size = get_rsrc_size(catstr(outdir, rsrc_files[i]), &fname);
+		entries.push_back(Entry {fname, offset});
+		offset += size;
+	}
+
+	// sort case-insensitive, same as in RsrcFS.
+	// names which differ only in case are sorted case-sensitively, so that the order is defined:
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		cuptr p = cuptr(a.fname), q = cuptr(b.fname);
+		while (*p && to_lower(char(*p)) == to_lower(char(*q))) { p++, q++; }
+		if (to_lower(char(*p)) != to_lower(char(*q))) return uchar(to_lower(char(*p))) < uchar(to_lower(char(*q)));
+		return strcmp(a.fname, b.fname) < 0;
+	});
+
+	auto write32 = [&](uint32 n) {
+		file->printf("%3u,%3u,%3u,%3u,", uchar(n), uchar(n >> 8), uchar(n >> 16), uchar(n >> 24));
+	};
+
+	file->puts("// index\n");
+	for (char c : index_name) file->printf("%3u,", uchar(c));
+	file->puts("\n");
+	write32(4 + 4 * count);
+	write32(count);
+	file->puts("\n");
+	for (uint i = 0; i < count; i++)
+	{
+		write32(entries[i].offset);
+		if ((i & 7) == 7 || i == count - 1) file->puts("\n");
+	}
+}
+
 static void convert_dir(cstr indir, cstr outdir, cstr subdir)
 {
 	if (!endswith(indir, "/")) indir = catstr(indir, "/");
@@ -425,7 +526,8 @@ int main(int argc, cstr argv[])
 				"1 argument = job_file\n"
 				"2++ arguments = indir outdir format options\n"
 				"formats: wav ym ymm img as_is\n"
-				"options: Wx Lx noalpha hwcolor (x=number)\n");
+				"options: Wx Lx Cx noalpha hwcolor (x=number)\n"
+				"Cx: compressed copy with checkpoints every x kB for fast setFpos()\n");
 			return 0;
 		}
 		else if (argc == 2)
@@ -478,6 +580,7 @@ int main(int argc, cstr argv[])
 			assert(file);
 			file->puts("extern const unsigned char resource_file_data[];\n");
 			file->puts("constexpr unsigned char resource_file_data[]={\n");
+			write_rsrc_index(file);
 			for (uint i = 0; i < rsrc_files.count(); i++)
 			{
 				file->printf("#include \"%s\"\n", rsrc_files[i]); //
@@ -200,12 +200,18 @@ TEST_CASE("AnsiTerm: write()")
 	Array<cstr> ref;
 	ref << "TextVDU(pixmap)";
 
-	at.write("bar", 3);
-	ref << "printChar('b',1)";
+	at.write("bar", 3); // printable run
+	ref << "printRun(\"bar\",3)";
 	ref << "showCursor(true)";
+	CHECK_EQ(at.display->log, ref);
+
+	at.insert_mode = true; // char by char
+	at.write("ab", 2);
+	ref << "insertChars(1)";
 	ref << "printChar('a',1)";
 	ref << "showCursor(true)";
-	ref << "printChar('r',1)";
+	ref << "insertChars(1)";
+	ref << "printChar('b',1)";
 	ref << "showCursor(true)";
 	CHECK_EQ(at.display->log, ref);
 }
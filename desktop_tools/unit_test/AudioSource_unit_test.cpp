@@ -2,6 +2,7 @@
 // BSD-2-Clause license
 // https://opensource.org/licenses/BSD-2-Clause
 
+#include "Audio/AudioMixer.h"
 #include "Audio/AudioSource.h"
 #include "cstrings.h"
 #include "doctest.h"
@@ -521,6 +522,184 @@ TEST_CASE("Audio::SampleRateAdapter<2>")
 	}
 }
 
+template<uint num_channels>
+struct FiniteSource : public NumberProvider<num_channels>
+{
+	uint remaining;
+	FiniteSource(AudioSample<num_channels> start, uint count) : NumberProvider<num_channels>(start), remaining(count) {}
+	virtual uint getAudio(AudioSample<num_channels>* buffer, uint num_frames) noexcept override
+	{
+		num_frames = NumberProvider<num_channels>::getAudio(buffer, min(num_frames, remaining));
+		remaining -= num_frames;
+		return num_frames;
+	}
+};
+
+TEST_CASE("Audio::AudioMixer")
+{
+	// mono and stereo sources with gain:
+	RCPtr<AudioMixer<2>> mixer = new AudioMixer<2>;
+	CHECK(mixer->addSource(new NumberProvider<1>(Sample(100)), 1.0f));
+	CHECK(mixer->addSource(new NumberProvider<2>(StereoSample(-1000, 2000)), 0.5f));
+	CHECK(mixer->addSource(new FiniteSource<1>(Sample(-200), 100), 2.0f));
+	CHECK_EQ(mixer->numSources(), 3);
+
+	constexpr uint busize = 200;
+	StereoSample   bu[busize];
+	CHECK_EQ(mixer->getAudio(bu, busize), busize);
+
+	int errors = 0;
+	for (int i = 0; i < int(busize); i++)
+	{
+		int m = 100 + i + (i < 100 ? (-200 + i) * 2 : 0);
+		errors += bu[i] != StereoSample(Sample(m + ((-1000 + i) >> 1)), Sample(m + ((2000 + i) >> 1)));
+	}
+	CHECK_EQ(errors, 0);
+	CHECK_EQ(mixer->numSources(), 2); // finite source removed
+
+	// stereo to mono:
+	RCPtr<AudioMixer<1>>	 mono	= new AudioMixer<1>;
+	RCPtr<NumberProvider<2>> source = new NumberProvider<2>(StereoSample(10, 30));
+	mono->addSource(source);
+	MonoSample mbu[10];
+	mono->getAudio(mbu, 10);
+	CHECK_EQ(mbu[0], MonoSample(20));
+	CHECK_EQ(mbu[9], MonoSample(29));
+
+	mono->setGain(source, 0);
+	mono->getAudio(mbu, 10);
+	CHECK_EQ(mbu[5], MonoSample(0));
+
+	mono->removeSource(source);
+	CHECK_EQ(mono->numSources(), 0);
+}
+
+TEST_CASE("Audio::AudioMixer: saturation")
+{
+	RCPtr<AudioMixer<1>> mixer = new AudioMixer<1>;
+	for (uint i = 0; i < AudioMixer<1>::max_sources; i++) CHECK(mixer->addSource(new NoAudioSource<1>));
+	CHECK_FALSE(mixer->addSource(new NoAudioSource<1>));
+	mixer = new AudioMixer<1>;
+
+	mixer->addSource(new NumberProvider<1>(Sample(0x7000)), 4.0f);
+	mixer->addSource(new NumberProvider<1>(Sample(-0x7000)), 1.0f);
+	MonoSample bu[4];
+	mixer->getAudio(bu, 4);
+	CHECK_EQ(bu[0], MonoSample(0x7fff));
+
+	mixer = new AudioMixer<1>;
+	mixer->addSource(new NumberProvider<2>(StereoSample(-0x7000, -0x7000)), 2.0f);
+	mixer->addSource(new NumberProvider<1>(Sample(-0x7000)), 1.0f);
+	mixer->getAudio(bu, 4);
+	CHECK_EQ(bu[3], MonoSample(-0x8000));
+}
+
+struct PreciseSineSource : public MonoSource
+{
+	double phase = 0, step, volume;
+	PreciseSineSource(double frequency, double sample_frequency, double volume = 0.8) :
+		step(2 * M_PI * frequency / sample_frequency),
+		volume(volume * 0x7fff)
+	{}
+	virtual uint getAudio(MonoSample* buffer, uint num_frames) noexcept override
+	{
+		for (uint i = 0; i < num_frames; i++, phase += step) buffer[i] = Sample(lround(volume * sin(phase)));
+		return num_frames;
+	}
+};
+
+static double measure_snr(MonoSource* source, double frequency, double sample_frequency)
+{
+	// read samples from the resampler and fit a sine wave with the expected frequency.
+	// everything which is not this sine wave is noise.
+
+	constexpr uint skip = 256, count = 8192;
+	MonoSample	   bu[skip + count];
+	for (uint i = 0; i < skip + count; i += 100) source->getAudio(bu + i, min(100u, skip + count - i));
+
+	double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+	for (uint i = 0; i < count; i++)
+	{
+		double w = 2 * M_PI * frequency / sample_frequency * i, s = sin(w), c = cos(w), y = bu[skip + i].m;
+		ss += s * s, sc += s * c, cc += c * c, ys += y * s, yc += y * c;
+	}
+	double det = ss * cc - sc * sc;
+	double a = (ys * cc - yc * sc) / det, b = (yc * ss - ys * sc) / det;
+
+	double signal = 0, noise = 0;
+	for (uint i = 0; i < count; i++)
+	{
+		double w   = 2 * M_PI * frequency / sample_frequency * i;
+		double fit = a * sin(w) + b * cos(w);
+		signal += fit * fit;
+		noise += (bu[skip + i].m - fit) * (bu[skip + i].m - fit);
+	}
+	return 10 * log10(signal / noise);
+}
+
+TEST_CASE("Audio::PolyphaseSampleRateAdapter: SNR")
+{
+	struct Case
+	{
+		float f, source_freq, dest_freq;
+	};
+	// upsampling, small ratio, downsampling:
+	static constexpr Case cases[] = {{1000, 22050, 44100}, {5000, 22050, 44100}, {1000, 44100, 48000}, {3000, 48000, 44100}};
+
+	for (const Case& c : cases)
+	{
+		auto snr = [&](ResamplerQuality q) {
+			RCPtr<MonoSource> sra =
+				new PolyphaseSampleRateAdapter<1>(new PreciseSineSource(c.f, c.source_freq), c.source_freq, c.dest_freq, q);
+			return measure_snr(sra, c.f, c.dest_freq);
+		};
+
+		RCPtr<MonoSource> sra = new SampleRateAdapter<1>(new PreciseSineSource(c.f, c.source_freq), c.source_freq, c.dest_freq);
+
+		double snr_float  = measure_snr(sra, c.f, c.dest_freq);
+		double snr_linear = snr(LinearInterpolation);
+		double snr_cubic  = snr(CubicInterpolation);
+		double snr_sinc	  = snr(SincInterpolation);
+
+		MESSAGE(c.f, " Hz: float ", snr_float, ", linear ", snr_linear, ", cubic ", snr_cubic, ", sinc ", snr_sinc);
+		CHECK_GE(snr_linear, snr_float - 0.5);
+		CHECK_GE(snr_cubic, snr_linear + 6);
+		CHECK_GE(snr_sinc, std::min(snr_cubic, 60.0)); // sinc is limited by the passband ripple
+	}
+}
+
+TEST_CASE("Audio::PolyphaseSampleRateAdapter<2>")
+{
+	// with the same sample rate the output must be identical to the input:
+	for (ResamplerQuality q : {LinearInterpolation, CubicInterpolation, SincInterpolation})
+	{
+		StereoSample v(-999, 2222);
+		RCPtr<StereoSource> sra = new PolyphaseSampleRateAdapter<2>(new FiniteSource<2>(v, 1000), 44100, 44100, q);
+
+		StereoSample bu[77];
+		int			 errors = 0;
+		uint		 total	= 0;
+		while (uint n = sra->getAudio(bu, NELEM(bu)))
+		{
+			for (uint i = 0; i < n; i++, total++) errors += bu[i] != StereoSample(v.l + total, v.r + total);
+			if (n < NELEM(bu)) break;
+		}
+		CHECK_EQ(errors, 0);
+		CHECK_GE(total, 1000 - q);
+		CHECK_LE(total, 1000);
+	}
+
+	// upsample 1:3 with linear interpolation:
+	RCPtr<StereoSource> sra = new PolyphaseSampleRateAdapter(
+		RCPtr<StereoSource>(new NumberProvider<2>(StereoSample(0, 300))), 10000, 30000, LinearInterpolation);
+	StereoSample bu[7];
+	sra->getAudio(bu, 7);
+	CHECK_EQ(bu[0], StereoSample(0, 300));
+	CHECK_EQ(bu[3], StereoSample(1, 301));
+	CHECK_EQ(bu[6], StereoSample(2, 302));
+	CHECK_EQ(bu[5].l, 2); // 1.667
+}
+
 TEST_CASE("Audio::HF_DC_Filter")
 {
 	// minimum test: instantiate
@@ -1566,6 +1566,95 @@ TEST_CASE("Audio::Ay38912 create files in dir")
 
 #endif // if 0
 
+
+#include "Audio/Ay38912.h"
+#include "YMFile.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Audio;
+
+// the Ay38912 without the batch path for fast channels:
+template<uint nc>
+struct ReferenceAy : public Ay38912_player<nc>
+{
+	ReferenceAy(float clock, AyStereoMix mix, int fps) : Ay38912_player<nc>(clock, mix, fps)
+	{
+		this->batch_fast_tones = false;
+	}
+};
+
+template<uint nc>
+static int max_difference(AudioSource<nc>* a, AudioSource<nc>* b, uint num_frames)
+{
+	AudioSample<nc> bu_a[num_frames], bu_b[num_frames];
+	a->getAudio(bu_a, num_frames);
+	b->getAudio(bu_b, num_frames);
+
+	int diff = 0;
+	for (uint i = 0; i < num_frames; i++)
+		for (uint c = 0; c < nc; c++) diff = max(diff, abs(bu_a[i].channels[c] - bu_b[i].channels[c]));
+	return diff;
+}
+
+TEST_CASE("Audio::Ay38912 fast tones")
+{
+	// tones with a period shorter than a sample are integrated per sample.
+	// the result must be the same as with the event loop:
+
+	hw_sample_frequency = 44100;
+
+	for (uint16 period = 1; period <= 8; period++)
+	{
+		RCPtr<Ay38912_player<2>> ay  = new Ay38912_player<2>(2000000, ABCstereo, 50);
+		RCPtr<ReferenceAy<2>>	 ref = new ReferenceAy<2>(2000000, ABCstereo, 50);
+
+		uint8 regs[14] = {0};
+		regs[0]		   = uint8(period);		 // A: fast
+		regs[2]		   = uint8(period + 1); // B: fast
+		regs[4]		   = 200;				 // C: slow
+		regs[6]		   = 3;					 // noise
+		regs[7]		   = 0b110000;			 // tone A+B+C, noise on A
+		regs[8]		   = 15;
+		regs[9]		   = 0x10; // envelope
+		regs[10]	   = 12;
+		regs[11]	   = 40;
+		regs[13]	   = 0b1110;
+
+		for (uint i = 0; i < 4; i++)
+		{
+			ay->setRegisters(regs);
+			ref->setRegisters(regs);
+		}
+		CHECK_LE(max_difference<2>(ay, ref, 3000), 1);
+	}
+}
+
+TEST_CASE("Audio::Ay38912 fast tones in \"Ninja Spirits #5.ym\"")
+{
+	// play the song with and without the batch path for fast channels:
+
+	hw_sample_frequency = 44100;
+
+	YMFile					 ym(YM_FILE);
+	RCPtr<Ay38912_player<1>> ay	 = new Ay38912_player<1>(float(ym.ay_clock), Mono, int(ym.frame_rate));
+	RCPtr<ReferenceAy<1>>	 ref = new ReferenceAy<1>(float(ym.ay_clock), Mono, int(ym.frame_rate));
+	REQUIRE(ym.num_frames > 100);
+
+	uint frames_per_ym_frame = uint(hw_sample_frequency) / ym.frame_rate;
+	int	 diff				 = 0;
+	for (uint32 i = 0; i < ym.num_frames; i++)
+	{
+		ay->setRegisters(ym.frame(i));
+		ref->setRegisters(ym.frame(i));
+		diff = max(diff, max_difference<1>(ay, ref, frames_per_ym_frame));
+	}
+	CHECK_LE(diff, 1);
+}
+
+} // namespace kio::Test
+
 /*
 
 
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/BufferedFile.h"
+#include "Devices/RamFile.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+
+static constexpr uint32 data_size = 5000;
+
+static uint8 byte_at(uint32 fpos) { return uint8(fpos * 13 + (fpos >> 8)); }
+
+static FilePtr make_file()
+{
+	FilePtr file = new RamFile<>;
+	for (uint32 i = 0; i < data_size; i++) file->putc(char(byte_at(i)));
+	file->setFpos(0);
+	return file;
+}
+
+
+TEST_CASE("BufferedFile: getc, peek and read")
+{
+	FilePtr				 file  = make_file();
+	RCPtr<BufferedFile> bfile = new BufferedFile(file, 64);
+	CHECK_EQ(bfile->getSize(), data_size);
+
+	int errors = 0;
+	for (uint32 i = 0; i < 1000; i++)
+	{
+		errors += bfile->peek() != byte_at(i);
+		errors += uint8(bfile->getc()) != byte_at(i);
+	}
+	CHECK_EQ(errors, 0);
+	CHECK_EQ(bfile->getFpos(), 1000);
+
+	// read_LE and read_BE across buffer boundaries:
+	for (uint32 i = 1000; i < 1100; i += 4)
+	{
+		uint32 n = uint32(byte_at(i)) + (uint32(byte_at(i + 1)) << 8) + (uint32(byte_at(i + 2)) << 16) +
+				   (uint32(byte_at(i + 3)) << 24);
+		errors += bfile->read_LE<uint32>() != n;
+	}
+	CHECK_EQ(errors, 0);
+	CHECK_EQ(bfile->read_BE<uint16>(), (byte_at(1100) << 8) + byte_at(1101));
+
+	// small and large blocks:
+	uint8  bu[1000];
+	uint32 fpos = 1102;
+	for (uint size : {10u, 63u, 64u, 65u, 200u, 1000u})
+	{
+		bfile->read(bu, size);
+		for (uint i = 0; i < size; i++) errors += bu[i] != byte_at(fpos + i);
+		fpos += size;
+		CHECK_EQ(bfile->getFpos(), fpos);
+	}
+	CHECK_EQ(errors, 0);
+	CHECK_EQ(uint8(bfile->getc()), byte_at(fpos));
+}
+
+TEST_CASE("BufferedFile: setFpos")
+{
+	FilePtr				 file  = make_file();
+	RCPtr<BufferedFile> bfile = new BufferedFile(file, 100);
+
+	// inside the buffer:
+	bfile->setFpos(10);
+	CHECK_EQ(uint8(bfile->getc()), byte_at(10));
+	bfile->setFpos(5);
+	CHECK_EQ(uint8(bfile->getc()), byte_at(5));
+	bfile->setFpos(100);
+	CHECK_EQ(uint8(bfile->getc()), byte_at(100));
+
+	// outside the buffer:
+	for (uint32 fpos : {4000u, 50u, 4998u, 1234u})
+	{
+		bfile->setFpos(fpos);
+		CHECK_EQ(bfile->getFpos(), fpos);
+		CHECK_EQ(uint8(bfile->getc()), byte_at(fpos));
+		CHECK_EQ(bfile->read<uint8>(), byte_at(fpos + 1));
+	}
+}
+
+TEST_CASE("BufferedFile: end of file")
+{
+	FilePtr				 file  = make_file();
+	RCPtr<BufferedFile> bfile = new BufferedFile(file);
+	uint8				 bu[100];
+
+	bfile->setFpos(data_size - 2);
+	CHECK_EQ(bfile->peek(), byte_at(data_size - 2));
+	CHECK_THROWS(bfile->read<uint32>());
+
+	bfile->setFpos(data_size - 2);
+	CHECK_EQ(bfile->read(bu, 100, true), 2);
+	CHECK_EQ(bfile->peek(), -1);
+	CHECK_EQ(bfile->read(bu, 100, true), 0); // sets eof_pending
+	CHECK_THROWS(bfile->read(bu, 100, true));
+	CHECK_THROWS(bfile->getc());
+
+	bfile->setFpos(data_size - 1);
+	CHECK_EQ(bfile->getc(0), byte_at(data_size - 1));
+	CHECK_EQ(bfile->getc(0), -1);
+	CHECK_THROWS(bfile->getc(0));
+
+	bfile->close();
+	CHECK_EQ(bfile->file, nullptr);
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
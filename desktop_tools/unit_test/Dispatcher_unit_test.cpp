@@ -0,0 +1,220 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "common/Dispatcher.h"
+#include "common/Xoshiro128.h"
+#include "doctest.h"
+#include "glue.h"
+#include <vector>
+
+
+namespace kio::Test
+{
+
+// the handlers log their data to `calls`:
+static std::vector<const void*> calls;
+
+static int log_once(void* data) noexcept
+{
+	calls.push_back(data);
+	return 0; // remove me
+}
+
+static const void* id(int i) { return reinterpret_cast<const void*>(uintptr_t(i)); }
+
+static void run_all()
+{
+	// run all handlers which are due:
+	for (uint n = 0; n < 100000; n++) Dispatcher::run();
+}
+
+
+TEST_CASE("Dispatcher: handlers are called in order of their time")
+{
+	calls.clear();
+	Xoshiro128		 rng(77);
+	std::vector<int> times;
+
+	// 100 handlers in the past, some with the same time:
+	CC start = now();
+	for (int i = 0; i < 100; i++)
+	{
+		int t = int(rng.random(50u)) * 100;
+		times.push_back(t);
+		Dispatcher::addAtTime(log_once, id(i), start - 100000 + t);
+	}
+
+	run_all();
+	REQUIRE_EQ(calls.size(), 100);
+
+	for (uint i = 1; i < calls.size(); i++)
+	{
+		int a = int(uintptr_t(calls[i - 1]));
+		int b = int(uintptr_t(calls[i]));
+		CHECK_LE(times[uint(a)], times[uint(b)]);
+		if (times[uint(a)] == times[uint(b)]) CHECK_LT(a, b); // same time: in order of addHandler()
+	}
+}
+
+TEST_CASE("Dispatcher: future handlers are not called")
+{
+	calls.clear();
+	Dispatcher::addWithDelay(log_once, id(1), 1000000);
+	Dispatcher::addHandler(log_once, id(2));
+	run_all();
+	CHECK_EQ(calls.size(), 1);
+	CHECK_EQ(calls[0], id(2));
+
+	Dispatcher::removeHandler(log_once, id(1));
+	Dispatcher::addWithDelay(log_once, id(3), -1);
+	run_all();
+	CHECK_EQ(calls.size(), 2);
+	CHECK_EQ(calls[1], id(3));
+}
+
+TEST_CASE("Dispatcher: removeHandler")
+{
+	calls.clear();
+	CC start = now() - 10000;
+	for (int i = 0; i < 50; i++) Dispatcher::addAtTime(log_once, id(i), start + i);
+	for (int i = 0; i < 50; i += 3) Dispatcher::removeHandler(log_once, id(i));
+	Dispatcher::removeHandler(log_once, id(999)); // not in list
+	run_all();
+
+	std::vector<const void*> expected;
+	for (int i = 0; i < 50; i++)
+		if (i % 3) expected.push_back(id(i));
+	CHECK(calls == expected);
+}
+
+TEST_CASE("Dispatcher: addIfNew")
+{
+	calls.clear();
+	Dispatcher::addIfNew(log_once, id(1));
+	Dispatcher::addIfNew(log_once, id(1));
+	Dispatcher::addIfNew(log_once, id(2));
+	run_all();
+	CHECK_EQ(calls.size(), 2);
+}
+
+static int count_drift_free = 0;
+static int drift_free(void*) noexcept
+{
+	count_drift_free++;
+	return -30000; // call again 30 ms after the last scheduled time
+}
+
+static int count_delayed = 0;
+static int delayed(void*) noexcept
+{
+	count_delayed++;
+	return 30000; // call again 30 ms after now
+}
+
+TEST_CASE("Dispatcher: reschedule")
+{
+	// scheduled at -100 ms: drift-free at -70, -40, -10 => 4 calls, then +20 ms
+	count_drift_free = 0;
+	Dispatcher::addAtTime(drift_free, nullptr, now() - 100000);
+	run_all();
+	CHECK_EQ(count_drift_free, 4);
+	Dispatcher::removeHandler(drift_free);
+
+	count_delayed = 0;
+	Dispatcher::addAtTime(delayed, nullptr, now() - 100000);
+	run_all();
+	CHECK_EQ(count_delayed, 1);
+	Dispatcher::removeHandler(delayed);
+	run_all();
+	CHECK_EQ(count_delayed, 1);
+}
+
+TEST_CASE("Dispatcher: many handlers")
+{
+	// the task list must grow beyond DISPATCHER_MAX_TASKS:
+	calls.clear();
+	Xoshiro128		 rng(1);
+	std::vector<int> times;
+	CC				 start = now() - 1000000;
+	for (int i = 0; i < 1000; i++)
+	{
+		times.push_back(int(rng.random(1000u)));
+		Dispatcher::addAtTime(log_once, id(i), start + times.back());
+	}
+	for (int i = 0; i < 1000; i += 2) Dispatcher::removeHandler(log_once, id(i));
+	Dispatcher::reserve(2000);
+	run_all();
+	REQUIRE_EQ(calls.size(), 500);
+
+	int errors = 0;
+	for (uint i = 1; i < calls.size(); i++)
+	{
+		uint a = uint(uintptr_t(calls[i - 1]));
+		uint b = uint(uintptr_t(calls[i]));
+		errors += (a & 1) == 0 || times[a] > times[b] || (times[a] == times[b] && a > b);
+	}
+	CHECK_EQ(errors, 0);
+}
+
+#if DISPATCHER_STATISTICS
+
+static void busy_wait(int usec)
+{
+	CC end = now() + usec;
+	while (now() < end) {}
+}
+
+static int count_slow = 0;
+static int slow(void*) noexcept
+{
+	// runs 2 ms but wants to be called every 1 ms:
+	busy_wait(2000);
+	return ++count_slow < 3 ? -1000 : 0;
+}
+
+struct Printer
+{
+	int	 lines = 0;
+	void printf(cstr, ...) { lines++; }
+};
+
+TEST_CASE("Dispatcher: statistics")
+{
+	Dispatcher::resetStatistics();
+	Dispatcher::Statistics s;
+	CHECK_FALSE(Dispatcher::getStatistics(0, s));
+
+	// late by 5 ms:
+	Dispatcher::addAtTime(slow, id(1), now() - 5000);
+	Dispatcher::addAtTime(log_once, id(2), now());
+	run_all();
+
+	REQUIRE(Dispatcher::getStatistics(0, s));
+	CHECK_EQ(s.handler, slow);
+	CHECK_EQ(s.data, id(1));
+	CHECK_EQ(s.num_calls, 3);
+	CHECK_EQ(s.num_overruns, 2); // the last call returned 0
+	CHECK_GE(s.max_latency, 5000);
+	CHECK_LE(s.min_latency, s.max_latency);
+	CHECK_GE(s.max_duration, 2000);
+	CHECK_GE(s.avg_duration(), 2000);
+	CHECK_EQ(s.jitter(), s.max_latency - s.min_latency);
+
+	REQUIRE(Dispatcher::getStatistics(1, s));
+	CHECK_EQ(s.handler, log_once);
+	CHECK_EQ(s.num_calls, 1);
+	CHECK_EQ(s.num_overruns, 0);
+	CHECK_FALSE(Dispatcher::getStatistics(2, s));
+
+	Printer printer;
+	Dispatcher::printStatistics(&printer);
+	CHECK_EQ(printer.lines, 3);
+
+	Dispatcher::resetStatistics();
+	CHECK_FALSE(Dispatcher::getStatistics(0, s));
+}
+
+#endif
+
+} // namespace kio::Test
@@ -0,0 +1,140 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/BlockDevice.h"
+#include "Devices/FileSystem.h"
+#include "Devices/internal/FatFile.h"
+#include "common/Array.h"
+#include "common/Xoshiro128.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+
+static constexpr uint32 disk_size = 4 MB;
+static constexpr uint32 chunk	  = 4 kB;
+
+class RamDisk : public BlockDevice
+{
+public:
+	Array<uint8> data {disk_size};
+	RamDisk() : BlockDevice(disk_size >> 9, 9, 9, 0, readwrite | overwritable) {}
+
+	virtual void readSectors(LBA lba, void* bu, SIZE count) override
+	{
+		memcpy(bu, &data[lba << 9], count << 9);
+	}
+	virtual void writeSectors(LBA lba, const void* bu, SIZE count) override
+	{
+		if (bu) memcpy(&data[lba << 9], bu, count << 9);
+		else memset(&data[lba << 9], 0xff, count << 9);
+	}
+};
+
+static uint8 byte_at(uint32 fpos) { return uint8(fpos * 7 + (fpos >> 9)); }
+
+static void write_fragmented_files(FileSystem* fs, uint32 size)
+{
+	// write 2 files interleaved so that their clusters are fragmented:
+
+	FilePtr a = fs->openFile("/a.bin", WRITE);
+	FilePtr b = fs->openFile("/b.bin", WRITE);
+	uint8	bu[chunk];
+	for (uint32 fpos = 0; fpos < size; fpos += chunk)
+	{
+		for (uint i = 0; i < chunk; i++) bu[i] = byte_at(fpos + i);
+		a->write(bu, chunk);
+		b->write(bu, chunk);
+	}
+	a->close();
+	b->close();
+}
+
+
+TEST_CASE("FatFile: fast seek")
+{
+	static constexpr uint32 fsize = 1 MB;
+
+	RCPtr<RamDisk> disk = new RamDisk;
+	makeFS(disk, "FAT");
+	FileSystemPtr fs = mount("test", disk);
+	write_fragmented_files(fs, fsize);
+
+	RCPtr<FatFile> file = static_cast<FatFile*>(fs->openFile("/a.bin", READ).ptr());
+	CHECK_FALSE(file->isFastSeekEnabled());
+	uint n = file->enableFastSeek();
+	CHECK(file->isFastSeekEnabled());
+	CHECK_GT(n, 4);	// fragmented
+	CHECK_EQ(n % 2, 0); // 2 entries per fragment + size + terminator
+
+	Xoshiro128 rng(42);
+	int		   errors = 0;
+	for (uint i = 0; i < 1000; i++)
+	{
+		uint32 fpos = rng.random(fsize - 100);
+		uint8  bu[100];
+		file->setFpos(fpos);
+		file->read(bu, 100);
+		for (uint j = 0; j < 100; j++) errors += bu[j] != byte_at(fpos + j);
+	}
+	CHECK_EQ(errors, 0);
+
+	// caller supplied buffer:
+	uint32 table[600];
+	CHECK_THROWS(file->enableFastSeek(table, 4));
+	CHECK_FALSE(file->isFastSeekEnabled());
+	CHECK_EQ(file->enableFastSeek(table, 600), n);
+	file->setFpos(fsize - 1);
+	CHECK_EQ(uint8(file->getc()), byte_at(fsize - 1));
+	file->close();
+
+	// fast seek is disabled when the file is expanded:
+	file = static_cast<FatFile*>(fs->openFile("/b.bin", READWRITE).ptr());
+	file->enableFastSeek();
+	file->setFpos(1000);
+	file->putc(char(byte_at(1000)));
+	CHECK(file->isFastSeekEnabled());
+	file->setFpos(fsize);
+	file->write("xyz", 3);
+	CHECK_FALSE(file->isFastSeekEnabled());
+	CHECK_EQ(file->getSize(), fsize + 3);
+	file->close();
+
+	file = nullptr;
+	fs	 = nullptr;
+	unmountAll();
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,229 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/RamFile.h"
+#include "Graphics/Pixmap.h"
+#include "Graphics/gif/GifDecoder.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+using namespace kio::Graphics;
+
+static constexpr int gif_width	= 37;
+static constexpr int gif_height = 23;
+
+static uint8 pixel_at(int x, int y, uint num_colors) { return uint8((x * 7 + y * 13 + (x * y >> 3)) % num_colors); }
+
+static Color global_color(uint i) { return Color::fromRGB8(int(i * 16), int(i * 5), 255 - int(i * 16)); }
+
+struct GifOptions
+{
+	uint8 cmap_bits	  = 4;
+	bool  local_cmap  = false; // local cmap with the global colors in reverse order
+	bool  interlaced  = false;
+	int	  transparent = -1;
+};
+
+static void put_cmap(FilePtr file, uint bits, bool reversed)
+{
+	for (uint i = 0; i < 1u << bits; i++)
+	{
+		uint  c		= reversed ? (1u << bits) - 1 - i : i;
+		uint8 rgb[] = {uint8(c * 16), uint8(c * 5), uint8(255 - c * 16)};
+		file->write(rgb, 3);
+	}
+}
+
+static FilePtr make_gif(const GifOptions& o)
+{
+	// the LZW data consists of 9-bit literal codes only.
+	// a clear code every 250 codes keeps the code size at 9 bits.
+
+	FilePtr file = new RamFile<>;
+	file->write("GIF89a", 6);
+	file->write_LE<uint16>(gif_width);
+	file->write_LE<uint16>(gif_height);
+	file->putc(char(0x80 | (o.cmap_bits - 1) << 4 | (o.cmap_bits - 1)));
+	file->putc(0); // background color
+	file->putc(0); // aspect
+	put_cmap(file, o.cmap_bits, false);
+
+	if (o.transparent >= 0)
+	{
+		uint8 gce[] = {'!', 0xf9, 4, 1, 0, 0, uint8(o.transparent), 0};
+		file->write(gce, sizeof(gce));
+	}
+
+	file->putc(',');
+	file->write_LE<uint16>(0);
+	file->write_LE<uint16>(0);
+	file->write_LE<uint16>(gif_width);
+	file->write_LE<uint16>(gif_height);
+	file->putc(char((o.local_cmap ? 0x80 | (o.cmap_bits - 1) : 0) | (o.interlaced ? 0x40 : 0)));
+	if (o.local_cmap) put_cmap(file, o.cmap_bits, true);
+	file->putc(8); // lzw min code size
+
+	uint   num_colors = 1u << o.cmap_bits;
+	uint8  block[256];
+	uint   blocksize = 0;
+	uint32 accu		 = 0;
+	uint   bits		 = 0;
+	uint   count	 = 0;
+
+	auto put_byte = [&](uint8 byte) {
+		block[++blocksize] = byte;
+		if (blocksize < 255) return;
+		block[0] = uint8(blocksize);
+		file->write(block, blocksize + 1);
+		blocksize = 0;
+	};
+	auto put_code = [&](uint code) {
+		accu |= code << bits;
+		for (bits += 9; bits >= 8; bits -= 8)
+		{
+			put_byte(uint8(accu));
+			accu >>= 8;
+		}
+	};
+
+	static constexpr int y0[4] = {0, 4, 2, 1};
+	static constexpr int dy[4] = {8, 8, 4, 2};
+	for (int i = o.interlaced ? 0 : 3; i < 4; i++)
+	{
+		for (int y = o.interlaced ? y0[i] : 0; y < gif_height; y += o.interlaced ? dy[i] : 1)
+		{
+			for (int x = 0; x < gif_width; x++)
+			{
+				if (count++ % 250 == 0) put_code(256);
+				uint8 pixel = pixel_at(x, y, num_colors);
+				put_code(o.local_cmap ? num_colors - 1 - pixel : pixel);
+			}
+		}
+	}
+	put_code(257);
+	if (bits) put_byte(uint8(accu));
+	if (blocksize)
+	{
+		block[0] = uint8(blocksize);
+		file->write(block, blocksize + 1);
+	}
+	file->putc(0); // end of data
+	file->putc(';');
+	file->setFpos(0);
+	return file;
+}
+
+template<ColorMode CM>
+static void compare_decoders(const GifOptions& o, int x0, int y0, int mode)
+{
+	// decode the gif into 2 pixmaps: with the Canvas and with the Pixmap version
+	// mode 0 = true color, 1 = indexed with cmap, 2 = indexed with transparent color
+
+	RCPtr<Pixmap<CM>> pm1 = new Pixmap<CM>(40, 30);
+	RCPtr<Pixmap<CM>> pm2 = new Pixmap<CM>(40, 30);
+	pm1->fillRect(0, 0, 40, 30, 3);
+	pm2->fillRect(0, 0, 40, 30, 3);
+
+	Color cmap1[256] = {}, cmap2[256] = {};
+	int	  transp1 = -2, transp2 = -2;
+
+	GifDecoder gif1(make_gif(o));
+	GifDecoder gif2(make_gif(o));
+	Canvas&	   canvas = *pm1;
+	if (mode == 0) gif1.decode_image(canvas, x0, y0), gif2.decode_image(*pm2, x0, y0);
+	if (mode == 1) gif1.decode_image(canvas, cmap1, x0, y0), gif2.decode_image(*pm2, cmap2, x0, y0);
+	if (mode == 2) gif1.decode_image(canvas, cmap1, &transp1, x0, y0), gif2.decode_image(*pm2, cmap2, &transp2, x0, y0);
+
+	CHECK(*pm1 == *pm2);
+	CHECK(memcmp(cmap1, cmap2, sizeof(cmap1)) == 0);
+	CHECK_EQ(transp1, transp2);
+}
+
+TEST_CASE("GifDecoder: decode into Pixmap_i8")
+{
+	for (bool interlaced : {false, true})
+	{
+		GifOptions o;
+		o.cmap_bits	 = 8;
+		o.interlaced = interlaced;
+
+		RCPtr<Pixmap_i8> pm = new Pixmap_i8(gif_width, gif_height);
+		Color			 cmap[256];
+		GifDecoder		 gif(make_gif(o));
+		REQUIRE(gif.isa_gif_file);
+		gif.decode_image(*pm, cmap);
+
+		int errors = 0;
+		for (int y = 0; y < gif_height; y++)
+			for (int x = 0; x < gif_width; x++) errors += pm->get_ink(x, y) != pixel_at(x, y, 256);
+		CHECK_EQ(errors, 0);
+		CHECK(cmap[7] == global_color(7));
+	}
+}
+
+TEST_CASE("GifDecoder: Pixmap versions == Canvas versions")
+{
+	for (int mode = 0; mode < 3; mode++)
+	{
+		for (int variant = 0; variant < 8; variant++)
+		{
+			GifOptions o;
+			o.local_cmap  = variant & 1;
+			o.interlaced  = variant & 2;
+			o.transparent = variant & 4 ? 5 : -1;
+
+			compare_decoders<colormode_i4>(o, 0, 0, mode);
+			compare_decoders<colormode_i4>(o, -3, 10, mode);
+			compare_decoders<colormode_i8>(o, 0, 0, mode);
+			compare_decoders<colormode_i8>(o, 5, -4, mode);
+			compare_decoders<colormode_rgb>(o, 0, 0, mode);
+			compare_decoders<colormode_rgb>(o, -3, 10, mode);
+		}
+	}
+
+	GifOptions o;
+	o.cmap_bits = 1;
+	compare_decoders<colormode_i1>(o, 1, 1, 1);
+	o.cmap_bits = 2;
+	compare_decoders<colormode_i2>(o, 1, 1, 1);
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,133 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/HeatShrinkDecoder.h"
+#include "Devices/HeatShrinkEncoder.h"
+#include "Devices/RamFile.h"
+#include "common/Xoshiro128.h"
+#include "doctest.h"
+#include <memory>
+
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+
+// a File which counts the bytes read from it:
+class CountingFile final : public File
+{
+public:
+	FilePtr file;
+	uint32	count = 0;
+
+	CountingFile(FilePtr file) : File(readable), file(file) {}
+
+	virtual SIZE read(void* data, SIZE size, bool partial = false) override
+	{
+		size = file->read(data, size, partial);
+		count += size;
+		return size;
+	}
+	virtual ADDR getSize() const noexcept override { return file->getSize(); }
+	virtual ADDR getFpos() const noexcept override { return file->getFpos(); }
+	virtual void setFpos(ADDR a) override { file->setFpos(a); }
+	virtual void close() override {}
+};
+
+static constexpr uint32 data_size = 100000;
+
+static std::unique_ptr<uint8[]> make_data()
+{
+	// some compressible data:
+	std::unique_ptr<uint8[]> data {new uint8[data_size]};
+	Xoshiro128				 rng(4711);
+	for (uint32 i = 0; i < data_size; i++) data[i] = uint8(rng.next() % 8 + (i >> 10));
+	return data;
+}
+
+static FilePtr encode(const uint8* data, uint32 block_size, uint32 chunk_size)
+{
+	FilePtr					 file  = new RamFile<>;
+	RCPtr<HeatShrinkEncoder> cfile = new HeatShrinkEncoder(file, 10, 5, true, block_size);
+	for (uint32 i = 0; i < data_size; i += chunk_size) cfile->write(data + i, std::min(chunk_size, data_size - i));
+	cfile->finish();
+	file->setFpos(0);
+	return file;
+}
+
+TEST_CASE("HeatShrink: encode & decode")
+{
+	auto data = make_data();
+
+	for (uint32 block_size : {0u, 1024u, 4096u, 10000u, 200000u})
+	{
+		FilePtr file = encode(data.get(), block_size, 777);
+		CHECK(isHeatShrinkEncoded(file));
+
+		RCPtr<HeatShrinkDecoder> dfile = new HeatShrinkDecoder(file);
+		CHECK_EQ(dfile->getSize(), data_size);
+		CHECK_EQ(dfile->block_size, block_size);
+
+		std::unique_ptr<uint8[]> bu {new uint8[data_size]};
+		dfile->read(bu.get(), data_size);
+		CHECK(memcmp(bu.get(), data.get(), data_size) == 0);
+	}
+}
+
+TEST_CASE("HeatShrink: block boundary at end of write")
+{
+	// writes which end exactly on a block boundary must not create an empty block:
+	auto data = make_data();
+
+	constexpr uint32		 block_size = 1024;
+	constexpr uint32		 size		= data_size / block_size * block_size;
+	FilePtr					 file		= new RamFile<>;
+	RCPtr<HeatShrinkEncoder> cfile		= new HeatShrinkEncoder(file, 10, 5, true, block_size);
+	for (uint32 i = 0; i < size; i += block_size) cfile->write(data.get() + i, block_size);
+	cfile->finish();
+	file->setFpos(0);
+
+	RCPtr<HeatShrinkDecoder> dfile = new HeatShrinkDecoder(file);
+	CHECK_EQ(dfile->getSize(), size);
+	CHECK_EQ(dfile->table + size / block_size * 4, dfile->csize);
+
+	std::unique_ptr<uint8[]> bu {new uint8[size]};
+	dfile->read(bu.get(), size);
+	CHECK(memcmp(bu.get(), data.get(), size) == 0);
+}
+
+TEST_CASE("HeatShrink: setFpos")
+{
+	auto data = make_data();
+
+	for (uint32 block_size : {0u, 4096u})
+	{
+		FilePtr					 file  = encode(data.get(), block_size, 5000);
+		RCPtr<CountingFile>		 cfile = new CountingFile(file);
+		RCPtr<HeatShrinkDecoder> dfile = new HeatShrinkDecoder(cfile);
+
+		Xoshiro128 rng(1234);
+		uint32	   max_count = 0;
+		for (int i = 0; i < 200; i++)
+		{
+			uint32 pos = rng.next() % data_size;
+			uint32 n   = std::min(rng.next() % 100 + 1, data_size - pos);
+			uint8  bu[100];
+
+			cfile->count = 0;
+			dfile->setFpos(pos);
+			dfile->read(bu, n);
+			max_count = std::max(max_count, cfile->count);
+
+			CHECK_EQ(dfile->getFpos(), pos + n);
+			CHECK(memcmp(bu, data.get() + pos, n) == 0);
+		}
+
+		// with checkpoints the decoder reads at most about one block:
+		if (block_size) CHECK_LT(max_count, dfile->table / (data_size / block_size) * 2 + 200);
+		else CHECK_GT(max_count, dfile->csize / 2);
+	}
+}
+
+} // namespace kio::Test
@@ -27,7 +27,11 @@ extern void flash_range_erase(uint32 addr, uint32 size)
 	LOG("erase 0x%08x + 0x%08x -> 0x%08x", addr, size, addr + size);
 
 	if (addr & emask || size & emask || addr + size > qspi->data.count()) qspi->error = 1;
-	else memset(&qspi->data[addr], 0xff, size);
+	else
+	{
+		memset(&qspi->data[addr], 0xff, size);
+		for (uint32 a = addr; a < addr + size; a += esize) qspi->erase_counts[a >> sse]++;
+	}
 }
 
 extern void flash_range_program(uint32 addr, const uint8* data, uint32 size)
@@ -53,7 +57,9 @@ extern void flash_range_program(uint32 addr, const uint8* data, uint32 size)
 MockFlash::MockFlash(Array<uint8>& data, Array<cstr>& log, bool& error) : //
 	data(data),
 	log(log),
-	error(error)
+	error(error),
+	erase_counts(data.count() >> sse),
+	prev(qspi)
 {
 	assert((data.count() & emask) == 0);
 
@@ -64,7 +70,7 @@ MockFlash::MockFlash(Array<uint8>& data, Array<cstr>& log, bool& error) : //
 
 MockFlash::~MockFlash()
 {
-	if (qspi == this) qspi = nullptr;
+	if (qspi == this) qspi = prev;
 }
 
 } // namespace kio
@@ -21,6 +21,10 @@ public:
 	Array<uint8>& data;
 	Array<cstr>&  log;
 	bool&		  error;
+	Array<uint32> erase_counts; // per erase block
+	MockFlash*	  prev;			// restored in dtor
+
+	uint32 eraseCount(uint32 addr) const noexcept { return erase_counts[addr >> 12]; }
 };
 
 } // namespace kio
@@ -0,0 +1,354 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "MockSDCard.h"
+#include "Devices/internal/CSD.h"
+#include "Devices/internal/crc.h"
+#include "glue.h"
+
+using namespace kio;
+using namespace kio::Devices;
+
+
+// ==================================================
+//			GPIO, SPI and DMA
+// ==================================================
+
+static MockSDCard* sdcard = nullptr;
+
+static spi_inst	 spi_inst0, spi_inst1;
+spi_inst* const spi0 = &spi_inst0;
+spi_inst* const spi1 = &spi_inst1;
+
+extern void gpio_put(uint, bool value)
+{
+	// the only gpio pin used is the SDCard's CSn:
+	if (sdcard) sdcard->select(!value);
+}
+
+extern int spi_read_blocking(spi_inst*, uint8 repeated_tx_data, uint8* dst, size_t len)
+{
+	assert(sdcard);
+	for (size_t i = 0; i < len; i++) dst[i] = sdcard->exchange(repeated_tx_data);
+	return int(len);
+}
+
+extern int spi_write_blocking(spi_inst*, const uint8* src, size_t len)
+{
+	assert(sdcard);
+	for (size_t i = 0; i < len; i++) sdcard->exchange(src[i]);
+	return int(len);
+}
+
+extern int spi_write_read_blocking(spi_inst*, const uint8* src, uint8* dst, size_t len)
+{
+	assert(sdcard);
+	for (size_t i = 0; i < len; i++) dst[i] = sdcard->exchange(src[i]);
+	return int(len);
+}
+
+struct DmaChannel
+{
+	bool				  claimed	 = false;
+	bool				  busy		 = false;
+	dma_channel_config	  config	 = {};
+	volatile uint8*		  write_addr = nullptr;
+	const volatile uint8* read_addr	 = nullptr;
+	uint				  count		 = 0;
+};
+
+static constexpr uint num_dma_channels = 12;
+static DmaChannel	  dma_channels[num_dma_channels];
+
+extern int dma_claim_unused_channel(bool required)
+{
+	for (uint i = 0; i < num_dma_channels; i++)
+	{
+		if (dma_channels[i].claimed) continue;
+		dma_channels[i].claimed = true;
+		return int(i);
+	}
+	if (required) throw "no free dma channel";
+	return -1;
+}
+
+extern void dma_channel_unclaim(uint channel)
+{
+	assert(channel < num_dma_channels);
+	dma_channels[channel] = DmaChannel();
+}
+
+extern void dma_channel_configure(
+	uint channel, const dma_channel_config* config, volatile void* write_addr, const volatile void* read_addr,
+	uint count, bool trigger)
+{
+	assert(channel < num_dma_channels && dma_channels[channel].claimed);
+	assert(config->size == DMA_SIZE_8);
+
+	DmaChannel& c = dma_channels[channel];
+	c.config	  = *config;
+	c.write_addr  = reinterpret_cast<volatile uint8*>(write_addr);
+	c.read_addr	  = reinterpret_cast<const volatile uint8*>(read_addr);
+	c.count		  = count;
+	c.busy		  = trigger && count;
+}
+
+extern void dma_start_channel_mask(uint32 mask)
+{
+	for (uint i = 0; i < num_dma_channels; i++)
+		if (mask & (1u << i)) dma_channels[i].busy = dma_channels[i].count != 0;
+	if (sdcard) sdcard->num_dma_starts++;
+}
+
+extern bool dma_channel_is_busy(uint channel)
+{
+	assert(channel < num_dma_channels);
+	if (!dma_channels[channel].busy) return false;
+
+	assert(sdcard);
+	sdcard->num_dma_polls++;
+	sdcard->dma_step();
+	return true;
+}
+
+extern void dma_channel_abort(uint channel)
+{
+	assert(channel < num_dma_channels);
+	dma_channels[channel].busy = false;
+}
+
+
+// ==================================================
+//			Simulated SD Card
+// ==================================================
+
+namespace kio
+{
+
+static constexpr uint8 DataToken  = 0xfe;
+static constexpr uint8 RangeError = 0x08;
+
+MockSDCard::MockSDCard(Array<uint8>& data) : //
+	data(data),
+	prev(sdcard)
+{
+	assert(data.count() % (512 kB) == 0);
+	sdcard = this;
+}
+
+MockSDCard::~MockSDCard()
+{
+	if (sdcard == this) sdcard = prev;
+}
+
+void MockSDCard::dma_step() noexcept
+{
+	// transfer the next bytes of the running DMA:
+	// the tx channel feeds the spi, the rx channel receives from the spi.
+
+	const uint tx_dreq = spi_get_dreq(spi0, true);
+	const uint rx_dreq = spi_get_dreq(spi0, false);
+
+	DmaChannel* tx = nullptr;
+	DmaChannel* rx = nullptr;
+	for (uint i = 0; i < num_dma_channels; i++)
+	{
+		DmaChannel& c = dma_channels[i];
+		if (c.busy && c.config.dreq == tx_dreq) tx = &c;
+		if (c.busy && c.config.dreq == rx_dreq) rx = &c;
+	}
+
+	for (uint n = 0; n < dma_bytes_per_poll && tx && tx->count; n++)
+	{
+		uint8 byte = exchange(*tx->read_addr);
+		if (tx->config.read_increment) tx->read_addr++;
+		if (--tx->count == 0) tx->busy = false;
+
+		if (!rx || !rx->count) continue;
+		*rx->write_addr = byte;
+		if (rx->config.write_increment) rx->write_addr++;
+		if (--rx->count == 0) rx->busy = false;
+	}
+}
+
+void MockSDCard::select(bool f) noexcept
+{
+	selected = f;
+	if (f) return;
+
+	// a response is not continued after deselect:
+	out.purge();
+	out_pos = 0;
+	cmd_len = 0;
+}
+
+uint8 MockSDCard::exchange(uint8 byte) noexcept
+{
+	if (!selected) return 0xff;
+
+	if (out_pos == out.count() && stream >= 0)
+	{
+		out.purge();
+		out_pos = 0;
+		send_block(uint32(stream++));
+	}
+
+	uint8 rval = 0xff;
+	if (out_pos < out.count()) rval = out[out_pos++];
+
+	if (cmd_len || (byte & 0xc0) == 0x40)
+	{
+		cmd[cmd_len++] = byte;
+		if (cmd_len == 6)
+		{
+			cmd_len = 0;
+			execute();
+		}
+	}
+
+	return rval;
+}
+
+void MockSDCard::send_data(const uint8* q, uint count, bool bad_crc) noexcept
+{
+	for (uint i = 0; i < token_delay; i++) send(0xff);
+	send(DataToken);
+	out.append(q, count);
+	uint crc = crc16(q, count) ^ bad_crc;
+	send(uint8(crc >> 8));
+	send(uint8(crc));
+}
+
+void MockSDCard::send_block(uint32 blkidx) noexcept
+{
+	if (blkidx >= data.count() / 512)
+	{
+		send(RangeError);
+		stream = -1;
+		return;
+	}
+
+	bool bad_crc = int32(blkidx) == bad_crc_block && bad_crc_count;
+	if (bad_crc) bad_crc_count--;
+	send_data(&data[blkidx * 512], 512, bad_crc);
+	num_blocks++;
+}
+
+void MockSDCard::execute() noexcept
+{
+	uint   n	= cmd[0] & 0x3f;
+	uint32 arg	= peek_u32(cmd + 1);
+	bool   acmd = app_cmd;
+	app_cmd		= false;
+
+	out.purge();
+	out_pos = 0;
+	if (n != 12) stream = -1;
+
+	if (acmd && n == 41)
+	{
+		if (++acmd41 > 2) idle = false;
+		return send(idle);
+	}
+	if (acmd && n == 51) // SCR
+	{
+		uint8 scr[8] = {0x02, 0xb5, 0x80, 0, 0, 0, 0, 0}; // data_stat_after_erase = 1
+		send(0);
+		return send_data(scr, 8);
+	}
+
+	switch (n)
+	{
+	case 0: // GO_IDLE_STATE
+		idle   = true;
+		acmd41 = 0;
+		return send(idle);
+	case 8: // SEND_IF_COND
+		send(idle);
+		send(0), send(0), send(cmd[3]), send(cmd[4]);
+		return;
+	case 9: // SEND_CSD
+	{
+		CSD csd;
+		csd.set(127, 126, 1);						  // CSD version 2
+		csd.set(83, 80, 9);							  // read_bl_len
+		csd.set(25, 22, 9);							  // write_bl_len
+		csd.set(46, 46, 1);							  // erase_blk_en
+		csd.set(63, 48, data.count() / (512 kB) - 1); // c_size
+		uint8 bu[16];
+		for (uint i = 0; i < 4; i++) poke_u32(bu + 4 * i, csd.data[i]);
+		bu[15] = uint8(crc7(bu, 15));
+		send(0);
+		return send_data(bu, 16);
+	}
+	case 10: // SEND_CID
+	{
+		uint8 bu[16] = {0x03, 'S', 'D', 'M', 'O', 'C', 'K', '!', 0x10, 0x12, 0x34, 0x56, 0x78, 0x01, 0x93};
+		bu[15]		 = uint8(crc7(bu, 15));
+		send(0);
+		return send_data(bu, 16);
+	}
+	case 12: // STOP_TRANSMISSION
+		stream = -1;
+		send(0xff); // stuff byte
+		return send(0);
+	case 13: // SEND_STATUS
+		send(0);
+		return send(0);
+	case 16: // SET_BLOCKLEN
+		return send(arg == 512 ? 0 : 0x40);
+	case 17: // READ_SINGLE_BLOCK
+		if (arg >= data.count() / 512) return send(0x20);
+		send(0);
+		return send_block(arg);
+	case 18: // READ_MULTIPLE_BLOCK
+		if (arg >= data.count() / 512) return send(0x20);
+		num_cmd18++;
+		stream = int32(arg);
+		return send(0);
+	case 55: // APP_CMD
+		app_cmd = true;
+		return send(idle);
+	case 58: // READ_OCR
+		send(idle);
+		send(idle ? 0x80 : 0xC0), send(0xff), send(0x80), send(0x00);
+		return;
+	case 59: // CRC_ON_OFF
+		return send(idle);
+	default: //
+		return send(idle | 0x04); // IllegalCommand
+	}
+}
+
+} // namespace kio
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,90 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "Array.h"
+#include "standard_types.h"
+
+namespace kio
+{
+
+/*
+	Simulated SDHC card on the SPI bus for the SDCard unit test.
+	Implements the gpio_put(), spi_*() and dma_*() functions declared in glue.h.
+	The card supports the commands needed for connect() and CMD17 and CMD18 for reading.
+	DMA transfers proceed by 'dma_bytes_per_poll' bytes with each call to dma_channel_is_busy().
+*/
+class MockSDCard
+{
+public:
+	MockSDCard(Array<uint8>& data);
+	~MockSDCard();
+
+	Array<uint8>& data; // disk image
+
+	// settings:
+	uint  token_delay		 = 2;  // 0xff bytes before each data token
+	uint  dma_bytes_per_poll = 64; // progress of DMA per call to dma_channel_is_busy()
+	int32 bad_crc_block		 = -1; // send wrong CRC for this block
+	uint  bad_crc_count		 = 0;  // .. this many times
+
+	// statistics:
+	uint num_cmd18		= 0;
+	uint num_blocks		= 0; // data blocks sent
+	uint num_dma_polls	= 0; // calls to dma_channel_is_busy() which returned true
+	uint num_dma_starts = 0;
+
+	uint8 exchange(uint8 byte) noexcept;
+	void  select(bool f) noexcept;
+	void  dma_step() noexcept;
+
+private:
+	bool		 selected = false;
+	bool		 idle	  = true;
+	bool		 app_cmd  = false;
+	uint		 acmd41	  = 0;	// count ACMD41 while initializing
+	int32		 stream	  = -1; // next block for CMD18 or -1
+	uint8		 cmd[6];		// received command bytes
+	uint		 cmd_len = 0;	//
+	Array<uint8> out;			// bytes to send
+	uint		 out_pos = 0;	//
+	MockSDCard*	 prev;			// restored in dtor
+
+	void execute() noexcept;
+	void send(uint8 byte) noexcept { out.append(byte); }
+	void send_data(const uint8* data, uint count, bool bad_crc = false) noexcept;
+	void send_block(uint32 blkidx) noexcept;
+};
+
+} // namespace kio
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
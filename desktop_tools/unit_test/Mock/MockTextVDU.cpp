@@ -281,6 +281,12 @@ void TextVDU::printChar(char c, int count) noexcept
 	return super::printChar(c, count);
 }
 
+void TextVDU::printRun(cptr s, int count) noexcept
+{
+	LOG("%s(\"%.*s\",%i)", __func__, count, s, count);
+	return super::printRun(s, count);
+}
+
 void TextVDU::print(cstr s) noexcept
 {
 	LOG("%s(%s)", __func__, s);
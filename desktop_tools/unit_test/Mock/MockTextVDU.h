@@ -50,6 +50,7 @@ public:
 	void removeCharAttributes(uint a = 0xff) noexcept { setCharAttributes(0, a); }
 	void printCharMatrix(CharMatrix, int count = 1) noexcept;
 	void printChar(char c, int count = 1) noexcept;				// no ctl
+	void printRun(cptr text, int count) noexcept;				// no ctl, fast
 	void print(cstr text) noexcept;								// supports \n and \t
 	void printf(cstr fmt, ...) noexcept __printflike(2, 3);		// supports \n and \t
 	void printf(cstr fmt, va_list) noexcept __printflike(2, 0); // supports \n and \t
@@ -0,0 +1,71 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#pragma once
+#include "Devices/LzhDecoder.h"
+#include "Devices/StdFile.h"
+#include "common/Array.h"
+#include <cstring>
+
+namespace kio::Test
+{
+
+/*	Minimal .ym file reader for tests and benchmarks which need real AY register data.
+	Reads YM3, YM3b, YM5 and YM6 files without digidrums, Lzh compressed or not.
+	registers[] holds 16 registers per frame, not interleaved.
+	For the full blown reader see rsrc_writer/YMMFileConverter.cpp.
+*/
+struct YMFile
+{
+	uint32		 num_frames = 0;
+	uint32		 ay_clock	= 2000000; // Atari ST chip clock
+	uint		 frame_rate = 50;
+	Array<uint8> registers;
+
+	YMFile(cstr fpath)
+	{
+		using namespace Devices;
+
+		FilePtr file = new StdFile(fpath);
+		if (isLzhEncoded(file)) file = new LzhDecoder(file);
+		uint32 usize = uint32(file->getSize());
+
+		char magic[8];
+		file->read(magic, 4);
+		uint frame_size	 = 14;
+		bool interleaved = true;
+
+		if (memcmp(magic, "YM3!", 4) == 0) num_frames = (usize - 4) / 14;
+		else if (memcmp(magic, "YM3b", 4) == 0) num_frames = (usize - 8) / 14;
+		else if (memcmp(magic, "YM5!", 4) == 0 || memcmp(magic, "YM6!", 4) == 0)
+		{
+			file->read(magic, 8);
+			if (memcmp(magic, "LeOnArD!", 8) != 0) throw "not a valid YM5/YM6 file";
+			num_frames	= file->read_BE<uint32>();
+			interleaved = !(file->read_BE<uint32>() & 1);
+			if (file->read_BE<uint16>()) throw "DigiDrums not supported";
+			ay_clock   = file->read_BE<uint32>();
+			frame_rate = file->read_BE<uint16>();
+			file->read_BE<uint32>(); // loop frame
+			uint skip = file->read_BE<uint16>(); // additional data
+			file->setFpos(file->getFpos() + skip);
+			for (uint i = 0; i < 3; i++) file->gets(1 << 0); // title, author, comment
+			frame_size = 16;
+		}
+		else throw "not a supported YM music file";
+
+		Array<uint8> data {num_frames * frame_size};
+		file->read(&data[0], num_frames * frame_size);
+
+		registers = Array<uint8> {num_frames * 16};
+		memset(&registers[0], 0xff, num_frames * 16);
+		for (uint32 f = 0; f < num_frames; f++)
+			for (uint r = 0; r < frame_size; r++)
+				registers[f * 16 + r] = interleaved ? data[r * num_frames + f] : data[f * frame_size + r];
+	}
+
+	const uint8* frame(uint32 i) const noexcept { return &registers[i * 16]; }
+};
+
+} // namespace kio::Test
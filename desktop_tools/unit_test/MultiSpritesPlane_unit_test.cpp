@@ -0,0 +1,136 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "MultiSpritesPlane.h"
+#include "Pixmap.h"
+#include "doctest.h"
+#include <memory>
+
+namespace kio::Video
+{
+VgaMode		  vga_mode	 = vga_mode_640x480_60; // normally in VideoBackend.cpp
+volatile bool locked_out = false;				// normally in Video.cpp
+} // namespace kio::Video
+
+using namespace kio::Graphics;
+using namespace kio::Video;
+using namespace kio;
+
+using SpritesPlane = MultiSpritesPlane<Sprite<Shape>, NoZ>;
+
+
+static Shape make_shape(int width, int height, uint color)
+{
+	Pixmap<colormode_rgb> pm(width, height);
+	pm.clear(color);
+	return Shape(pm, -1, Dist(0, 0), nullptr);
+}
+
+static uint count_pixels(SpritesPlane* plane, int row, uint color)
+{
+	uint32 scanline[640 * sizeof(Color) / sizeof(uint32)] = {0};
+	plane->renderScanline(row, 640, scanline);
+	const Color* colors = reinterpret_cast<const Color*>(scanline);
+
+	uint n = 0;
+	for (int x = 0; x < 640; x++) n += colors[x] == Color(color);
+	return n;
+}
+
+
+TEST_CASE("MultiSpritesPlane: sprite bucket index")
+{
+	Shape				shape = make_shape(8, 20, 0x123);
+	RCPtr<SpritesPlane> plane = new SpritesPlane;
+
+	auto* a = plane->add(new Sprite<Shape>(shape, Point(0, 10))); // rows 10 .. 29 => bands 0 and 1
+	auto* b = plane->add(new Sprite<Shape>(shape, Point(0, 40))); // rows 40 .. 59 => bands 2 and 3
+	CHECK_EQ(plane->num_sprites_in_band(0), 1);
+	CHECK_EQ(plane->num_sprites_in_band(16), 1);
+	CHECK_EQ(plane->num_sprites_in_band(32), 1);
+	CHECK_EQ(plane->num_sprites_in_band(48), 1);
+	CHECK_EQ(plane->num_sprites_in_band(64), 0);
+
+	plane->moveTo(a, Point(0, 50)); // rows 50 .. 69 => bands 3 and 4
+	CHECK_EQ(plane->num_sprites_in_band(0), 0);
+	CHECK_EQ(plane->num_sprites_in_band(16), 0);
+	CHECK_EQ(plane->num_sprites_in_band(48), 2);
+	CHECK_EQ(plane->num_sprites_in_band(64), 1);
+
+	plane->replace(b, make_shape(8, 40, 0x123)); // rows 40 .. 79 => bands 2 .. 4
+	CHECK_EQ(plane->num_sprites_in_band(32), 1);
+	CHECK_EQ(plane->num_sprites_in_band(64), 2);
+
+	plane->moveTo(a, Point(0, -100)); // above screen
+	delete plane->remove(b);
+	for (int row = 0; row < 1024; row += 16) CHECK_EQ(plane->num_sprites_in_band(row), 0);
+	CHECK_EQ(plane->num_sprites_in_band(-1), 0);
+	CHECK_EQ(plane->num_sprites_in_band(99999), 0);
+
+	plane->clear_displaylist(true);
+}
+
+TEST_CASE("MultiSpritesPlane: render")
+{
+	Shape				shape = make_shape(8, 20, 0x123);
+	RCPtr<SpritesPlane> plane = new SpritesPlane;
+
+	// 30 sprites above the screen must not use up the hotlist:
+	for (int i = 0; i < 30; i++) plane->add(new Sprite<Shape>(shape, Point(i * 10, -50 + i)));
+	// partially above the screen:
+	plane->add(new Sprite<Shape>(shape, Point(400, -10)));
+	// in the same row:
+	for (int i = 0; i < 10; i++) plane->add(new Sprite<Shape>(shape, Point(i * 10, 100)));
+
+	hotlist_overflow = false;
+	plane->vblank();
+	for (int row = 0; row < 200; row++)
+	{
+		uint n = row < 10 ? 8 : row >= 100 && row < 120 ? 80 : 0;
+		CHECK_EQ(count_pixels(plane, row, 0x123), n);
+	}
+	CHECK_FALSE(hotlist_overflow);
+
+	plane->clear_displaylist(true);
+}
+
+TEST_CASE("MultiSpritesPlane: wrapped shape data")
+{
+	// a Shape can wrap encoded shape data, e.g. from a resource file in flash:
+	Shape shape = make_shape(8, 20, 0x123);
+	Shape wrapped(shape.getData(), shape.width(), shape.height());
+	CHECK_EQ(wrapped.getData(), shape.getData());
+	CHECK_EQ(wrapped.size(), shape.size());
+
+	RCPtr<SpritesPlane> plane = new SpritesPlane;
+	plane->add(new Sprite<Shape>(wrapped, Point(100, 50)));
+	plane->vblank();
+	for (int row = 40; row < 80; row++) CHECK_EQ(count_pixels(plane, row, 0x123), row >= 50 && row < 70 ? 8 : 0);
+
+	plane->clear_displaylist(true);
+}
+
+TEST_CASE("MultiSpritesPlane: wrapped misaligned shape data")
+{
+	// resource data is not aligned: then the Shape makes a copy:
+	Shape shape = make_shape(8, 20, 0x123);
+	uint  count = Shape::calc_count(shape.getData());
+	CHECK_EQ(count, 20 * (8 + 1) + 1); // 20 * (PFX + 8 pixels) + END
+
+	alignas(Color) uint8 bu[200 * sizeof(Color) + 1];
+	REQUIRE(count * sizeof(Color) < sizeof(bu));
+	const Color* misaligned = reinterpret_cast<const Color*>(bu + 1);
+	memcpy(bu + 1, shape.getData(), count * sizeof(Color));
+
+	Shape wrapped(misaligned, shape.width(), shape.height());
+	CHECK_NE(wrapped.getData(), misaligned);
+	CHECK_EQ(memcmp(wrapped.getData(), shape.getData(), count * sizeof(Color)), 0);
+
+	RCPtr<SpritesPlane> plane = new SpritesPlane;
+	plane->add(new Sprite<Shape>(wrapped, Point(100, 50)));
+	plane->vblank();
+	for (int row = 40; row < 80; row++) CHECK_EQ(count_pixels(plane, row, 0x123), row >= 50 && row < 70 ? 8 : 0);
+
+	plane->clear_displaylist(true);
+}
@@ -396,6 +396,63 @@ TEST_CASE_TEMPLATE("Pixmap::drawChar()", T, ALL_PIXMAPS)
 }
 
 
+template<typename T>
+static void test_resetFirstRow(coord x0, coord w, int first_row)
+{
+	// rotate a window or the whole pixmap and compare with the pixels before.
+	// the pixels outside the window must not change.
+
+	constexpr int width = 40, height = 48;
+	T			  pm {width, height, attrheight_12px};
+
+	for (coord y = 0; y < height; y++)
+		for (coord x = 0; x < width; x++)
+		{
+			// attribute modes: same colors in all attributes
+			if constexpr (is_attribute_mode(T::colormode))
+			{
+				uint ink = uint(rand(T::colors_per_attr));
+				pm.set_pixel(x, y, ink * 3 + 1, ink);
+			}
+			else pm.set_pixel(x, y, uint(random()));
+		}
+
+	T pm0 {width, height, attrheight_12px};
+	pm0.copyRect(0, 0, pm, 0, 0, width, height);
+
+	CanvasPtr window = w == width ? nullptr : pm.cloneWindow(x0, 12, w, 24);
+	Canvas*	  win	 = window ? window.ptr() : &pm;
+	coord	  y0	 = window ? 12 : 0;
+
+	win->first_row = first_row;
+	win->resetFirstRow();
+	CHECK_EQ(win->first_row, 0);
+
+	int errors = 0;
+	for (coord y = 0; y < height; y++)
+		for (coord x = 0; x < width; x++)
+		{
+			coord qy = y;
+			if (x >= x0 && x < x0 + w && y >= y0 && y < y0 + win->height)
+				qy = y0 + (y - y0 + first_row) % win->height;
+
+			uint ink1, color1 = pm.get_pixel(x, y, &ink1);
+			uint ink0, color0 = pm0.get_pixel(x, qy, &ink0);
+			errors += color1 != color0 || ink1 != ink0;
+		}
+	CHECK_EQ(errors, 0);
+}
+
+TEST_CASE_TEMPLATE("Pixmap::resetFirstRow()", T, ALL_PIXMAPS, ALL_PIXMAPa1, ALL_PIXMAPa2)
+{
+	test_resetFirstRow<T>(0, 40, 12); // allocated
+	test_resetFirstRow<T>(0, 40, 5);
+	test_resetFirstRow<T>(8, 24, 12); // window: rotated in memory
+	test_resetFirstRow<T>(8, 24, 7);  // window: rotated with copyRect()
+	test_resetFirstRow<T>(8, 27, 12); // window: last byte is shared
+}
+
+
 #if 0 
 // c&p template:
 
@@ -0,0 +1,135 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "PlaneProfiler.h"
+#include "doctest.h"
+
+namespace kio::Video
+{
+uint32 cc_per_scanline = 1000; // normally in VideoBackend.cpp
+
+static uint32 cc_now = 0;
+uint32		  time_cc_32() noexcept { return cc_now; } // normally in VideoBackend.cpp
+} // namespace kio::Video
+
+using namespace kio::Video;
+using namespace kio;
+
+
+/*
+	a plane which takes `cc` cpu cycles for itself
+	and which renders up to 2 child planes like a HorizontalLayout.
+*/
+struct TestPlane : public VideoPlane
+{
+	uint32		cc;
+	VideoPlane* a;
+	VideoPlane* b;
+
+	TestPlane(uint32 cc, VideoPlane* a = nullptr, VideoPlane* b = nullptr) noexcept :
+		VideoPlane(nullptr, &render),
+		cc(cc),
+		a(a),
+		b(b)
+	{}
+
+	static void render(VideoPlane* vp, int row, int width, uint32* buffer) noexcept
+	{
+		TestPlane* me = static_cast<TestPlane*>(vp);
+		cc_now += me->cc / 2;
+		if (me->a) render_plane(me->a, row, width, buffer);
+		if (me->b) render_plane(me->b, row, width, buffer);
+		cc_now += me->cc - me->cc / 2;
+	}
+};
+
+
+TEST_CASE("PlaneProfiler: time of layouts without child planes")
+{
+	static_assert(profile_planes);
+
+	TestPlane a(100), b(300), c(200);
+	TestPlane inner(20, &b, &c);
+	TestPlane outer(50, &a, &inner);
+
+	resetPlaneProfiles();
+	render_plane(&outer, 0, 640, nullptr);
+	render_plane(&outer, 1, 640, nullptr);
+
+	CHECK_EQ(numPlaneProfiles(), 6);
+	CHECK_EQ(findPlaneProfile(&outer)->count, 2);
+	CHECK_EQ(findPlaneProfile(&outer)->cc_max, 50);
+	CHECK_EQ(findPlaneProfile(&inner)->cc_max, 20);
+	CHECK_EQ(findPlaneProfile(&a)->cc_max, 100);
+	CHECK_EQ(findPlaneProfile(&b)->cc_max, 300);
+	CHECK_EQ(findPlaneProfile(&c)->cc_min, 200);
+	CHECK_EQ(findPlaneProfile(&c)->cc_sum, 400);
+
+	resetPlaneProfiles();
+}
+
+TEST_CASE("PlaneProfiler: missed scanlines are attributed to the slowest plane")
+{
+	TestPlane a(100), b(300), c(200);
+	TestPlane inner(20, &b, &c);
+	TestPlane outer(50, &a, &inner);
+
+	resetPlaneProfiles();
+
+	// nothing rendered since the last scanline: blame the vblank
+	profile_next_scanline();
+	profile_scanlines_missed(1);
+	CHECK_EQ(findPlaneProfile(nullptr)->scanlines_missed, 1);
+
+	// the slowest child in a nested layout, not the layout:
+	profile_next_scanline();
+	render_plane(&outer, 0, 640, nullptr);
+	profile_scanlines_missed(2);
+	CHECK_EQ(findPlaneProfile(&b)->scanlines_missed, 2);
+	CHECK_EQ(findPlaneProfile(&inner)->scanlines_missed, 0);
+	CHECK_EQ(findPlaneProfile(&outer)->scanlines_missed, 0);
+
+	// a slow layout itself:
+	TestPlane slow(500, &a);
+	profile_next_scanline();
+	render_plane(&slow, 1, 640, nullptr);
+	profile_scanlines_missed(1);
+	CHECK_EQ(findPlaneProfile(&slow)->scanlines_missed, 1);
+	CHECK_EQ(findPlaneProfile(&a)->scanlines_missed, 0);
+
+	resetPlaneProfiles();
+}
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -3,6 +3,7 @@
 // https://opensource.org/licenses/BSD-2-Clause
 
 #include "Devices/Flash.h"
+#include "common/Dispatcher.h"
 #include "Devices/Preferences.h"
 #include "Devices/QspiFlashDevice.h"
 #include "Mock/MockFlash.h"
@@ -524,6 +525,102 @@ TEST_CASE("QspiFlash: optimizing partially no need writing")
 
 TEST_CASE("QspiFlash: optimizing partially no need erasing") {}
 
+static uint count_log(cstr what)
+{
+	uint n = 0;
+	for (uint i = 0; i < log.count(); i++) n += startswith(log[i], what);
+	return n;
+}
+
+TEST_CASE("QspiFlash: write cache")
+{
+	// write 64 sectors of 512 bytes = 8 erase blocks into flash which is not erased:
+	// uncached each sector needs an erase and a program cycle, cached each erase block.
+
+	for (uint i = 0; i < random_data_size; i++) random_data[i] = uint8(rand() >> 8);
+	Flash::setupMockFlash(&flash[0], flash_size);
+	static constexpr uint32 base = 1 MB, size = 64 kB, count = 64;
+
+	auto write_all = [](QspiFlashDevice<9>& q) {
+		for (LBA i = 0; i < count; i++) q.writeSectors(i, random_data + (i << 9), 1);
+	};
+
+	memset(&flash[base], 0x5a, size);
+	uint erases0, programs0;
+	{
+		QspiFlashDevice<9> q(base, size);
+		log.purge();
+		write_all(q);
+		q.sync();
+		erases0	  = count_log("erase");
+		programs0 = count_log("write");
+		CHECK_EQ(memcmp(&flash[base], random_data, count << 9), 0);
+	}
+
+	memset(&flash[base], 0x5a, size);
+	uint erases1, programs1;
+	{
+		QspiFlashDevice<9> q(base, size);
+		q.setWriteCache(2);
+		log.purge();
+		write_all(q);
+
+		// only the evicted blocks are written, reading goes through the cache:
+		CHECK_EQ(count_log("erase"), 6);
+		Array<uint8> bu {count << 9};
+		q.readSectors(0, &bu[0], count);
+		CHECK_EQ(memcmp(&bu[0], random_data, count << 9), 0);
+
+		q.sync();
+		erases1	  = count_log("erase");
+		programs1 = count_log("write");
+		CHECK_EQ(memcmp(&flash[base], random_data, count << 9), 0);
+	}
+
+	MESSAGE("uncached: ", erases0, " erase, ", programs0, " program cycles");
+	MESSAGE("cached:   ", erases1, " erase, ", programs1, " program cycles");
+	CHECK_EQ(erases0, count);
+	CHECK_EQ(programs0, count);
+	CHECK_EQ(erases1, count / 8);
+	CHECK_EQ(programs1, count / 8);
+	CHECK_FALSE(error);
+}
+
+TEST_CASE("QspiFlash: write cache - unaligned data, erase and timeout")
+{
+	for (uint i = 0; i < random_data_size; i++) random_data[i] = uint8(rand() >> 8);
+	Flash::setupMockFlash(&flash[0], flash_size);
+	static constexpr uint32 base = 1 MB, size = 64 kB;
+
+	memcpy(&flash[base], random_data, size);
+	memcpy(&flash2[base], random_data, size);
+	{
+		QspiFlashDevice<9> q(base, size);
+		q.setWriteCache(8, 1);
+		log.purge();
+
+		q.writeData(3000, random_data + 5000, 3000); // spans 2 erase blocks
+		memcpy(&flash2[base + 3000], random_data + 5000, 3000);
+		q.writeData(9000, nullptr, 100);
+		memset(&flash2[base + 9000], 0xff, 100);
+		q.writeSectors(30, nullptr, 3); // spans 2 erase blocks
+		memset(&flash2[base + 30 * 512], 0xff, 3 * 512);
+
+		Array<uint8> bu {size};
+		q.readData(0, &bu[0], size);
+		CHECK_EQ(memcmp(&bu[0], &flash2[base], size), 0);
+		CHECK_EQ(log.count(), 0);
+
+		// the Dispatcher flushes the blocks after the timeout:
+		CC start = now();
+		while (now() - start < 2000) {}
+		for (int i = 0; i < 10 && log.count() == 0; i++) Dispatcher::run(1000);
+		CHECK_EQ(count_log("erase"), 5);
+		CHECK_EQ(memcmp(&flash[base], &flash2[base], size), 0);
+	}
+	CHECK_FALSE(error);
+}
+
 #if !defined FLASH_PREFERENCES
 TEST_CASE("Preferences: ctor" * doctest::skip()) {}
 
@@ -0,0 +1,270 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/File.h"
+#include "Devices/FileSystem.h"
+#include "Devices/internal/RsrcFS.h"
+#include "Graphics/Pixmap.h"
+#include "doctest.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+// normally generated by the RsrcFileWriter:
+extern const unsigned char resource_file_data[] = {
+	// uncompressed file:
+	'a', '.', 't', 'x', 't', 0,					 // filename
+	5, 0, 0, 0,									 // size
+	'h', 'e', 'l', 'l', 'o',					 // data
+	// compressed file: (not decodable)
+	'c', '.', 'b', 'i', 'n', 0,					 // filename
+	10, 0, 0, 0x80,								 // usize | compressed
+	2, 0, 0,									 // csize
+	0x84,										 // flags
+	'x', 'y',									 // cdata
+	// 8x2 pixel bitmap:
+	'b', 'm', 'p', 0,							 // filename
+	2, 0, 0, 0,									 // size
+	0x81, 0x3c,									 // pixels
+	0,											 // end of resource data
+};
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+using namespace kio::Graphics;
+
+TEST_CASE("RsrcFS: getData")
+{
+	RCPtr<RsrcFS> fs   = new RsrcFS("rsrc");
+	uint32		  size = 0;
+
+	const uint8* data = fs->getData("rsrc:a.txt", &size);
+	CHECK_EQ(size, 5);
+	CHECK_EQ(memcmp(data, "hello", 5), 0);
+	CHECK(data > resource_file_data && data < resource_file_data + sizeof(resource_file_data));
+
+	CHECK_EQ(fs->getData("rsrc:c.bin", &size), nullptr);
+	CHECK_EQ(size, 10);
+
+	CHECK_THROWS(fs->getData("rsrc:nix.txt"));
+}
+
+TEST_CASE("RsrcFS: File::mmap()")
+{
+	RCPtr<RsrcFS> fs = new RsrcFS("rsrc");
+
+	FilePtr file = fs->openFile("rsrc:a.txt");
+	CHECK_EQ(file->mmap(), fs->getData("rsrc:a.txt"));
+	CHECK_EQ(file->getSize(), 5);
+
+	// the file can still be read normally:
+	char bu[6] = {0};
+	file->read(bu, 5);
+	CHECK_EQ(std::string(bu), "hello");
+
+	// the mapped data can be wrapped by a Pixmap without copying:
+	file			  = fs->openFile("rsrc:bmp");
+	const uint8* bits = reinterpret_cast<const uint8*>(file->mmap());
+	Bitmap		 bmp(8, 2, bits, 1);
+	CHECK_EQ(bmp.pixmap, bits);
+	CHECK_FALSE(bmp.allocated);
+	CHECK_EQ(bmp.get_color(0, 0), 1);
+	CHECK_EQ(bmp.get_color(1, 0), 0);
+	CHECK_EQ(bmp.get_color(2, 1) + bmp.get_color(5, 1), 2);
+
+	Bitmap copy(8, 2);
+	copy.copyRect(0, 0, bmp);
+	CHECK(copy == bmp);
+}
+
+
+// ***********************************************************************
+// sorted index
+
+struct TestFile
+{
+	cstr name;
+	cstr text;
+};
+
+static const TestFile test_files[] = {
+	{"b.txt", "bbb"},	 //
+	{"a.txt", "lower"},	 //
+	{"dir/x", "x"},		 //
+	{"A.txt", "upper"},	 //
+	{"dir/sub/z", "z"},	 //
+	{"dirx", "dirx"},	 //
+	{"dir/Y", "y"},		 //
+	{"README", "readme"} //
+};
+
+static bool index_order(cstr a, cstr b)
+{
+	// same as in the RsrcFileWriter: case-insensitive, then case-sensitive
+	int r = strcasecmp(a, b);
+	return r ? r < 0 : strcmp(a, b) < 0;
+}
+
+static std::vector<uint8> make_resource_data(bool with_index)
+{
+	// create resource data with uncompressed files in the order of test_files[]
+	// optionally preceded by the sorted index, same as the RsrcFileWriter does.
+
+	static constexpr char index_name[] = "\x01index";
+	static constexpr uint count		   = NELEM(test_files);
+
+	std::vector<uint8> data;
+	auto put32 = [&](uint32 n) { data.insert(data.end(), {uint8(n), uint8(n >> 8), uint8(n >> 16), uint8(n >> 24)}); };
+
+	uint32 offsets[count];
+	uint32 offset = with_index ? sizeof(index_name) + 8 + 4 * count : 0;
+	for (uint i = 0; i < count; i++)
+	{
+		offsets[i] = offset;
+		offset += uint32(strlen(test_files[i].name) + 1 + 4 + strlen(test_files[i].text));
+	}
+
+	if (with_index)
+	{
+		uint order[count];
+		for (uint i = 0; i < count; i++) order[i] = i;
+		std::sort(order, order + count, [](uint a, uint b) { return index_order(test_files[a].name, test_files[b].name); });
+
+		data.insert(data.end(), index_name, index_name + sizeof(index_name));
+		put32(4 + 4 * count);
+		put32(count);
+		for (uint i = 0; i < count; i++) put32(offsets[order[i]]);
+	}
+
+	for (const TestFile& f : test_files)
+	{
+		data.insert(data.end(), f.name, f.name + strlen(f.name) + 1);
+		put32(uint32(strlen(f.text)));
+		data.insert(data.end(), f.text, f.text + strlen(f.text));
+	}
+	data.push_back(0);
+	return data;
+}
+
+static std::string read_file(RsrcFS* fs, cstr path)
+{
+	uint32		 size = 0;
+	const uint8* data = fs->getData(path, &size);
+	return std::string(cptr(data), size);
+}
+
+static std::string list_dir(RsrcFS* fs, cstr path)
+{
+	// sorted, comma separated names, dirs with trailing '/'
+
+	std::vector<std::string> names;
+	DirectoryPtr			 dir = fs->openDir(path);
+	while (FileInfo info = dir->next()) names.push_back(std::string(info.fname) + (info.isaDir() ? "/" : ""));
+	std::sort(names.begin(), names.end());
+
+	std::string s;
+	for (auto& name : names) s += (s.empty() ? "" : ",") + name;
+	return s;
+}
+
+static void test_lookup(RsrcFS* fs)
+{
+	// exact match:
+	CHECK_EQ(read_file(fs, "rsrc:b.txt"), "bbb");
+	CHECK_EQ(read_file(fs, "rsrc:dir/Y"), "y");
+	CHECK_EQ(read_file(fs, "rsrc:dir/sub/z"), "z");
+	CHECK_EQ(read_file(fs, "rsrc:dirx"), "dirx");
+	CHECK_EQ(fs->getFileSize("rsrc:README"), 6);
+
+	// case-insensitive:
+	CHECK_EQ(read_file(fs, "rsrc:B.TXT"), "bbb");
+	CHECK_EQ(read_file(fs, "rsrc:dir/y"), "y");
+
+	// missing name:
+	CHECK_THROWS(fs->getData("rsrc:c.txt"));
+	CHECK_THROWS(fs->openFile("rsrc:dir/z"));
+	CHECK_THROWS(fs->getFileSize("rsrc:zzz"));
+	CHECK_EQ(fs->getFileType("rsrc:c.txt"), FileType::NoFile);
+	CHECK_EQ(fs->getFileType("rsrc:di"), FileType::NoFile);
+
+	// directories:
+	CHECK_EQ(fs->getFileType("rsrc:"), FileType::DirectoryFile);
+	CHECK_EQ(fs->getFileType("rsrc:dir"), FileType::DirectoryFile);
+	CHECK_EQ(fs->getFileType("rsrc:DIR/sub"), FileType::DirectoryFile);
+	CHECK_EQ(fs->getFileType("rsrc:dirx"), FileType::RegularFile);
+	CHECK_EQ(fs->getFileType("rsrc:dir/x"), FileType::RegularFile);
+	CHECK_THROWS(fs->openDir("rsrc:di"));
+	CHECK_THROWS(fs->openDir("rsrc:dir/x"));
+
+	// directory listing: the index is not listed:
+	CHECK_EQ(list_dir(fs, "rsrc:"), "A.txt,README,a.txt,b.txt,dir/,dirx");
+	CHECK_EQ(list_dir(fs, "rsrc:dir"), "Y,sub/,x");
+	CHECK_EQ(list_dir(fs, "rsrc:dir/sub"), "z");
+}
+
+TEST_CASE("RsrcFS: sorted index")
+{
+	std::vector<uint8> data = make_resource_data(true);
+	RCPtr<RsrcFS>	   fs	= new RsrcFS("rsrc", data.data());
+	test_lookup(fs);
+	CHECK_EQ(fs->getSize(), data.size() - 1);
+
+	// names which differ only in case:
+	// the one with the same case is found, else the first in the index:
+	CHECK_EQ(read_file(fs, "rsrc:a.txt"), "lower");
+	CHECK_EQ(read_file(fs, "rsrc:A.txt"), "upper");
+	CHECK_EQ(read_file(fs, "rsrc:A.TXT"), "upper");
+
+	// wildcards use the linear search:
+	CHECK_EQ(read_file(fs, "rsrc:b.t?t"), "bbb");
+	CHECK_EQ(read_file(fs, "rsrc:dir/s*/z"), "z");
+}
+
+TEST_CASE("RsrcFS: legacy format without index")
+{
+	std::vector<uint8> data = make_resource_data(false);
+	RCPtr<RsrcFS>	   fs	= new RsrcFS("rsrc", data.data());
+	test_lookup(fs);
+	CHECK_EQ(fs->getSize(), data.size() - 1);
+
+	// names which differ only in case: the first in the file is found:
+	CHECK_EQ(read_file(fs, "rsrc:a.txt"), "lower");
+	CHECK_EQ(read_file(fs, "rsrc:A.txt"), "lower");
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,211 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/SDCard.h"
+#include "Mock/MockSDCard.h"
+#include "common/Array.h"
+#include "common/Dispatcher.h"
+#include "common/cstrings.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+
+static constexpr uint32 disk_size = 1 MB;
+static constexpr uint	ssize	  = 512;
+
+static void fill_random(Array<uint8>& data)
+{
+	for (uint i = 0; i < data.count(); i++) data[i] = uint8(rand());
+}
+
+static RCPtr<SDCard> connect_sdcard()
+{
+	RCPtr<SDCard> sdcard = new SDCard(16, 17, 18, 19);
+	sdcard->ioctl(IoCtl::CTRL_CONNECT);
+	return sdcard;
+}
+
+
+TEST_CASE("SDCard: connect and read")
+{
+	Array<uint8> image {disk_size};
+	fill_random(image);
+	MockSDCard mock(image);
+
+	RCPtr<SDCard> sdcard = connect_sdcard();
+	CHECK_EQ(sdcard->card_type, SDCard::SDHC_v2);
+	CHECK_EQ(sdcard->sectorCount(), disk_size / ssize);
+	CHECK_EQ(sdcard->erased_byte, 0xff);
+	CHECK_FALSE(sdcard->no_crc);
+
+	uint8 bu[40 * ssize];
+	sdcard->readSectors(7, bu, 1);
+	CHECK_EQ(memcmp(bu, &image[7 * ssize], ssize), 0);
+
+	sdcard->readSectors(100, bu, 40);
+	CHECK_EQ(memcmp(bu, &image[100 * ssize], 40 * ssize), 0);
+	CHECK_EQ(mock.num_cmd18, 1);
+	CHECK_EQ(mock.num_dma_starts, 40);
+
+	CHECK_THROWS(sdcard->readSectors(disk_size / ssize - 2, bu, 4));
+}
+
+TEST_CASE("SDCard: readSectorsAsync")
+{
+	Array<uint8> image {disk_size};
+	fill_random(image);
+	MockSDCard	  mock(image);
+	RCPtr<SDCard> sdcard = connect_sdcard();
+
+	uint8 bu[64 * ssize];
+	for (uint token_delay : {0, 2, 100})
+	{
+		mock.token_delay	= token_delay;
+		mock.num_dma_polls	= 0;
+		mock.num_dma_starts = 0;
+		memset(bu, 0, sizeof(bu));
+
+		sdcard->readSectorsAsync(200, bu, 64);
+		CHECK(sdcard->isBusy());
+
+		uint polls = 1;
+		while (!sdcard->pollAsync()) polls++;
+		CHECK_FALSE(sdcard->isBusy());
+
+		CHECK_EQ(memcmp(bu, &image[200 * ssize], sizeof(bu)), 0);
+		CHECK_EQ(mock.num_dma_starts, 64);
+		CHECK_GT(mock.num_dma_polls, 0);
+		MESSAGE("token delay = ", token_delay, ": polls = ", polls, ", dma busy = ", mock.num_dma_polls);
+	}
+
+	// the sdcard is still usable after an async read:
+	sdcard->readSectors(3, bu, 2);
+	CHECK_EQ(memcmp(bu, &image[3 * ssize], 2 * ssize), 0);
+}
+
+TEST_CASE("SDCard: readSectorsAsync - crc error")
+{
+	Array<uint8> image {disk_size};
+	fill_random(image);
+	MockSDCard	  mock(image);
+	RCPtr<SDCard> sdcard = connect_sdcard();
+	uint8		  bu[16 * ssize];
+
+	// a block with bad crc is read again:
+	mock.bad_crc_block = 20 + 5;
+	mock.bad_crc_count = 1;
+	sdcard->readSectors(20, bu, 16);
+	CHECK_EQ(memcmp(bu, &image[20 * ssize], sizeof(bu)), 0);
+	CHECK_EQ(mock.num_cmd18, 2);
+	CHECK_EQ(mock.bad_crc_count, 0);
+
+	// but not forever:
+	mock.bad_crc_count = 999;
+	cstr error = nullptr;
+	try
+	{
+		sdcard->readSectors(20, bu, 16);
+	}
+	catch (cstr e)
+	{
+		error = e;
+	}
+	CHECK(eq(error, CRC_ERROR));
+	CHECK_FALSE(sdcard->isBusy());
+}
+
+TEST_CASE("SDCard: readSectors without free DMA channel")
+{
+	Array<uint8> image {disk_size};
+	fill_random(image);
+	MockSDCard	  mock(image);
+	RCPtr<SDCard> sdcard = connect_sdcard();
+	uint8		  bu[16 * ssize];
+
+	// claim all but one dma channel:
+	Array<int> channels;
+	for (int c; (c = dma_claim_unused_channel(false)) >= 0;) channels.append(c);
+	dma_channel_unclaim(uint(channels.pop()));
+
+	sdcard->readSectors(30, bu, 16);
+	CHECK_EQ(memcmp(bu, &image[30 * ssize], sizeof(bu)), 0);
+	CHECK_EQ(mock.num_dma_starts, 0);
+
+	// a block with bad crc is read again:
+	mock.bad_crc_block = 40 + 3;
+	mock.bad_crc_count = 1;
+	sdcard->readSectors(40, bu, 16);
+	CHECK_EQ(memcmp(bu, &image[40 * ssize], sizeof(bu)), 0);
+	CHECK_EQ(mock.bad_crc_count, 0);
+
+	// dma is used when channels become available:
+	while (channels.count()) dma_channel_unclaim(uint(channels.pop()));
+	sdcard->readSectors(50, bu, 16);
+	CHECK_EQ(memcmp(bu, &image[50 * ssize], sizeof(bu)), 0);
+	CHECK_EQ(mock.num_dma_starts, 16);
+}
+
+TEST_CASE("SDCard: readSectorsAsync with callback")
+{
+	Array<uint8> image {disk_size};
+	fill_random(image);
+	MockSDCard	  mock(image);
+	RCPtr<SDCard> sdcard = connect_sdcard();
+
+	static bool done;
+	static cstr error;
+	auto		callback = [](void*, cstr e) noexcept { done = true, error = e; };
+
+	uint8 bu[32 * ssize];
+	done = false, error = "";
+	sdcard->readSectorsAsync(1000, bu, 32, callback);
+	for (uint i = 0; i < 100000 && !done; i++) Dispatcher::run(100);
+
+	CHECK(done);
+	CHECK(error == nullptr);
+	CHECK_EQ(memcmp(bu, &image[1000 * ssize], sizeof(bu)), 0);
+
+	// errors are passed to the callback:
+	done = false, error = nullptr;
+	sdcard->readSectorsAsync(disk_size / ssize - 4, bu, 8, callback);
+	for (uint i = 0; i < 100000 && !done; i++) Dispatcher::run(100);
+
+	CHECK(done);
+	CHECK(error != nullptr);
+	CHECK_FALSE(sdcard->isBusy());
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
@@ -0,0 +1,155 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "FrameBuffer.h"
+#include "Pixmap_wAttr.h"
+#include "ScanlineQueue.h"
+#include "common/Xoshiro128.h"
+#include "doctest.h"
+#include <memory>
+#include <thread>
+
+using namespace kio::Graphics;
+using namespace kio::Video;
+using namespace kio;
+
+
+/*
+	Host simulation of dual-core rendering:
+	the main thread plays core1 and renders the even rows, a second thread plays core0
+	and renders the odd rows which it gets through the ScanlineQueue.
+	The result must be the same as if all rows were rendered by one thread.
+*/
+
+
+template<ColorMode CM>
+static RCPtr<Pixmap<CM>> make_pixmap(int width, int height, AttrHeight ah)
+{
+	RCPtr<Pixmap<CM>> pm;
+	if constexpr (is_attribute_mode(CM)) pm = new Pixmap<CM>(width, height, ah);
+	else pm = new Pixmap<CM>(width, height);
+
+	Xoshiro128 rng(uint32(width + ah));
+	for (int i = 0; i < pm->row_offset * height; i++) pm->pixmap[i] = uint8(rng.next());
+	if constexpr (is_attribute_mode(CM))
+		for (int i = 0; i < pm->attributes.row_offset * pm->attributes.height; i++)
+			pm->attributes.pixmap[i] = uint8(rng.next());
+	return pm;
+}
+
+struct Frame
+{
+	int						  width, height, words_per_row;
+	std::unique_ptr<uint32[]> buffer;
+
+	Frame(int w, int h) : width(w), height(h), words_per_row(w * int(sizeof(Color)) / 4 + 1)
+	{
+		buffer = std::make_unique<uint32[]>(uint(words_per_row * h));
+	}
+	uint32*		 operator[](int row) { return buffer.get() + row * words_per_row; }
+	const Color* colors(int row) { return reinterpret_cast<const Color*>((*this)[row]); }
+	bool operator==(Frame& other) { return memcmp(buffer.get(), other.buffer.get(), uint(words_per_row * height) * 4) == 0; }
+};
+
+static void render_single_core(VideoPlane* vp, Frame& frame)
+{
+	vp->vblank_fu(vp);
+	for (int row = 0; row < frame.height; row++) vp->render_fu(vp, row, frame.width, frame[row]);
+}
+
+static void render_dual_core(VideoPlane* vp, Frame& frame, int num_frames)
+{
+	ScanlineQueue<> queue;
+	volatile bool	stop		 = false;
+	uint			num_rendered = 0;
+
+	auto render = [vp, &frame](int row, uint32* scanline, uint32 = 0) {
+		vp->render_fu(vp, row, frame.width, scanline);
+	};
+
+	std::thread core0([&] {
+		setupInterpolatorsOnCore0();
+		while (!stop) num_rendered += queue.render_all(render);
+	});
+
+	uint num_queued = 0;
+	for (int i = 0; i < num_frames; i++)
+	{
+		queue.wait_idle();
+		vp->vblank_fu(vp);
+		for (int row = 0; row < frame.height; row++)
+		{
+			if ((row & 1) && queue.put(row, frame[row])) num_queued++;
+			else render(row, frame[row]);
+		}
+	}
+
+	queue.wait_idle();
+	stop = true;
+	core0.join();
+	CHECK_EQ(num_rendered, num_queued);
+	CHECK_GT(num_queued, 0);
+}
+
+template<ColorMode CM>
+static void test_framebuffer(int width, int height, AttrHeight ah = attrheight_none)
+{
+	initializeInterpolators();
+
+	auto				   pm = make_pixmap<CM>(width, height, ah);
+	RCPtr<FrameBuffer<CM>> fb = new FrameBuffer<CM>(pm);
+	Frame				   single(width, height), dual(width, height);
+
+	CHECK(fb->reentrant);
+	render_single_core(fb, single);
+
+	int errors = 0;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+		{
+			uint c = pm->get_color(x, y);
+			if constexpr (is_indexed_color(CM)) errors += single.colors(y)[x] != fb->colormap->colors[c];
+			else errors += single.colors(y)[x] != Color(c);
+		}
+	CHECK_EQ(errors, 0);
+
+	render_dual_core(fb, dual, 3);
+	CHECK(single == dual);
+}
+
+
+TEST_CASE("ScanlineQueue: put & render_all")
+{
+	ScanlineQueue<4> queue;
+	uint32			 scanline[4];
+	CHECK(queue.is_idle());
+	for (int i = 0; i < 4; i++) CHECK(queue.put(i, scanline + i, uint32(1000 + i)));
+	CHECK_FALSE(queue.put(4, scanline));
+	CHECK_EQ(queue.avail(), 4);
+
+	int	 sum = 0;
+	uint n	 = queue.render_all([&](int row, uint32* p, uint32 deadline) {
+		  CHECK_EQ(p, scanline + row);
+		  CHECK_EQ(deadline, uint32(1000 + row));
+		  sum += row;
+	  });
+	CHECK_EQ(n, 4);
+	CHECK_EQ(sum, 0 + 1 + 2 + 3);
+	CHECK(queue.is_idle());
+	CHECK(queue.put(5, scanline)); // wrap around
+	CHECK_EQ(queue.free(), 3);
+}
+
+TEST_CASE("ScanlineQueue: dual-core rendering matches single-core rendering")
+{
+	SUBCASE("i1") { test_framebuffer<colormode_i1>(320, 240); }
+	SUBCASE("i4") { test_framebuffer<colormode_i4>(320, 240); }
+	SUBCASE("i8") { test_framebuffer<colormode_i8>(320, 240); }
+	SUBCASE("rgb") { test_framebuffer<colormode_rgb>(200, 150); }
+	SUBCASE("a1w8 8px") { test_framebuffer<colormode_a1w8>(400, 300, attrheight_8px); }
+	SUBCASE("a1w8 12px") { test_framebuffer<colormode_a1w8>(640, 480, attrheight_12px); }
+	SUBCASE("a1w4 1px") { test_framebuffer<colormode_a1w4>(320, 240, attrheight_1px); }
+	SUBCASE("a2w8 7px") { test_framebuffer<colormode_a2w8>(320, 241, attrheight_7px); }
+	SUBCASE("a1w1 16px") { test_framebuffer<colormode_a1w1>(320, 600, attrheight_16px); }
+}
@@ -1186,6 +1186,121 @@ TEST_CASE("TextVDU: scrollScreen()")
 	CHECK_EQ(tv.scroll_count, 0);
 }
 
+static bool same_display(const Canvas& a, const Canvas& b)
+{
+	// compare the images as displayed by a FrameBuffer, starting at first_row:
+
+	for (coord y = 0; y < a.height; y++)
+	{
+		coord ya = (y + a.first_row) % a.height;
+		coord yb = (y + b.first_row) % b.height;
+		for (coord x = 0; x < a.width; x++)
+		{
+			uint ink_a, ink_b;
+			if (a.get_pixel(x, ya, &ink_a) != b.get_pixel(x, yb, &ink_b) || ink_a != ink_b) return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("TextVDU: fast scrolling")
+{
+	// a full-screen TextVDU scrolls vertically by moving the first_row of the pixmap.
+	// a TextVDU on a window must copy the pixels. both must display the same image.
+
+	RCPtr<RealPixmap> pm   = new RealPixmap(80, 60, attrheight_12px); // 10*5
+	RCPtr<RealPixmap> full = new RealPixmap(80, 60, attrheight_12px);
+	CanvasPtr		  win  = full->cloneWindow(0, 0, 80, 60);
+	pm->clear(0);
+	full->clear(0);
+
+	TextVDU tv1(pm);
+	TextVDU tv2(win);
+	CHECK(tv1.fast_scroll);
+	CHECK_FALSE(tv2.fast_scroll);
+
+	auto both = [&](auto&& fu) {
+		fu(tv1);
+		fu(tv2);
+		return same_display(*pm, *full);
+	};
+
+	CHECK(both([](TextVDU& tv) {
+		tv.cls();
+		for (int i = 0; i < 7; i++)
+		{
+			tv.bgcolor = 100u + uint(i);
+			tv.printf("line %i\n", i);
+		}
+	}));
+	CHECK_EQ(tv1.scroll_count, tv2.scroll_count);
+	CHECK_EQ(tv1.top_row(), 2);
+	CHECK_EQ(pm->first_row, 24);
+	CHECK_EQ(full->first_row, 0);
+
+	CHECK(both([](TextVDU& tv) { tv.moveTo(1, 0), tv.insertRows(2); }));
+	CHECK(both([](TextVDU& tv) { tv.moveTo(0, 3), tv.deleteRows(1); }));
+	CHECK(both([](TextVDU& tv) { tv.scrollScreenDown(2); }));
+	CHECK(both([](TextVDU& tv) { tv.scrollScreenUp(3); }));
+	CHECK(both([](TextVDU& tv) { tv.scrollScreen(-1, 1); })); // not fast
+	CHECK(both([](TextVDU& tv) { tv.moveTo(2, 5), tv.clearToEndOfScreen(); }));
+	CHECK(both([](TextVDU& tv) { tv.moveTo(4, 9), tv.print("XY"); }));
+	CHECK(both([](TextVDU& tv) { tv.showCursor(); }));
+	CHECK_NE(tv1.top_row(), 0);
+
+	// rotate the pixels in memory and reset first_row:
+	tv1.hideCursor();
+	tv2.hideCursor();
+	pm->resetFirstRow();
+	CHECK_EQ(pm->first_row, 0);
+	CHECK(same_display(*pm, *full));
+
+	// same for a window: row by row:
+	win->first_row = 24;
+	win->resetFirstRow();
+	CHECK_EQ(win->first_row, 0);
+	pm->first_row = 24;
+	CHECK(same_display(*pm, *full));
+}
+
+TEST_CASE("TextVDU: fast scrolling with a shared pixmap")
+{
+	// the AnsiTerm swaps TextVDUs on the same pixmap for DECSC and DECRC.
+	// if one TextVDU scrolls then the other must print at the scrolled position too.
+
+	RCPtr<RealPixmap> pm   = new RealPixmap(80, 60, attrheight_12px); // 10*5
+	RCPtr<RealPixmap> full = new RealPixmap(80, 60, attrheight_12px);
+	CanvasPtr		  win  = full->cloneWindow(0, 0, 80, 60);
+	pm->clear(0);
+	full->clear(0);
+
+	TextVDU tv1(pm);
+	TextVDU tv2(win);
+	TextVDU tv1b(pm);
+	CHECK(tv1b.fast_scroll);
+
+	tv1.cls();
+	tv2.cls();
+	for (int i = 0; i < 7; i++)
+	{
+		tv1.printf("line %i\n", i);
+		tv2.printf("line %i\n", i);
+	}
+	CHECK_EQ(tv1.top_row(), 2);
+	CHECK_EQ(tv1b.top_row(), 2);
+
+	tv1b.moveTo(0, 0), tv1b.print("XY");
+	tv2.moveTo(0, 0), tv2.print("XY");
+	CHECK(same_display(*pm, *full));
+
+	tv1b.scrollScreenUp(1);
+	tv2.scrollScreenUp(1);
+	CHECK_EQ(tv1.top_row(), 3);
+	tv1.moveTo(4, 2), tv1.print("Z");
+	tv2.moveTo(4, 2), tv2.print("Z");
+	CHECK(same_display(*pm, *full));
+}
+
 TEST_CASE("TextVDU: scrollScreenUp()")
 {
 	RCPtr<Pixmap> pm = new Pixmap(80, 60); // 10*5
@@ -1577,6 +1692,93 @@ TEST_CASE("TextVDU: printCharMatrix()") //
 	CHECK(1 == 1);
 }
 
+TEST_CASE("TextVDU: printRun()")
+{
+	// printRun() must print the same as printChar() for each char:
+
+	static constexpr char text[] = "The quick brown fox jumps over the lazy dog. 0123456789 {}[]()<>";
+	static constexpr int  size	 = int(sizeof(text) - 1);
+
+	RCPtr<RealPixmap> pm1 = new RealPixmap(80, 60, attrheight_12px); // 10*5
+	RCPtr<RealPixmap> pm2 = new RealPixmap(80, 60, attrheight_12px);
+	TextVDU			  tv1(pm1);
+	TextVDU			  tv2(pm2);
+	tv1.cls();
+	tv2.cls();
+
+	for (uint attr : {0, 1, 3, 8, 16, 32, 64, 128})
+	{
+		tv1.bgcolor = tv2.bgcolor = 100 + attr;
+		tv1.setAttributes(attr);
+		tv2.setAttributes(attr);
+		tv1.moveTo(1, 3);
+		tv2.moveTo(1, 3);
+
+		tv1.printRun(text, size);
+		for (int i = 0; i < size; i++) tv2.printChar(text[i]);
+
+		CHECK_EQ(tv1.row, tv2.row);
+		CHECK_EQ(tv1.col, tv2.col);
+		CHECK_EQ(tv1.scroll_count, tv2.scroll_count);
+		CHECK(same_display(*pm1, *pm2));
+	}
+}
+
+TEST_CASE("TextVDU: glyph cache")
+{
+	RCPtr<RealPixmap> pm1 = new RealPixmap(80, 60, attrheight_12px); // 10*5
+	RCPtr<RealPixmap> pm2 = new RealPixmap(80, 60, attrheight_12px);
+	TextVDU			  tv1(pm1);
+	TextVDU			  tv2(pm2);
+	tv1.cls();
+	tv2.cls();
+	CHECK_EQ(tv1.glyphCacheSize(), tv1.default_glyph_cache_size);
+
+	tv1.setGlyphCacheSize(3);
+	tv2.setGlyphCacheSize(0);
+	CHECK_EQ(tv1.glyphCacheSize(), 3);
+	CHECK_EQ(tv2.glyphCacheSize(), 0);
+
+	// no attributes: not cached
+	tv1.print("abc");
+	CHECK_EQ(tv1.glyph_cache_hits, 0);
+	CHECK_EQ(tv1.glyph_cache_misses, 0);
+
+	tv1.setAttributes(tv1.BOLD);
+	tv1.print("abab");
+	CHECK_EQ(tv1.glyph_cache_misses, 2);
+	CHECK_EQ(tv1.glyph_cache_hits, 2);
+
+	tv1.setAttributes(tv1.BOLD | tv1.UNDERLINE); // other key
+	tv1.print("a");
+	CHECK_EQ(tv1.glyph_cache_misses, 3);
+
+	tv1.setAttributes(tv1.BOLD);
+	tv1.print("c"); // replaces bold 'a', the least recently used
+	tv1.print("b");
+	CHECK_EQ(tv1.glyph_cache_misses, 4);
+	CHECK_EQ(tv1.glyph_cache_hits, 3);
+	tv1.print("a");
+	CHECK_EQ(tv1.glyph_cache_misses, 5);
+
+	// cached and uncached glyphs are the same:
+	tv1.setGlyphCacheSize(8);
+	tv1.cls();
+	tv2.cls();
+	for (uint attr : {1, 2, 4, 8, 128, 1 + 8})
+	{
+		tv1.setAttributes(attr);
+		tv2.setAttributes(attr);
+		tv1.print("Hello World");
+		tv2.print("Hello World");
+		tv1.printChar('x', 3);
+		tv2.printChar('x', 3);
+	}
+	CHECK(same_display(*pm1, *pm2));
+	CHECK_GT(tv1.glyph_cache_hits, 0);
+	CHECK_EQ(tv2.glyph_cache_hits + tv2.glyph_cache_misses, 0);
+}
+
 TEST_CASE("TextVDU: printChar()") //
 {
 	CHECK(1 == 1);
@@ -0,0 +1,101 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "TileMapPlane.h"
+#include "doctest.h"
+#include <memory>
+
+using namespace kio::Graphics;
+using namespace kio::Video;
+using namespace kio;
+
+
+template<ColorMode CM>
+static RCPtr<Pixmap<CM>> make_tiles(int tile_width, int tile_height, int num_tiles)
+{
+	// every pixel in the atlas gets a different value (modulo colors):
+	RCPtr<Pixmap<CM>> tiles = new Pixmap<CM>(tile_width, tile_height * num_tiles);
+	for (int y = 0; y < tiles->height; y++)
+		for (int x = 0; x < tiles->width; x++) tiles->set_pixel(x, y, uint(y * 7 + x * 3 + 1));
+	return tiles;
+}
+
+template<ColorMode CM>
+static Color expected_color(const TileMapPlane<CM>& tm, int x, int y)
+{
+	// the color of the pixel at screen position x,y
+	int	 mx	 = (x / tm.tile_width) % tm.map_width;
+	int	 my	 = (y / tm.tile_height) % tm.map_height;
+	uint idx = tm.tile(mx, my);
+	uint px	 = tm.tiles->get_color(x % tm.tile_width, int(idx) * tm.tile_height + y % tm.tile_height);
+	if constexpr (CM == colormode_rgb) return Color(px);
+	else return tm.colormap->colors[px];
+}
+
+template<ColorMode CM>
+static void test_tilemap(int tile_width, int tile_height, int map_width, int map_height, int width, int height)
+{
+	using TileMap = TileMapPlane<CM>;
+
+	initializeInterpolators();
+
+	constexpr int num_tiles = 5;
+	auto		  tiles		= make_tiles<CM>(tile_width, tile_height, num_tiles);
+	RCPtr<TileMap> tm = new TileMap(tiles, nullptr, map_width, map_height, tile_height, width);
+
+	for (int y = 0; y < map_height; y++)
+		for (int x = 0; x < map_width; x++) tm->setTile(x, y, uint8((x + y * 3) % num_tiles));
+
+	auto scanline = std::make_unique<uint32[]>(uint(width) * sizeof(Color) / sizeof(uint32) + 1);
+
+	static constexpr int scroll_positions[][2] = {
+		{0, 0}, {1, 0}, {0, 1}, {7, 3}, {8, 8}, {17, 33}, {-1, -1}, {-5, 1000}, {1001, -77}};
+
+	for (auto& sp : scroll_positions)
+	{
+		tm->setScrollPosition(sp[0], sp[1]);
+		TileMap::vblank(tm);
+
+		int errors = 0;
+		for (int row = 0; row < height; row++)
+		{
+			TileMap::render(tm, row, width, scanline.get());
+			const Color* colors = reinterpret_cast<const Color*>(scanline.get());
+
+			int map_w = map_width * tile_width;
+			int map_h = map_height * tile_height;
+			int y	  = ((row + sp[1]) % map_h + map_h) % map_h;
+
+			for (int x = 0; x < width; x++)
+			{
+				int xx = ((x + sp[0]) % map_w + map_w) % map_w;
+				errors += colors[x] != expected_color(*tm, xx, y);
+			}
+		}
+		CHECK_EQ(errors, 0);
+	}
+}
+
+
+TEST_CASE("TileMapPlane")
+{
+	SUBCASE("i1") { test_tilemap<colormode_i1>(8, 8, 50, 40, 320, 40); }
+	SUBCASE("i2") { test_tilemap<colormode_i2>(8, 8, 41, 30, 320, 40); }
+	SUBCASE("i4") { test_tilemap<colormode_i4>(16, 4, 12, 7, 320, 40); }
+	SUBCASE("i8") { test_tilemap<colormode_i8>(8, 16, 80, 60, 640, 40); }
+	SUBCASE("rgb") { test_tilemap<colormode_rgb>(16, 16, 9, 9, 200, 40); }
+	SUBCASE("i8 16px") { test_tilemap<colormode_i8>(16, 2, 3, 5, 400, 40); }
+	SUBCASE("i1 16px") { test_tilemap<colormode_i1>(16, 1, 31, 3, 400, 40); }
+}
+
+TEST_CASE("TileMapPlane: bad parameters")
+{
+	auto tiles12 = make_tiles<colormode_i8>(12, 8, 4);
+	auto tiles8	 = make_tiles<colormode_i8>(8, 8, 4);
+
+	CHECK_THROWS(new TileMapPlane<colormode_i8>(tiles12, nullptr, 10, 10, 8, 320));
+	CHECK_THROWS(new TileMapPlane<colormode_i8>(tiles8, nullptr, 10, 10, 6, 320));
+	CHECK_THROWS(new TileMapPlane<colormode_i8>(tiles8, nullptr, 10, 10, 64, 320));
+	CHECK_NOTHROW(RCPtr<TileMapPlane<colormode_i8>>(new TileMapPlane<colormode_i8>(tiles8, nullptr, 10, 10, 8, 320)));
+}
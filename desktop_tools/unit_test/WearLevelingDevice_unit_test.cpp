@@ -0,0 +1,261 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Devices/Flash.h"
+#include "Devices/QspiFlashDevice.h"
+#include "Devices/WearLevelingDevice.h"
+#include "Mock/MockFlash.h"
+#include "common/Array.h"
+#include "common/Xoshiro128.h"
+#include "doctest.h"
+
+namespace kio::Test
+{
+using namespace kio::Devices;
+
+static constexpr uint32 flash_size = 1 MB;
+static constexpr uint32 disk_base  = 256 kB;
+static constexpr uint32 disk_size  = 256 kB;
+static constexpr uint	ssize	   = 512;
+
+/*
+	Simulate the writes of a FAT file system:
+	static files are written once, then files are rewritten over and over again
+	and after each chunk of data the FAT sector and the directory sector are updated.
+*/
+static void fat_workload(BlockDevice* disk, Array<uint8>& shadow, uint iterations)
+{
+	Xoshiro128 rng(1234);
+	uint	   num_sectors = disk->sectorCount();
+	uint8	   bu[ssize];
+	memset(&shadow[0], 0xff, shadow.count());
+
+	auto write = [&](LBA lba) {
+		for (uint i = 0; i < ssize; i++) bu[i] = uint8(rng.next());
+		disk->writeSectors(lba, bu, 1);
+		memcpy(&shadow[lba * ssize], bu, ssize);
+	};
+
+	// static data in the upper half:
+	for (LBA lba = num_sectors / 2; lba < num_sectors; lba++) write(lba);
+
+	for (uint i = 0; i < iterations; i++)
+	{
+		LBA file = 16 + (i % 8) * 16; // 8 files of 16 sectors
+		for (uint j = 0; j < 4; j++) write(file + (i / 8 % 4) * 4 + j);
+		write(1); // FAT
+		write(8); // directory
+	}
+}
+
+static uint32 max_erase_count(MockFlash& mock)
+{
+	uint32 n = 0;
+	for (uint32 a = disk_base; a < disk_base + disk_size; a += Flash::esize) n = max(n, mock.eraseCount(a));
+	return n;
+}
+
+static void print_histogram(cstr title, MockFlash& mock)
+{
+	// number of erase blocks per erase count range 0, 1, 2-3, 4-7, ...
+
+	uint histogram[20] = {0};
+	for (uint32 a = disk_base; a < disk_base + disk_size; a += Flash::esize)
+	{
+		uint n = mock.eraseCount(a), i = 0;
+		while (n) i++, n >>= 1;
+		histogram[i]++;
+	}
+
+	printf("%s: erase count histogram\n", title);
+	for (uint i = 0, n = 0; i < 20; i++, n = n ? n * 2 : 1)
+		if (histogram[i]) printf("  %5u..%-5u: %u blocks\n", n, n ? n * 2 - 1 : 0, histogram[i]);
+}
+
+static void verify(BlockDevice* disk, const Array<uint8>& shadow)
+{
+	uint8 bu[ssize];
+	int	  errors = 0;
+	for (LBA lba = 0; lba < disk->sectorCount(); lba++)
+	{
+		disk->readSectors(lba, bu, 1);
+		errors += memcmp(bu, &shadow[lba * ssize], ssize) != 0;
+	}
+	CHECK_EQ(errors, 0);
+}
+
+
+/*
+	NOR flash with 64 kB erase blocks in RAM:
+	programming can only clear bits. programming bits which are already cleared is flagged as an error.
+*/
+class BigBlockFlash : public BlockDevice
+{
+public:
+	static constexpr uint ss_erase = 16;
+
+	Array<uint8> data;
+	bool		 overwritten = false;
+
+	BigBlockFlash(uint32 size) : BlockDevice(size >> 9, 9, 9, ss_erase, readwrite), data(size)
+	{
+		memset(&data[0], 0xff, size);
+	}
+
+	virtual void readData(ADDR addr, void* bu, SIZE size) override { memcpy(bu, &data[uint(addr)], size); }
+	virtual void writeData(ADDR addr, const void* bu, SIZE size) override
+	{
+		const uint8* q = reinterpret_cast<const uint8*>(bu);
+		for (uint i = 0; i < size; i++)
+		{
+			uint8& z = data[uint(addr) + i];
+			overwritten |= (~z & q[i]) != 0 || (z != 0xff && q[i] != 0xff);
+			z &= q[i];
+		}
+	}
+	virtual void readSectors(LBA lba, void* bu, SIZE count) override { readData(ADDR(lba) << 9, bu, count << 9); }
+	virtual void writeSectors(LBA lba, const void* bu, SIZE count) override
+	{
+		if (bu) return writeData(ADDR(lba) << 9, bu, count << 9);
+		assert(((lba << 9) & ((1 << ss_erase) - 1)) == 0 && ((count << 9) & ((1 << ss_erase) - 1)) == 0);
+		memset(&data[lba << 9], 0xff, count << 9);
+	}
+};
+
+
+TEST_CASE("WearLevelingDevice: construction")
+{
+	Array<uint8> flash {flash_size};
+	Array<cstr>	 log;
+	bool		 error = false;
+	MockFlash	 mock(flash, log, error);
+	Flash::setupMockFlash(&flash[0], flash_size);
+	memset(&flash[0], 0xff, flash_size);
+
+	RCPtr<WearLevelingDevice> ftl = new WearLevelingDevice(new QspiFlashDevice<9>(disk_base, disk_size));
+	CHECK_EQ(ftl->numBlocks(), disk_size / Flash::esize);
+	CHECK_EQ(ftl->sectorCount(), (ftl->numBlocks() - 4) * 7);
+	CHECK_EQ(ftl->numFreeBlocks(), ftl->numBlocks());
+
+	// unwritten sectors read as erased:
+	uint8 bu[ssize];
+	ftl->readSectors(10, bu, 1);
+	CHECK_EQ(bu[0], 0xff);
+	CHECK_EQ(bu[ssize - 1], 0xff);
+
+	CHECK_THROWS(ftl->writeSectors(ftl->sectorCount(), bu, 1));
+	CHECK_FALSE(error);
+}
+
+TEST_CASE("WearLevelingDevice: erase count histogram")
+{
+	static constexpr uint iterations = 1000;
+
+	Array<uint8> flash {flash_size};
+	Array<cstr>	 log;
+	bool		 error = false;
+	MockFlash	 mock(flash, log, error);
+	Flash::setupMockFlash(&flash[0], flash_size);
+
+	uint32 max_direct, max_ftl;
+
+	// sectors mapped directly to flash:
+	{
+		memset(&flash[0], 0xff, flash_size);
+		mock.erase_counts.purge(), mock.erase_counts.grow(flash_size / Flash::esize);
+
+		RCPtr<QspiFlashDevice<9>> disk = new QspiFlashDevice<9>(disk_base, disk_size);
+		Array<uint8>			  shadow {disk_size};
+		fat_workload(disk, shadow, iterations);
+		verify(disk, shadow);
+
+		print_histogram("direct", mock);
+		max_direct = max_erase_count(mock);
+	}
+
+	// with the flash translation layer:
+	{
+		memset(&flash[0], 0xff, flash_size);
+		mock.erase_counts.purge(), mock.erase_counts.grow(flash_size / Flash::esize);
+
+		RCPtr<QspiFlashDevice<9>> disk = new QspiFlashDevice<9>(disk_base, disk_size);
+		RCPtr<WearLevelingDevice> ftl  = new WearLevelingDevice(disk);
+		Array<uint8>			  shadow {ftl->totalSize()};
+		fat_workload(ftl, shadow, iterations);
+		while (ftl->collectGarbage()) {}
+		verify(ftl, shadow);
+
+		print_histogram("FTL", mock);
+		max_ftl = max_erase_count(mock);
+
+		uint32 min_ftl = max_ftl;
+		for (uint b = 0; b < ftl->numBlocks(); b++) min_ftl = min(min_ftl, ftl->eraseCount(b));
+		CHECK_LE(max_ftl - min_ftl, WearLevelingDevice::wear_threshold + 1);
+
+		// the map is rebuilt from the block headers:
+		ftl = nullptr;
+		ftl = new WearLevelingDevice(disk);
+		verify(ftl, shadow);
+	}
+
+	MESSAGE("max. erase count: direct = ", max_direct, ", FTL = ", max_ftl);
+	CHECK_GE(max_direct, iterations - 1);
+	CHECK_LT(max_ftl * 10, max_direct);
+	CHECK_FALSE(error);
+}
+
+TEST_CASE("WearLevelingDevice: 64 kB erase blocks")
+{
+	// the block header must fit in sector 0:
+	// with 64 kB blocks there are only 125 slots, not 127.
+
+	RCPtr<BigBlockFlash>	  flash = new BigBlockFlash(8 * 64 kB);
+	RCPtr<WearLevelingDevice> ftl	= new WearLevelingDevice(flash.ptr(), 3);
+	CHECK_EQ(ftl->numBlocks(), 8);
+	CHECK_EQ(ftl->sectorCount(), (8 - 3) * 125);
+
+	Array<uint8> shadow {ftl->totalSize()};
+	fat_workload(ftl, shadow, 200);
+	verify(ftl, shadow);
+	CHECK_FALSE(flash->overwritten);
+
+	// the map and the erase counts are rebuilt from the block headers:
+	uint32 erase_counts[8];
+	for (uint b = 0; b < 8; b++) erase_counts[b] = ftl->eraseCount(b);
+	ftl = nullptr;
+	ftl = new WearLevelingDevice(flash.ptr(), 3);
+	verify(ftl, shadow);
+	for (uint b = 0; b < 8; b++) CHECK_EQ(ftl->eraseCount(b), erase_counts[b]);
+	CHECK_FALSE(flash->overwritten);
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/
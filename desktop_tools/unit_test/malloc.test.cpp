@@ -0,0 +1,127 @@
+// Copyright (c) 2025 - 2025 kio@little-bat.de
+// BSD-2-Clause license
+// https://opensource.org/licenses/BSD-2-Clause
+
+#include "Xoshiro128.h"
+#include "common/malloc.h"
+#include "doctest.h"
+#include <vector>
+
+/*
+	Tests for the allocator in common/malloc.cpp.
+	In desktop_tools it works in it's own static heap in namespace kio::HostHeap.
+*/
+
+namespace kio::Test
+{
+using namespace kio::HostHeap;
+
+struct HeapStats
+{
+	size_t total	= 0; // sum of all chunks incl. headers
+	size_t largest	= 0; // largest run of free and cached chunks, incl. headers
+	uint   invalid	= 0;
+	size_t free_run = 0;
+};
+
+static void add_chunk(void* data, uint32_t* /*addr*/, int sz, int free0_used1_invalid2)
+{
+	HeapStats& s = *reinterpret_cast<HeapStats*>(data);
+	if (free0_used1_invalid2 == 2) { s.invalid++; return; }
+
+	s.total += size_t(sz) + 4;
+	if (free0_used1_invalid2 == 0) s.free_run += size_t(sz) + 4;
+	else s.free_run = 0;
+	s.largest = std::max(s.largest, s.free_run);
+}
+
+static void check_consistency()
+{
+	// check_heap() and dump_heap_to_fu() must both see a valid heap,
+	// also while chunks are cached in the free lists:
+
+	CHECK_EQ(check_heap(), nullptr);
+
+	HeapStats s;
+	dump_heap_to_fu(add_chunk, &s);
+	CHECK_EQ(s.invalid, 0);
+	CHECK_EQ(s.total, heap_total_size());
+	CHECK_EQ(s.largest - 4, heap_largest_free_block());
+}
+
+TEST_CASE("malloc: check_heap() and dump_heap() with cached chunks")
+{
+	Xoshiro128		   rng(1234);
+	std::vector<void*> chunks;
+	free(malloc(100)); // the heap is initialized by the first malloc()
+	check_consistency();
+
+	// small chunks are cached on free():
+	for (uint i = 0; i < 200; i++) chunks.push_back(malloc(4 + rng.next() % 56));
+	void* big = malloc(1000);
+	for (uint i = 0; i < chunks.size(); i += 2) free(chunks[i]), chunks[i] = nullptr;
+	check_consistency();
+
+	// a cached chunk is reused:
+	void* p = malloc(24);
+	free(p);
+	CHECK_EQ(malloc(24), p);
+	free(p);
+	check_consistency();
+
+	// many chunks of the same size: only some are cached:
+	std::vector<void*> same;
+	for (uint i = 0; i < 50; i++) same.push_back(malloc(16));
+	for (void* q : same) free(q);
+	check_consistency();
+
+	// a large allocation which only succeeds if the cached chunks are released:
+	free(big);
+	size_t largest = heap_largest_free_block();
+	void*  all	   = malloc(largest);
+	CHECK_NE(all, nullptr);
+	CHECK_EQ(check_heap(), nullptr);
+	free(all);
+	check_consistency();
+
+	for (void* q : chunks) free(q);
+	check_consistency();
+	CHECK_EQ(heap_largest_free_block() + 4, heap_total_size());
+}
+
+} // namespace kio::Test
+
+
+/*
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+*/